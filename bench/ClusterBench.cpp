@@ -0,0 +1,78 @@
+// --- BENCHMARK KLASTRÓW ŚWIATEŁ ---
+// Uruchomienie: DuckyClusterBench [liczba_świateł] [powtórzenia]
+// Światła rozrzucone w hali 80 x 12 x 80 m wokół kamery (zasięgi 2-8 m), kamera 60 stopni, far 100 m.
+// Mierzy LightClusters::build() bez workerów i z workerami, a potem sprawdza poprawność tak, jak używa
+// jej shader: losowe punkty wewnątrz kul świateł i w ostrosłupie - klaster wyliczony z pozycji na ekranie
+// i głębokości musi mieć to światło na liście (o ile klaster nie przepełnił się).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "core/jobs/JobSystem.hpp"
+#include "core/math/MatrixTransform.hpp"
+#include "core/renderer/LightClusters.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double timeBuild(LightClusters& clusters, const std::vector<Vec3>& centers, const std::vector<float>& radii,
+                        const Mat4& view, const Mat4& proj, JobSystem* jobs, int repeats) {
+    clusters.build(centers.data(), radii.data(), centers.size(), view, proj, jobs); // pudełka klastrów poza pomiarem
+    auto start = Clock::now();
+    for (int i = 0; i < repeats; ++i) clusters.build(centers.data(), radii.data(), centers.size(), view, proj, jobs);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+}
+
+int main(int argc, char** argv) {
+    const int lightCount = argc > 1 ? std::atoi(argv[1]) : 1024;
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> px(-40.0f, 40.0f), py(0.0f, 12.0f), range(2.0f, 8.0f), unit(-1.0f, 1.0f);
+    std::vector<Vec3> centers;
+    std::vector<float> radii;
+    for (int i = 0; i < lightCount; ++i) { centers.push_back(Vec3(px(rng), py(rng), px(rng))); radii.push_back(range(rng)); }
+
+    const Mat4 view = MatrixTransform::lookAt(Vec3(0, 4, 30), Vec3(0, 2, 0), Vec3(0, 1, 0));
+    const Mat4 proj = MatrixTransform::perspective(60.0f, 1000.0f / 581.0f, 0.1f, 100.0f);
+
+    LightClusters clusters;
+    JobSystem parallel(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    double serialMs = timeBuild(clusters, centers, radii, view, proj, nullptr, repeats);
+    double parallelMs = timeBuild(clusters, centers, radii, view, proj, &parallel, repeats);
+    printf("%d lights: build %.3f ms (1 thread), %.3f ms (%u workers + main)\n", lightCount, serialMs, parallelMs, parallel.getWorkerCount());
+    printf("Clusters: %zu / %d occupied, %zu indices, max %zu per cluster, %zu dropped\n",
+           clusters.getOccupiedClusters(), LightClusters::CLUSTER_COUNT, clusters.getIndices().size(), clusters.getMaxPerCluster(), clusters.getOverflow());
+
+    // Poprawność: punkt w kuli światła -> jego klaster (jak w shaderze) musi zawierać światło
+    const float* v = view.data();
+    const float* p = proj.data();
+    const std::vector<uint32_t>& grid = clusters.getGrid();
+    const std::vector<uint16_t>& indices = clusters.getIndices();
+    size_t checked = 0, missing = 0;
+    for (int l = 0; l < lightCount; ++l)
+        for (int s = 0; s < 64; ++s) {
+            Vec3 d(unit(rng), unit(rng), unit(rng));
+            if (d.length() > 1.0f) continue;
+            Vec3 w = centers[l] + d * radii[l];
+            float x = v[0] * w.x + v[4] * w.y + v[8] * w.z + v[12], y = v[1] * w.x + v[5] * w.y + v[9] * w.z + v[13], z = v[2] * w.x + v[6] * w.y + v[10] * w.z + v[14];
+            float depth = -z;
+            if (depth <= 0.1f || depth >= 100.0f) continue;
+            float nx = p[0] * x / depth, ny = p[5] * y / depth;
+            if (std::fabs(nx) >= 1.0f || std::fabs(ny) >= 1.0f) continue;
+            int tx = std::min((int)((nx * 0.5f + 0.5f) * LightClusters::TILES_X), LightClusters::TILES_X - 1);
+            int ty = std::min((int)((ny * 0.5f + 0.5f) * LightClusters::TILES_Y), LightClusters::TILES_Y - 1);
+            int slice = (int)std::floor(std::log(depth) * clusters.getSliceScale() + clusters.getSliceBias());
+            slice = std::min(std::max(slice, 0), LightClusters::SLICES - 1);
+            int c = tx + LightClusters::TILES_X * (ty + LightClusters::TILES_Y * slice);
+            if (grid[c * 2 + 1] >= (uint32_t)LightClusters::MAX_PER_CLUSTER) continue;
+            checked++;
+            const uint16_t* begin = indices.data() + grid[c * 2];
+            if (std::find(begin, begin + grid[c * 2 + 1], (uint16_t)l) == begin + grid[c * 2 + 1]) missing++;
+        }
+    printf("Shader-side check: %zu points, %zu missing lights\n", checked, missing);
+    return missing ? 1 : 0;
+}
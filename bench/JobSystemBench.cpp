@@ -0,0 +1,79 @@
+// --- BENCHMARK SCHEDULERA ---
+// Uruchomienie: DuckyJobBench [liczba_workerów]
+// 1. Przepustowość małych zadań (koszt run/steal/finish na zadanie)
+// 2. parallelFor vs pętla szeregowa dla różnych grain
+// 3. Drzewo zależności (runAfter) - fan-out / fan-in
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "core/jobs/JobSystem.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Sztuczna praca ~ kilkadziesiąt ns na element
+static float work(size_t i) {
+    float x = (float)i * 0.001f;
+    for (int k = 0; k < 16; ++k) x = std::sqrt(x * x + 1.0f) - 0.5f;
+    return x;
+}
+
+int main(int argc, char** argv) {
+    unsigned int workerCount = argc > 1 ? (unsigned int)std::atoi(argv[1]) : 0;
+    JobSystem jobs(workerCount);
+    printf("Workers: %u (+ main thread)\n\n", jobs.getWorkerCount());
+
+    // 1. Małe zadania
+    {
+        const int jobCount = 200000;
+        std::vector<float> out(jobCount);
+        JobCounter counter;
+        auto start = Clock::now();
+        for (int i = 0; i < jobCount; ++i) jobs.run([&out, i]() { out[i] = work(i); }, &counter);
+        jobs.wait(counter);
+        double ms = msSince(start);
+        printf("[tiny jobs]   %d jobs: %.2f ms (%.0f ns/job), steals: %llu\n", jobCount, ms, ms * 1e6 / jobCount, (unsigned long long)jobs.getSteals());
+    }
+
+    // 2. parallelFor - wpływ grain
+    {
+        const size_t count = 4000000;
+        std::vector<float> out(count);
+        auto start = Clock::now();
+        for (size_t i = 0; i < count; ++i) out[i] = work(i);
+        double serialMs = msSince(start);
+        printf("\n[parallelFor] %zu items, serial: %.2f ms\n", count, serialMs);
+        for (size_t grain : {64, 256, 1024, 4096, 16384, 65536, 262144}) {
+            start = Clock::now();
+            jobs.parallelFor(count, grain, [&](size_t b, size_t e) { for (size_t i = b; i < e; ++i) out[i] = work(i); });
+            double ms = msSince(start);
+            printf("  grain %7zu: %8.2f ms  speedup x%.2f\n", grain, ms, serialMs / ms);
+        }
+    }
+
+    // 3. Zależności: 64 zadania -> 64 kontynuacje -> 1 zadanie końcowe, powtórzone wiele razy
+    {
+        const int rounds = 2000, width = 64;
+        std::vector<float> stageA(width), stageB(width);
+        float total = 0.0f;
+        auto start = Clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            JobCounter a, b, done;
+            for (int i = 0; i < width; ++i) jobs.run([&stageA, i]() { stageA[i] = work(i); }, &a);
+            for (int i = 0; i < width; ++i) jobs.runAfter(a, [&stageA, &stageB, i]() { stageB[i] = stageA[i] * 2.0f; }, &b);
+            jobs.runAfter(b, [&]() { for (float v : stageB) total += v; }, &done);
+            jobs.wait(done);
+        }
+        double ms = msSince(start);
+        printf("\n[dependencies] %d rounds x (%d -> %d -> 1): %.2f ms (%.1f us/round), checksum %.1f\n", rounds, width, width, ms, ms * 1000.0 / rounds, total);
+    }
+
+    jobs.sampleStats();
+    printf("\nJobs executed: %llu, steals: %llu\n", (unsigned long long)jobs.getJobsExecuted(), (unsigned long long)jobs.getSteals());
+    return 0;
+}
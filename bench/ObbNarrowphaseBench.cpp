@@ -0,0 +1,94 @@
+// --- BENCHMARK NARROWPHASE: AABB vs OBB (SAT) vs GJK/EPA ---
+// Uruchomienie: DuckyObbBench [liczba_par]
+// Te same losowe pary pudełek (blisko siebie, ~połowa nachodzi) testowane starym testem osi świata,
+// testem osi rozdzielających na 15 osiach i GJK/EPA (jak pary z otoczką modelu) - bez simpleksu
+// i z simpleksem z "poprzedniego kroku" (pudełko b przesunięte o 1 mm). Raportuje pary/ms i liczbę kolizji.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "core/physics/Gjk.hpp"
+#include "core/physics/Obb.hpp"
+#include "core/sceneobject/SceneObject.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    const size_t pairs = argc > 1 ? (size_t)std::atoll(argv[1]) : 1000000;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> offset(-1.5f, 1.5f), angle(-3.14159f, 3.14159f), size(0.4f, 1.6f);
+
+    // Pula 4096 pudełek, pary losowane z niej (dane mieszczą się w cache jak w prawdziwym broadphase)
+    const size_t poolSize = 4096;
+    std::vector<Obb> pool(poolSize);
+    std::vector<Vec3> aabbHalf(poolSize);
+    for (size_t i = 0; i < poolSize; ++i) {
+        Transform t;
+        t.position = Vec3(offset(rng), offset(rng), offset(rng));
+        t.rotation = Vec3(angle(rng), angle(rng), angle(rng));
+        t.scale = Vec3(size(rng), size(rng), size(rng));
+        pool[i] = Obb::fromMatrix(t.getModelMatrix().data(), Vec3(0.5f, 0.5f, 0.5f));
+        aabbHalf[i] = pool[i].aabbHalf();
+    }
+    std::vector<std::pair<int, int>> work(pairs);
+    for (auto& p : work) p = { (int)(rng() % poolSize), (int)(rng() % poolSize) };
+
+    printf("%zu pairs\n", pairs);
+    float sink = 0.0f;
+
+    auto start = Clock::now();
+    size_t aabbHits = 0;
+    for (const auto& p : work) {
+        SatResult r = aabbTest(pool[p.first].center, aabbHalf[p.first], pool[p.second].center, aabbHalf[p.second]);
+        aabbHits += r.separation < 0.0f;
+        sink += r.normal.x;
+    }
+    double aabbMs = msSince(start);
+
+    start = Clock::now();
+    size_t obbHits = 0;
+    for (const auto& p : work) {
+        SatResult r = satTest(pool[p.first], pool[p.second]);
+        obbHits += r.separation < 0.0f;
+        sink += r.normal.x;
+    }
+    double obbMs = msSince(start);
+
+    auto shape = [&](int i, const Vec3& offset) {
+        ConvexShape s;
+        s.frame = pool[i];
+        s.frame.center = s.frame.center + offset;
+        return s;
+    };
+    std::vector<GjkSimplex> simplices(pairs);
+    start = Clock::now();
+    size_t gjkHits = 0;
+    for (size_t i = 0; i < pairs; ++i) {
+        SatResult r = gjkEpa(shape(work[i].first, Vec3()), shape(work[i].second, Vec3()), simplices[i]);
+        gjkHits += r.separation < 0.0f;
+        sink += r.normal.x;
+    }
+    double gjkMs = msSince(start);
+
+    start = Clock::now();
+    size_t warmHits = 0;
+    for (size_t i = 0; i < pairs; ++i) {
+        SatResult r = gjkEpa(shape(work[i].first, Vec3()), shape(work[i].second, Vec3(0.001f, 0.0f, 0.0f)), simplices[i]);
+        warmHits += r.separation < 0.0f;
+        sink += r.normal.x;
+    }
+    double warmMs = msSince(start);
+
+    printf("  AABB (world axes): %8.2f ms, %9.0f pairs/ms, %zu hits\n", aabbMs, pairs / aabbMs, aabbHits);
+    printf("  OBB  (SAT, 15 axes): %6.2f ms, %9.0f pairs/ms, %zu hits\n", obbMs, pairs / obbMs, obbHits);
+    printf("  GJK/EPA (cold):     %8.2f ms, %9.0f pairs/ms, %zu hits\n", gjkMs, pairs / gjkMs, gjkHits);
+    printf("  GJK/EPA (warm):     %8.2f ms, %9.0f pairs/ms, %zu hits\n", warmMs, pairs / warmMs, warmHits);
+    printf("  AABB false positives: %zu (%.1f%% of AABB hits)\n", aabbHits - obbHits, aabbHits ? 100.0 * (aabbHits - obbHits) / aabbHits : 0.0);
+    printf("(%g)\n", sink);
+    return 0;
+}
@@ -0,0 +1,101 @@
+// --- ODTWARZANIE NAGRANIA SESJI PLAY (bez okna) ---
+// Uruchomienie: DuckyReplay <captures/play_N.json> [liczba_workerów]
+// Buduje scenę ze snapshotu nagrania, puszcza zapisane wejście przez playFrame() w trybie deterministycznym
+// i porównuje skrót stanu fizyki po każdej klatce z nagranym. Raportuje pierwszą rozbieżną klatkę
+// oraz czas spędzony w każdej fazie kroku - ten sam przebieg na dwóch buildach = porównywalne liczby.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include "core/camera/Camera.hpp"
+#include "core/ecs/SceneObjectAdapter.hpp"
+#include "core/ecs/World.hpp"
+#include "core/game/Gameplay.hpp"
+#include "core/jobs/JobSystem.hpp"
+#include "core/physics/PhysicsWorld.hpp"
+#include "core/physics/ProjectileSystem.hpp"
+#include "core/renderer/Renderer.hpp"
+#include "core/replay/InputCapture.hpp"
+#include "core/sceneobject/SceneSerializer.hpp"
+
+// Otoczki modeli jak w edytorze (bez VAO i tekstur - fizyka ich nie czyta)
+static std::vector<SceneObject> loadScene(const nlohmann::json& scene) {
+    std::unordered_map<std::string, std::shared_ptr<const ConvexHull>> hulls;
+    std::vector<SceneObject> objects;
+    for (const auto& e : scene) {
+        SceneObject o = parseSceneObject(e);
+        if (o.type == MeshType::Model && !o.modelPath.empty() && o.hasCollider) {
+            auto it = hulls.find(o.modelPath);
+            if (it == hulls.end()) {
+                std::vector<float> vertices;
+                std::shared_ptr<const ConvexHull> hull;
+                if (PrimitiveRenderer::decodeModel(o.modelPath, vertices)) hull = PrimitiveRenderer::buildHull(vertices);
+                it = hulls.emplace(o.modelPath, hull).first;
+            }
+            o.hull = it->second;
+        }
+        objects.push_back(std::move(o));
+    }
+    return objects;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { printf("Usage: DuckyReplay <capture.json> [workers]\n"); return 2; }
+    InputCapture capture;
+    if (!capture.load(argv[1])) { printf("Cannot read capture: %s\n", argv[1]); return 2; }
+    JobSystem jobs(argc > 2 ? (unsigned int)std::atoi(argv[2]) : 0);
+
+    World world;
+    writeScene(world, loadScene(capture.scene));
+    world.updateTransforms(jobs);
+    PhysicsWorld physics;
+    physics.deterministic = true;
+    physics.fixedStep = capture.fixedStep;
+    physics.lod = capture.lod;
+    ProjectileSystem projectiles;
+    Camera camera;
+
+    const size_t frames = capture.getFrameCount();
+    printf("%s: %zu frames, step %.4f s, %zu objects, workers %u (+ main thread), simulation LOD %s\n",
+           argv[1], frames, capture.fixedStep, capture.scene.size(), jobs.getWorkerCount(), capture.lod.enabled ? "on" : "off");
+
+    StepTimings sum;
+    double frameMs = 0.0, maxFrameMs = 0.0;
+    long firstMismatch = -1;
+    for (size_t f = 0; f < frames; ++f) {
+        auto start = std::chrono::steady_clock::now();
+        playFrame(world, physics, projectiles, jobs, camera, capture.input[f], capture.fixedStep);
+        world.updateTransforms(jobs);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        frameMs += ms;
+        if (ms > maxFrameMs) maxFrameMs = ms;
+
+        const StepTimings& t = physics.getStepTimings();
+        sum.gravity += t.gravity; sum.broadphase += t.broadphase; sum.narrowphase += t.narrowphase; sum.islands += t.islands; sum.solve += t.solve;
+        sum.integrate += t.integrate; sum.triggers += t.triggers; sum.sleep += t.sleep;
+        if (firstMismatch < 0 && physics.stateHash() != capture.stateHash[f]) firstMismatch = (long)f;
+    }
+
+    const double n = frames > 0 ? (double)frames : 1.0;
+    const double phaseTotal = sum.gravity + sum.broadphase + sum.narrowphase + sum.islands + sum.solve + sum.integrate + sum.triggers + sum.sleep;
+    auto row = [&](const char* name, double ms) {
+        printf("  %-12s %9.3f ms total  %7.4f ms/frame  %5.1f%%\n", name, ms, ms / n, phaseTotal > 0.0 ? ms * 100.0 / phaseTotal : 0.0);
+    };
+    printf("\nFrame: %.4f ms avg, %.4f ms max (playFrame + transforms)\n", frameMs / n, maxFrameMs);
+    printf("Physics step phases:\n");
+    row("gravity", sum.gravity);
+    row("broadphase", sum.broadphase);
+    row("narrowphase", sum.narrowphase);
+    row("islands", sum.islands);
+    row("solve", sum.solve);
+    row("integrate", sum.integrate);
+    row("triggers", sum.triggers);
+    row("sleep", sum.sleep);
+
+    if (firstMismatch >= 0) {
+        printf("\nDIVERGED at frame %ld of %zu\n", firstMismatch, frames);
+        return 1;
+    }
+    printf("\nBit-identical: %zu / %zu frames\n", frames, frames);
+    return 0;
+}
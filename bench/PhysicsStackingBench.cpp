@@ -0,0 +1,88 @@
+// --- BENCHMARK SOLVERA KONTAKTÓW ---
+// Uruchomienie: DuckyStackingBench [liczba_workerów] [iteracje_solvera]
+// Piramida ~5k skrzynek (jedna wyspa - solver szeregowo, paczki SSE) i 100 małych piramid (100 wysp - równolegle).
+// Raportuje czas solvera na krok i na iterację oraz osiadanie szczytu (stabilność stosu).
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "core/ecs/World.hpp"
+#include "core/physics/PhysicsWorld.hpp"
+
+static int nextId = 0;
+
+static void addBox(World& world, const Vec3& position, const Vec3& scale, bool dynamic) {
+    ComponentMask mask = componentMask<Transform, Collider>() | (dynamic ? componentMask<PhysicsBody>() : 0);
+    int id = nextId++;
+    world.create(id, mask);
+    Transform& t = *world.get<Transform>(id);
+    t.position = position;
+    t.scale = scale;
+    if (dynamic) world.get<PhysicsBody>(id)->useGravity = true;
+}
+
+// Warstwa l ma (base - l)^2 skrzynek, przesuniętych o pół skrzynki względem warstwy niżej. Zwraca id szczytu.
+static int addPyramid(World& world, const Vec3& origin, int base) {
+    const float size = 1.0f, gap = 0.01f;
+    for (int layer = 0; layer < base; ++layer) {
+        int side = base - layer;
+        float offset = layer * 0.5f * (size + gap);
+        for (int z = 0; z < side; ++z)
+            for (int x = 0; x < side; ++x)
+                addBox(world, Vec3(origin.x + offset + x * (size + gap), origin.y + 0.5f + layer * size, origin.z + offset + z * (size + gap)), Vec3(1, 1, 1), true);
+    }
+    return nextId - 1;
+}
+
+static void run(const char* label, World& world, JobSystem& jobs, int iterations, int top) {
+    PhysicsWorld physics;
+    physics.getSolver().iterations = iterations;
+    world.updateTransforms(jobs);
+    physics.sync(world);
+    const float startY = world.get<Transform>(top)->position.y;
+
+    // Średnie liczone z klatek, w których coś nie spało
+    const int frames = 300;
+    int active = 0;
+    double stepMs = 0.0, solveMs = 0.0, maxSolveMs = 0.0;
+    size_t contacts = 0, islands = 0;
+    int asleepAt = -1;
+    for (int f = 0; f < frames; ++f) {
+        physics.sync(world);
+        physics.step(1.0f / 60.0f, jobs);
+        physics.writeBack(world);
+        if (physics.getSolver().getIslandCount() == 0) continue;
+        active++;
+        stepMs += physics.getLastStepMs();
+        double s = physics.getSolver().getLastSolveMs();
+        solveMs += s;
+        if (s > maxSolveMs) maxSolveMs = s;
+        contacts += physics.getSolver().getContactCount();
+        islands += physics.getSolver().getIslandCount();
+        if (asleepAt < 0 && physics.getAwakeCount() == 0) asleepAt = f;
+    }
+    if (active == 0) active = 1;
+    printf("[%s] %zu bodies, %d iterations\n", label, physics.getBodyCount(), iterations);
+    printf("  step %.3f ms/frame, solver %.3f ms/frame (max %.3f), %.4f ms/iteration\n",
+           stepMs / active, solveMs / active, maxSolveMs, solveMs / active / iterations);
+    printf("  %zu contacts, %zu islands per frame (avg over %d active frames)\n", contacts / active, islands / active, active);
+    printf("  top sank %.4f m, all asleep after %d frames\n\n", startY - world.get<Transform>(top)->position.y, asleepAt);
+}
+
+int main(int argc, char** argv) {
+    unsigned int workerCount = argc > 1 ? (unsigned int)std::atoi(argv[1]) : 0;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 8;
+    JobSystem jobs(workerCount);
+    printf("Workers: %u (+ main thread)\n\n", jobs.getWorkerCount());
+
+    World world;
+    addBox(world, Vec3(0, -0.5f, 0), Vec3(400, 1, 400), false);
+    int top = addPyramid(world, Vec3(-12, 0, -12), 24);
+    run("pyramid 24 layers", world, jobs, iterations, top);
+
+    world.clear();
+    nextId = 0;
+    addBox(world, Vec3(0, -0.5f, 0), Vec3(400, 1, 400), false);
+    for (int i = 0; i < 100; ++i) top = addPyramid(world, Vec3((i % 10) * 8.0f - 40.0f, 0, (i / 10) * 8.0f - 40.0f), 5);
+    run("100 pyramids x 5 layers", world, jobs, iterations, top);
+    return 0;
+}
@@ -0,0 +1,279 @@
+// --- ZESTAW BENCHMARKÓW FIZYKI (regresje między wersjami silnika) ---
+// Uruchomienie: DuckyPhysicsBench [kroki] [liczba_workerów] [wynik.json]
+// Sceny kanoniczne budowane w kodzie, krok 1/60 s bez okna:
+//   falling_cubes_10k - 10k sześcianów spada na podłogę i tworzy stertę
+//   pyramid           - piramida skrzynek (jedna duża wyspa)
+//   resting_field     - gęste pole leżących skrzynek, budzone co sekundę (koszt spoczynku, nie snu)
+//   projectiles_1k    - 1k pocisków CCD przez rząd ścian + paczka 1k promieni na krok (strzały)
+//   scattered_piles   - 100 stert po 100 sześcianów na polu 360 x 360 m; wariant _lod z LOD symulacji
+//                       (kamera w środku patrzy w -Z, stałe odległości - bez kontrolera budżetu)
+//   projectile_pool_50k - pula ProjectileSystem dopełniana co krok do 50k pocisków przez te same ściany
+//                         (część leci nad nimi i wygasa albo spada na podłogę)
+// Wynik: JSON (stdout i opcjonalnie plik) z mean/p95/p99 kroku i średnimi faz (broadphase, narrowphase, ...).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include "core/ecs/World.hpp"
+#include "core/jobs/JobSystem.hpp"
+#include "core/json.hpp"
+#include "core/physics/PhysicsWorld.hpp"
+#include "core/physics/ProjectileSystem.hpp"
+
+using json = nlohmann::json;
+
+static int nextId = 0;
+
+static int addBox(World& world, const Vec3& position, const Vec3& scale, bool dynamic, const Vec3& velocity = Vec3(), bool continuous = false) {
+    ComponentMask mask = componentMask<Transform, Collider>() | (dynamic ? componentMask<PhysicsBody>() : 0);
+    int id = nextId++;
+    world.create(id, mask);
+    Transform& t = *world.get<Transform>(id);
+    t.position = position;
+    t.scale = scale;
+    if (dynamic) {
+        PhysicsBody& body = *world.get<PhysicsBody>(id);
+        body.useGravity = true;
+        body.velocity = velocity;
+        body.continuous = continuous;
+    }
+    return id;
+}
+
+static void addGround(World& world) { addBox(world, Vec3(0, -0.5f, 0), Vec3(400, 1, 400), false); }
+
+// Siatka 25 x 25 x 16 z przesunięciem warstw, żeby sześciany nie lądowały idealnie na sobie
+static void buildFallingCubes(World& world) {
+    addGround(world);
+    for (int y = 0; y < 16; ++y)
+        for (int z = 0; z < 25; ++z)
+            for (int x = 0; x < 25; ++x) {
+                float shift = (y % 2) * 0.4f;
+                addBox(world, Vec3(x * 1.6f - 20.0f + shift, 2.0f + y * 1.6f, z * 1.6f - 20.0f + shift), Vec3(1, 1, 1), true);
+            }
+}
+
+static void buildPyramid(World& world) {
+    addGround(world);
+    const int base = 20;
+    const float size = 1.0f, gap = 0.01f;
+    for (int layer = 0; layer < base; ++layer) {
+        int side = base - layer;
+        float offset = layer * 0.5f * (size + gap);
+        for (int z = 0; z < side; ++z)
+            for (int x = 0; x < side; ++x)
+                addBox(world, Vec3(offset + x * (size + gap) - 10.0f, 0.5f + layer * size, offset + z * (size + gap) - 10.0f), Vec3(1, 1, 1), true);
+    }
+}
+
+// Dwie warstwy 70 x 70 stykających się skrzynek
+static void buildRestingField(World& world) {
+    addGround(world);
+    for (int y = 0; y < 2; ++y)
+        for (int z = 0; z < 70; ++z)
+            for (int x = 0; x < 70; ++x)
+                addBox(world, Vec3(x * 1.02f - 35.0f, 0.5f + y * 1.0f, z * 1.02f - 35.0f), Vec3(1, 1, 1), true);
+}
+
+static void buildWalls(World& world) {
+    addGround(world);
+    for (int w = 0; w < 10; ++w) addBox(world, Vec3(0, 3.0f, -10.0f - w * 8.0f), Vec3(50, 6, 0.2f), false);
+}
+
+// 40 x 25 pocisków 0.2 m lecących 120 m/s w -Z przez 10 cienkich ścian (bez CCD przelatywałyby na wylot)
+static void buildProjectiles(World& world) {
+    buildWalls(world);
+    for (int y = 0; y < 25; ++y)
+        for (int x = 0; x < 40; ++x)
+            addBox(world, Vec3(x * 1.2f - 24.0f, 0.5f + y * 0.22f + (x % 3) * 0.05f, 10.0f), Vec3(0.2f, 0.2f, 0.2f), true, Vec3(0, 0, -120.0f), true);
+}
+
+// Siatka 10 x 10 stert 5 x 5 x 4 co 40 m
+static void buildScatteredPiles(World& world) {
+    addGround(world);
+    for (int pz = 0; pz < 10; ++pz)
+        for (int px = 0; px < 10; ++px)
+            for (int y = 0; y < 4; ++y)
+                for (int z = 0; z < 5; ++z)
+                    for (int x = 0; x < 5; ++x)
+                        addBox(world, Vec3(px * 40.0f - 180.0f + x * 1.2f, 1.0f + y * 1.5f, pz * 40.0f - 180.0f + z * 1.2f), Vec3(1, 1, 1), true);
+}
+
+struct SceneDef {
+    const char* name;
+    std::function<void(World&)> build;
+    int wakeEvery; // 0 = nie budzić
+    bool rays;
+    bool lod;
+    size_t pool; // docelowa liczba żywych pocisków w ProjectileSystem (0 = bez puli)
+};
+
+// Siatka 200 x 40 wylotów na z = 10, wysokość 1..13 m (ściany mają 6 m), lekki rozrzut na boki
+static void refillPool(ProjectileSystem& projectiles, size_t target, size_t& spawned) {
+    while (projectiles.getCount() < target) {
+        size_t k = spawned++;
+        float x = (float)(k % 200) * 0.25f - 25.0f, y = 1.0f + (float)((k / 200) % 40) * 0.3f;
+        float side = (float)((int)(k % 7) - 3) * 2.0f;
+        if (!projectiles.spawn(Vec3(x, y, 10.0f), Vec3(side, 0.0f, -120.0f), 2.0f)) break;
+    }
+}
+
+struct Stats {
+    std::vector<double> samples;
+    void add(double v) { samples.push_back(v); }
+    double mean() const { double s = 0.0; for (double v : samples) s += v; return samples.empty() ? 0.0 : s / samples.size(); }
+    double percentile(double p) const {
+        if (samples.empty()) return 0.0;
+        std::vector<double> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        size_t i = (size_t)std::ceil(p * sorted.size());
+        return sorted[std::min(sorted.size() - 1, i > 0 ? i - 1 : 0)];
+    }
+    json toJson() const {
+        return { {"mean", mean()}, {"p50", percentile(0.50)}, {"p95", percentile(0.95)}, {"p99", percentile(0.99)}, {"max", percentile(1.0)} };
+    }
+};
+
+static json runScene(const SceneDef& scene, int steps, JobSystem& jobs) {
+    World world;
+    nextId = 0;
+    scene.build(world);
+    world.updateTransforms(jobs);
+    PhysicsWorld physics;
+    physics.lod.enabled = scene.lod;
+    physics.lod.budgetMs = 0.0f;
+    LodViewer viewers[2];
+    viewers[0].position = Vec3(0, 8, 0);
+    viewers[0].forward = Vec3(0, 0, -1);
+    viewers[0].viewCos = 0.85f; // ~32 stopnie od osi (przekątna stożka 45 stopni przy 16:9)
+    viewers[0].viewDistance = 100.0f;
+    viewers[1].position = Vec3(0, 1, 0);
+    physics.sync(world);
+
+    const float dt = 1.0f / 60.0f;
+    Stats stepMs, frameMs, rayMs, poolMs;
+    StepTimings sum;
+    double candidates = 0.0, contacts = 0.0, awake = 0.0;
+    double tiers[SIM_TIERS] = {};
+    size_t sweepHits = 0, rayHits = 0, poolHits = 0, spawned = 0;
+    double poolLive = 0.0;
+    ProjectileSystem projectiles(scene.pool > 0 ? scene.pool : 1);
+    std::vector<Ray> rays;
+    std::vector<RayHit> hits;
+    std::vector<int> shooters;
+    if (scene.rays) world.each<PhysicsBody>([&](int id, PhysicsBody& body) { if (body.continuous) shooters.push_back(id); });
+
+    for (int s = 0; s < steps; ++s) {
+        if (scene.wakeEvery > 0 && s > 0 && s % scene.wakeEvery == 0) physics.wakeAll();
+        auto start = std::chrono::steady_clock::now();
+        physics.sync(world);
+        physics.updateLod(viewers, 2);
+        physics.step(dt, jobs);
+        physics.writeBack(world);
+        frameMs.add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        world.updateTransforms(jobs);
+
+        stepMs.add(physics.getLastStepMs());
+        const StepTimings& t = physics.getStepTimings();
+        sum.gravity += t.gravity; sum.broadphase += t.broadphase; sum.narrowphase += t.narrowphase; sum.islands += t.islands;
+        sum.solve += t.solve; sum.integrate += t.integrate; sum.triggers += t.triggers; sum.sleep += t.sleep;
+        candidates += physics.getCandidateCount();
+        contacts += physics.getPairCount();
+        awake += physics.getAwakeCount();
+        sweepHits += physics.getSweepHits();
+        for (int t = 0; t < SIM_TIERS; ++t) tiers[t] += physics.getTierCount(t);
+
+        // Strzał z każdego pocisku do przodu - ta sama ścieżka co raycast gracza, w paczkach po 4
+        if (!shooters.empty()) {
+            rays.clear();
+            for (int id : shooters) rays.push_back(Ray{ world.get<Transform>(id)->position, Vec3(0, 0, -1), 200.0f });
+            hits.resize(rays.size());
+            auto rayStart = std::chrono::steady_clock::now();
+            physics.raycast(rays.data(), hits.data(), rays.size(), RayFilter(), jobs);
+            rayMs.add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - rayStart).count());
+            for (const RayHit& h : hits) if (h.id != -1) rayHits++;
+        }
+
+        if (scene.pool > 0) {
+            refillPool(projectiles, scene.pool, spawned);
+            poolLive += projectiles.getCount();
+            projectiles.update(dt, physics, jobs);
+            poolMs.add(projectiles.getLastUpdateMs());
+            poolHits += projectiles.getHits().size();
+        }
+    }
+
+    const double n = steps > 0 ? steps : 1;
+    json r;
+    r["name"] = scene.name;
+    r["bodies"] = physics.getBodyCount();
+    r["steps"] = steps;
+    r["step_ms"] = stepMs.toJson();
+    r["frame_ms"] = frameMs.toJson(); // sync + step + writeBack
+    r["phases_ms"] = {
+        {"gravity", sum.gravity / n}, {"broadphase", sum.broadphase / n}, {"narrowphase", sum.narrowphase / n},
+        {"islands", sum.islands / n}, {"solve", sum.solve / n}, {"integrate", sum.integrate / n},
+        {"triggers", sum.triggers / n}, {"sleep", sum.sleep / n}
+    };
+    r["broadphase_pairs"] = candidates / n;
+    r["contacts"] = contacts / n;
+    r["awake"] = awake / n;
+    r["awake_at_end"] = physics.getAwakeCount();
+    r["ccd_hits"] = sweepHits;
+    if (scene.lod) r["lod_tiers"] = { {"full", tiers[Tier_Full] / n}, {"half", tiers[Tier_Half] / n}, {"quarter", tiers[Tier_Quarter] / n}, {"frozen", tiers[Tier_Frozen] / n} };
+    if (!shooters.empty()) {
+        r["rays_per_step"] = shooters.size();
+        r["ray_batch_ms"] = rayMs.toJson();
+        r["ray_hit_rate"] = (double)rayHits / (n * shooters.size());
+    }
+    if (scene.pool > 0) {
+        r["projectiles_live"] = poolLive / n; // przed update()
+        r["projectile_update_ms"] = poolMs.toJson();
+        r["projectile_hits_per_step"] = poolHits / n;
+    }
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? std::atoi(argv[1]) : 600;
+    unsigned int workerCount = argc > 2 ? (unsigned int)std::atoi(argv[2]) : 0;
+    const char* outPath = argc > 3 ? argv[3] : nullptr;
+    JobSystem jobs(workerCount);
+
+    const SceneDef scenes[] = {
+        { "falling_cubes_10k", buildFallingCubes, 0, false, false, 0 },
+        { "pyramid", buildPyramid, 0, false, false, 0 },
+        { "resting_field", buildRestingField, 60, false, false, 0 },
+        { "projectiles_1k", buildProjectiles, 0, true, false, 0 },
+        { "scattered_piles", buildScatteredPiles, 60, false, false, 0 },
+        { "scattered_piles_lod", buildScatteredPiles, 60, false, true, 0 },
+        { "projectile_pool_50k", buildWalls, 0, false, false, 50000 },
+    };
+
+    json out;
+    out["workers"] = jobs.getWorkerCount();
+    out["steps"] = steps;
+    out["dt"] = 1.0 / 60.0;
+#ifdef DUCKY_SSE
+    out["simd"] = "sse";
+#else
+    out["simd"] = "scalar";
+#endif
+    out["scenes"] = json::array();
+    for (const SceneDef& scene : scenes) {
+        fprintf(stderr, "%s...\n", scene.name);
+        out["scenes"].push_back(runScene(scene, steps, jobs));
+    }
+
+    const std::string text = out.dump(2);
+    printf("%s\n", text.c_str());
+    if (outPath) {
+        std::ofstream file(outPath);
+        file << text << "\n";
+        if (!file) { fprintf(stderr, "Cannot write %s\n", outPath); return 1; }
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+// --- BENCHMARK PICKINGU: drzewo sceny + BVH trójkątów ---
+// Uruchomienie: DuckyPickingBench [bok_siatki_obiektów] [bok_siatki_promieni]
+// Pole obiektów (na zmianę gęsta sfera ~6k trójkątów i sześcian, losowy obrót i skala) oglądane z góry pod kątem.
+// Mierzy budowę BVH siatki, sync() pickera (pełny i zwykły), promienie na ms przez ScenePicker,
+// a na próbce promieni porównuje wynik z testem wszystkich trójkątów wszystkich obiektów (brute force).
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "core/ecs/World.hpp"
+#include "core/jobs/JobSystem.hpp"
+#include "core/picking/ScenePicker.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Sfera o promieniu 0.5 jak prymityw edytora, sam układ pozycji (stride 3)
+static std::vector<float> buildSphere(int sectors, int stacks) {
+    std::vector<float> v;
+    auto point = [&](int i, int j) {
+        float stack = 3.14159265f / 2 - (float)i / stacks * 3.14159265f, sector = (float)j / sectors * 2 * 3.14159265f;
+        return Vec3(0.5f * std::cos(stack) * std::sin(sector), 0.5f * std::sin(stack), 0.5f * std::cos(stack) * std::cos(sector));
+    };
+    auto add = [&](const Vec3& p) { v.push_back(p.x); v.push_back(p.y); v.push_back(p.z); };
+    for (int i = 0; i < stacks; ++i)
+        for (int j = 0; j < sectors; ++j) {
+            Vec3 p1 = point(i, j), p2 = point(i + 1, j), p3 = point(i, j + 1), p4 = point(i + 1, j + 1);
+            if (i != 0) { add(p1); add(p2); add(p3); }
+            if (i != stacks - 1) { add(p3); add(p2); add(p4); }
+        }
+    return v;
+}
+
+static std::vector<float> buildCube() {
+    std::vector<float> v;
+    const float c[8][3] = { {-1,-1,-1}, {1,-1,-1}, {1,1,-1}, {-1,1,-1}, {-1,-1,1}, {1,-1,1}, {1,1,1}, {-1,1,1} };
+    const int tris[12][3] = { {0,1,2}, {0,2,3}, {4,6,5}, {4,7,6}, {0,3,7}, {0,7,4}, {1,5,6}, {1,6,2}, {0,4,5}, {0,5,1}, {3,2,6}, {3,6,7} };
+    for (const auto& t : tris) for (int k : t) for (int a = 0; a < 3; ++a) v.push_back(c[k][a] * 0.5f);
+    return v;
+}
+
+// Najbliższe trafienie promienia we wszystkie trójkąty (przestrzeń świata)
+static float bruteForce(const std::vector<float>& mesh, const Mat4& world, const Vec3& o, const Vec3& d, float best) {
+    const float* m = world.data();
+    auto xf = [&](size_t i) { const float* p = &mesh[i * 3]; return Vec3(m[0] * p[0] + m[4] * p[1] + m[8] * p[2] + m[12], m[1] * p[0] + m[5] * p[1] + m[9] * p[2] + m[13], m[2] * p[0] + m[6] * p[1] + m[10] * p[2] + m[14]); };
+    for (size_t t = 0; t + 2 < mesh.size() / 3; t += 3) {
+        Vec3 a = xf(t), e1 = xf(t + 1) - a, e2 = xf(t + 2) - a;
+        Vec3 p = d.cross(e2);
+        float det = e1.dot(p);
+        if (std::fabs(det) < 1e-20f) continue;
+        float inv = 1.0f / det;
+        Vec3 s = o - a;
+        float u = s.dot(p) * inv;
+        Vec3 q = s.cross(e1);
+        float v = d.dot(q) * inv, dist = e2.dot(q) * inv;
+        if (u < 0 || v < 0 || u + v > 1 || dist < 0 || dist >= best) continue;
+        best = dist;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    const int side = argc > 1 ? std::atoi(argv[1]) : 32;
+    const int raySide = argc > 2 ? std::atoi(argv[2]) : 256;
+    JobSystem jobs(0);
+
+    std::vector<float> sphere = buildSphere(64, 48), cube = buildCube();
+    auto start = Clock::now();
+    auto sphereBvh = std::make_shared<MeshBvh>();
+    buildMeshBvh(sphere.data(), sphere.size() / 3, 3, *sphereBvh);
+    double buildMs = msSince(start);
+    auto cubeBvh = std::make_shared<MeshBvh>();
+    buildMeshBvh(cube.data(), cube.size() / 3, 3, *cubeBvh);
+    printf("Sphere mesh: %zu triangles, BVH %zu nodes / %zu packets, build %.2f ms\n",
+           sphereBvh->triangleCount, sphereBvh->nodes.size(), sphereBvh->packets.size(), buildMs);
+
+    World world;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f), size(0.6f, 1.8f);
+    for (int z = 0; z < side; ++z)
+        for (int x = 0; x < side; ++x) {
+            int id = z * side + x;
+            world.create(id, componentMask<Transform, MeshRenderer>());
+            Transform& t = *world.get<Transform>(id);
+            t.position = Vec3((x - side * 0.5f) * 2.0f, 0.0f, (z - side * 0.5f) * 2.0f);
+            t.rotation = Vec3(angle(rng), angle(rng), angle(rng));
+            t.scale = Vec3(size(rng), size(rng), size(rng));
+            MeshRenderer& mesh = *world.get<MeshRenderer>(id);
+            mesh.type = MeshType::Model;
+            mesh.bvh = (id % 2) ? cubeBvh : sphereBvh;
+        }
+    world.updateTransforms(jobs);
+
+    ScenePicker picker;
+    start = Clock::now();
+    picker.sync(world);
+    double fullSyncMs = msSince(start);
+    start = Clock::now();
+    picker.sync(world);
+    double syncMs = msSince(start);
+    printf("%d objects: sync %.3f ms (rebuild), %.3f ms (per frame)\n", side * side, fullSyncMs, syncMs);
+
+    // Kamera nad polem, patrzy w dół pod kątem ~40 stopni; promienie z siatki na ekranie 60 x 35 stopni
+    const Vec3 eye(0.0f, side * 1.2f, side * 1.6f);
+    const Vec3 forward = (Vec3(0, 0, 0) - eye).normalize(), right = forward.cross(Vec3(0, 1, 0)).normalize(), up = right.cross(forward);
+    std::vector<Vec3> dirs;
+    for (int y = 0; y < raySide; ++y)
+        for (int x = 0; x < raySide; ++x) {
+            float nx = (x + 0.5f) / raySide * 2.0f - 1.0f, ny = (y + 0.5f) / raySide * 2.0f - 1.0f;
+            dirs.push_back((forward + right * (nx * 0.58f) + up * (ny * 0.32f)).normalize());
+        }
+
+    std::vector<PickHit> hits(dirs.size());
+    size_t meshTests = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < dirs.size(); ++i) { hits[i] = picker.pick(eye, dirs[i]); meshTests += picker.getLastMeshTests(); }
+    double pickMs = msSince(start);
+    size_t hitCount = 0;
+    for (const PickHit& h : hits) hitCount += h.id != -1;
+    printf("%zu rays: %.2f ms, %.1f rays/ms, %.4f ms/ray, %.1f%% hit, %.2f mesh tests/ray\n",
+           dirs.size(), pickMs, dirs.size() / pickMs, pickMs / dirs.size(), 100.0 * hitCount / dirs.size(), (double)meshTests / dirs.size());
+
+    // Próbka co n-ty promień przeciw wszystkim trójkątom
+    const size_t sample = 48, stride = dirs.size() / sample > 0 ? dirs.size() / sample : 1;
+    size_t checked = 0, mismatches = 0;
+    double bruteMs = 0.0;
+    for (size_t i = 0; i < dirs.size() && checked < sample; i += stride, ++checked) {
+        start = Clock::now();
+        float best = 1000.0f;
+        for (int id = 0; id < side * side; ++id)
+            best = bruteForce((id % 2) ? cube : sphere, world.getWorldMatrix(id), eye, dirs[i], best);
+        bruteMs += msSince(start);
+        bool bruteHit = best < 1000.0f;
+        if (bruteHit != (hits[i].id != -1) || (bruteHit && std::fabs(best - hits[i].distance) > 1e-3f * best)) mismatches++;
+    }
+    printf("Brute force check: %zu rays, %zu mismatches, %.2f ms/ray (%.0fx slower)\n",
+           checked, mismatches, bruteMs / checked, (bruteMs / checked) / (pickMs / dirs.size()));
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+// --- BENCHMARK HIERARCHII TRANSFORMÓW ---
+// Uruchomienie: DuckyHierarchyBench [liczba_workerów]
+// 100k węzłów w trzech kształtach drzewa. Dla każdego: pełne przeliczenie (po przebudowie tablic DFS)
+// i klatki z 1% / 10% brudnych węzłów - koszt powinien rosnąć z liczbą zmienionych poddrzew, nie z rozmiarem sceny.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "core/ecs/World.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// parentOf(i) zwraca rodzica węzła i (< i) albo -1
+template<typename F>
+static void buildScene(World& world, int count, F&& parentOf) {
+    world.clear();
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    for (int i = 0; i < count; ++i) {
+        world.create(i, componentMask<Transform, Tag>());
+        Transform& t = *world.get<Transform>(i);
+        t.position = Vec3(u(rng), u(rng), u(rng));
+        t.rotation = Vec3(u(rng), u(rng), u(rng));
+    }
+    for (int i = 0; i < count; ++i) world.setParent(i, parentOf(i));
+}
+
+static void run(const char* label, World& world, JobSystem& jobs, int count) {
+    auto start = Clock::now();
+    world.updateTransforms(jobs);
+    double fullMs = msSince(start);
+    printf("[%s] %d nodes, rebuild + full update: %.2f ms\n", label, count, fullMs);
+
+    std::mt19937 rng(3);
+    for (double fraction : {0.001, 0.01, 0.1}) {
+        const int frames = 50;
+        int dirty = (int)(count * fraction);
+        double totalMs = 0.0;
+        size_t updated = 0;
+        for (int f = 0; f < frames; ++f) {
+            for (int k = 0; k < dirty; ++k) {
+                int id = (int)(rng() % (unsigned)count);
+                world.get<Transform>(id)->position.y += 0.01f;
+                world.touch(id);
+            }
+            start = Clock::now();
+            world.updateTransforms(jobs);
+            totalMs += msSince(start);
+            updated += world.getHierarchy().getLastUpdatedCount();
+        }
+        printf("  %5.1f%% dirty: %7.3f ms/frame, %8zu nodes recomputed/frame\n", fraction * 100.0, totalMs / frames, updated / frames);
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned int workerCount = argc > 1 ? (unsigned int)std::atoi(argv[1]) : 0;
+    JobSystem jobs(workerCount);
+    printf("Workers: %u (+ main thread)\n\n", jobs.getWorkerCount());
+
+    const int count = 100000;
+    World world;
+
+    // Rekwizyty: 1000 korzeni po 100 węzłów (korzeń -> 9 części -> po 10 detali)
+    buildScene(world, count, [](int i) { int local = i % 100; if (local == 0) return -1; return local <= 9 ? i - local : i - local + 1 + (local - 10) / 10; });
+    run("props 1000 x 100", world, jobs, count);
+
+    // Płaska scena: same korzenie
+    buildScene(world, count, [](int) { return -1; });
+    run("flat", world, jobs, count);
+
+    // Jedno duże drzewo (losowy rodzic z wcześniejszych węzłów)
+    std::mt19937 rng(11);
+    buildScene(world, count, [&](int i) { return i == 0 ? -1 : (int)(rng() % (unsigned)i); });
+    run("single random tree", world, jobs, count);
+    return 0;
+}
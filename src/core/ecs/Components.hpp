@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "../math/Vec3.hpp"
+#include "../sceneobject/SceneObject.hpp"
+
+// --- KOMPONENTY ECS ---
+// Gorące dane (Transform, PhysicsBody) są oddzielone od zimnych (nazwy, ścieżki plików).
+// Każdy komponent ma własną tablicę w chunku, więc pętla po transformach nie dotyka stringów.
+// Transform, Material i Light to te same struktury co w SceneObject.
+
+struct PhysicsBody {
+    Vec3 velocity;
+    bool useGravity = false;
+    bool canShoot = false;
+    bool lockX = false, lockY = false, lockZ = false;
+    bool continuous = false; // CCD dla szybkich ciał
+    PhysicsBody() : velocity(0,0,0) {}
+};
+
+struct MeshRenderer {
+    MeshType type = MeshType::Cube;
+    unsigned int vao = 0;
+    int vertexCount = 0;
+    unsigned int textureId = 0;
+    std::string modelPath;
+    std::string texturePath;
+    std::shared_ptr<const ConvexHull> hull; // collider modelu (wspólny dla instancji), nullptr = pudełko
+    std::shared_ptr<const MeshBvh> bvh;     // trójkąty modelu do pickingu (wspólne dla instancji)
+};
+
+// Prostopadłościan w przestrzeni lokalnej (skalowany przez Transform::scale)
+struct Collider {
+    Vec3 halfExtents;
+    bool trigger = false; // strefa: bez zderzeń i raycastów, tylko zdarzenia wejścia/wyjścia
+    Collider() : halfExtents(0.5f, 0.5f, 0.5f) {}
+};
+
+// Nazwa jest internowana (NameTable w World), flagi to TagFlags - pętle nie porównują stringów
+struct Tag {
+    uint32_t name = 0;
+    uint32_t flags = Tag_None;
+};
+
+// Rola gracza - dodawana/zdejmowana razem z flagą Tag_Player
+struct PlayerController {
+    float moveSpeed = 5.0f;
+    float jumpSpeed = 5.0f;
+};
+
+// Numery bitów w masce archetypu
+using ComponentMask = uint32_t;
+constexpr int COMPONENT_COUNT = 8;
+
+template<typename T> struct ComponentIndex;
+template<> struct ComponentIndex<Transform>    { static constexpr int value = 0; };
+template<> struct ComponentIndex<PhysicsBody>  { static constexpr int value = 1; };
+template<> struct ComponentIndex<MeshRenderer> { static constexpr int value = 2; };
+template<> struct ComponentIndex<Material>     { static constexpr int value = 3; };
+template<> struct ComponentIndex<Collider>     { static constexpr int value = 4; };
+template<> struct ComponentIndex<Tag>          { static constexpr int value = 5; };
+template<> struct ComponentIndex<Light>        { static constexpr int value = 6; };
+template<> struct ComponentIndex<PlayerController> { static constexpr int value = 7; };
+
+template<typename... Ts>
+constexpr ComponentMask componentMask() { return (0u | ... | (1u << ComponentIndex<Ts>::value)); }
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+// --- UCHWYT ENCJI (SLOT + GENERACJA) ---
+// index = numer slotu w World = trwałe id obiektu w scenie (SceneObject::id).
+// Generacja rośnie przy każdym usunięciu, więc stary uchwyt do zwolnionego/ponownie
+// użytego slotu przestaje być ważny zamiast wskazywać na inny obiekt.
+struct Entity {
+    static constexpr uint32_t NULL_INDEX = 0xFFFFFFFFu;
+
+    uint32_t index = NULL_INDEX;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == NULL_INDEX; }
+    int id() const { return isNull() ? -1 : (int)index; }
+
+    bool operator==(const Entity& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const Entity& o) const { return !(*this == o); }
+};
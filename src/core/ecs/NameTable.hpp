@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+// --- INTERNOWANE NAZWY ---
+// Każdy unikalny string dostaje stały numer; komponenty trzymają tylko numer.
+// Porównanie nazw = porównanie liczb. Tylko wątek główny (edytor).
+class NameTable {
+public:
+    NameTable() { intern(""); }
+
+    uint32_t intern(const std::string& s) {
+        auto it = lookup.find(s);
+        if (it != lookup.end()) return it->second;
+        uint32_t id = (uint32_t)strings.size();
+        strings.push_back(s);
+        lookup.emplace(strings.back(), id);
+        return id;
+    }
+    const std::string& str(uint32_t id) const { return id < strings.size() ? strings[id] : strings[0]; }
+    size_t size() const { return strings.size(); }
+
+private:
+    std::deque<std::string> strings; // deque: referencje zwrócone przez str() nie unieważniają się
+    std::unordered_map<std::string, uint32_t> lookup;
+};
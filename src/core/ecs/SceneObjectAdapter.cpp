@@ -0,0 +1,115 @@
+#include "SceneObjectAdapter.hpp"
+#include <unordered_map>
+
+ComponentMask componentMaskFor(const SceneObject& o) {
+    ComponentMask mask = componentMask<Transform, MeshRenderer, Material, Tag>();
+    bool moving = o.velocity.x != 0.0f || o.velocity.y != 0.0f || o.velocity.z != 0.0f;
+    if (o.useGravity || o.canShoot || o.lockX || o.lockY || o.lockZ || o.continuous || moving) mask |= componentMask<PhysicsBody>();
+    if (o.hasCollider) mask |= componentMask<Collider>();
+    if (o.light.type != LightType::None) mask |= componentMask<Light>();
+    if (o.tags & Tag_Player) mask |= componentMask<PlayerController>();
+    return mask;
+}
+
+void writeSceneObject(World& world, const SceneObject& o) {
+    ComponentMask mask = componentMaskFor(o);
+    // Raz dodane PhysicsBody zostaje (np. po wyzerowaniu prędkości w trakcie gry)
+    if (world.contains(o.id)) world.setMask(o.id, mask | (world.getMask(o.id) & componentMask<PhysicsBody>()));
+    else if (world.create(o.id, mask).isNull()) return;
+
+    *world.get<Transform>(o.id) = o.transform;
+    world.touch(o.id);
+    // Rodzic jeszcze nie istnieje (np. writeScene w trakcie) -> korzeń, writeScene podepnie go na końcu
+    if (!world.setParent(o.id, o.parent)) world.setParent(o.id, -1);
+    *world.get<Material>(o.id) = o.material;
+    Tag& tag = *world.get<Tag>(o.id);
+    tag.name = world.intern(o.name);
+    tag.flags = o.tags;
+    if (Light* light = world.get<Light>(o.id)) *light = o.light;
+
+    MeshRenderer& mesh = *world.get<MeshRenderer>(o.id);
+    mesh.type = o.type;
+    mesh.vao = o.vao;
+    mesh.vertexCount = o.vertexCount;
+    mesh.textureId = o.textureId;
+    mesh.modelPath = o.modelPath;
+    mesh.texturePath = o.texturePath;
+    mesh.hull = o.hull;
+    mesh.bvh = o.bvh;
+    if (Collider* collider = world.get<Collider>(o.id)) collider->trigger = o.isTrigger;
+
+    if (PhysicsBody* body = world.get<PhysicsBody>(o.id)) {
+        body->velocity = o.velocity;
+        body->useGravity = o.useGravity;
+        body->canShoot = o.canShoot;
+        body->lockX = o.lockX; body->lockY = o.lockY; body->lockZ = o.lockZ;
+        body->continuous = o.continuous;
+    }
+}
+
+SceneObject readSceneObject(const World& world, int id) {
+    SceneObject o;
+    o.id = id;
+    if (const Transform* t = world.get<Transform>(id)) o.transform = *t;
+    if (const Material* m = world.get<Material>(id)) o.material = *m;
+    if (const Tag* tag = world.get<Tag>(id)) { o.name = world.nameOf(tag->name); o.tags = tag->flags; }
+    if (const Light* light = world.get<Light>(id)) o.light = *light;
+    if (const MeshRenderer* mesh = world.get<MeshRenderer>(id)) {
+        o.type = mesh->type;
+        o.vao = mesh->vao;
+        o.vertexCount = mesh->vertexCount;
+        o.textureId = mesh->textureId;
+        o.modelPath = mesh->modelPath;
+        o.texturePath = mesh->texturePath;
+        o.hull = mesh->hull;
+        o.bvh = mesh->bvh;
+    }
+    if (const PhysicsBody* body = world.get<PhysicsBody>(id)) {
+        o.velocity = body->velocity;
+        o.useGravity = body->useGravity;
+        o.canShoot = body->canShoot;
+        o.lockX = body->lockX; o.lockY = body->lockY; o.lockZ = body->lockZ;
+        o.continuous = body->continuous;
+    }
+    o.hasCollider = world.has<Collider>(id);
+    if (const Collider* collider = world.get<Collider>(id)) o.isTrigger = collider->trigger;
+    o.parent = world.getParent(id);
+    return o;
+}
+
+void writeScene(World& world, const std::vector<SceneObject>& objects) {
+    world.clear();
+    // Id z pliku zostają (także rzadkie po usunięciach). Nowe id dostają tylko duplikaty i id odrzucone przez
+    // World::create (ujemne, dalej niż MAX_ID_GAP) - dopiero po wstawieniu reszty, żeby allocateId nie zajął id,
+    // którego plik jeszcze używa. Wołający zapisuje do dziennika readScene(world), nie wektor z pliku.
+    std::vector<int> ids(objects.size(), -1);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const SceneObject& o = objects[i];
+        if (world.contains(o.id)) continue; // duplikat
+        writeSceneObject(world, o);
+        if (world.contains(o.id)) ids[i] = o.id;
+    }
+    std::unordered_map<int, int> remapped; // odrzucone id -> nowe (dzieci idą za rodzicem)
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (ids[i] != -1) continue;
+        SceneObject o = objects[i];
+        o.id = world.allocateId();
+        if (!world.contains(objects[i].id)) remapped.emplace(objects[i].id, o.id); // nie duplikat = odrzucone
+        writeSceneObject(world, o);
+        ids[i] = o.id;
+    }
+    for (size_t i = 0; i < objects.size(); ++i) {
+        int parent = objects[i].parent;
+        if (parent == -1) continue;
+        auto it = remapped.find(parent);
+        world.setParent(ids[i], it != remapped.end() ? it->second : parent);
+    }
+}
+
+std::vector<SceneObject> readScene(const World& world) {
+    std::vector<SceneObject> objects;
+    const std::vector<int>& order = world.getOrder();
+    objects.reserve(order.size());
+    for (int id : order) objects.push_back(readSceneObject(world, id));
+    return objects;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <vector>
+#include "World.hpp"
+#include "../sceneobject/SceneObject.hpp"
+
+// --- ADAPTER SceneObject <-> ECS ---
+// Inspektor, Undo/Redo, dziennik autosave i serializery nadal pracują na SceneObject.
+// Adapter rozkłada obiekt na komponenty i składa go z powrotem bez strat.
+// PhysicsBody dostają tylko obiekty z niedomyślną fizyką, Collider tylko te z hasCollider,
+// Light tylko światła, PlayerController tylko obiekty z flagą Tag_Player.
+
+ComponentMask componentMaskFor(const SceneObject& o);
+
+// Upsert: tworzy encję albo nadpisuje istniejącą (przenosząc ją do innego archetypu, jeśli trzeba)
+void writeSceneObject(World& world, const SceneObject& o);
+SceneObject readSceneObject(const World& world, int id);
+
+// Cała scena (w kolejności obiektów z wektora; rodzice podpinani po wstawieniu wszystkich obiektów)
+void writeScene(World& world, const std::vector<SceneObject>& objects);
+std::vector<SceneObject> readScene(const World& world);
@@ -0,0 +1,225 @@
+#include "TransformHierarchy.hpp"
+#include <algorithm>
+#include <cmath>
+#include "World.hpp"
+#include "../jobs/JobSystem.hpp"
+#include "../math/Simd.hpp"
+
+// Poddrzewo większe niż SPLIT_NODES jest rozbijane na poddrzewa dzieci (korzeń liczony od razu),
+// a małe zakresy są sklejane w paczki po ~BATCH_NODES węzłów na zadanie.
+static const int SPLIT_NODES = 2048;
+static const int BATCH_NODES = 1024;
+
+// ==========================================
+// POWIĄZANIA (per id)
+// ==========================================
+void TransformHierarchy::onCreate(int id) {
+    if ((size_t)id >= links.size()) links.resize((size_t)id + 1);
+    links[id] = Links();
+    links[id].alive = true;
+    structureDirty = true;
+}
+
+void TransformHierarchy::onDestroy(int id) {
+    if (!valid(id)) return;
+    unlink(id);
+    for (int c = links[id].firstChild; c != -1;) {
+        int next = links[c].nextSibling;
+        links[c].parent = links[c].prevSibling = links[c].nextSibling = -1;
+        c = next;
+    }
+    links[id] = Links();
+    structureDirty = true;
+}
+
+void TransformHierarchy::clear() {
+    links.clear();
+    nodeIds.clear(); nodeParent.clear(); subtreeEnd.clear();
+    localMatrices.clear(); worldMatrices.clear(); localDirty.clear();
+    nodeOf.clear();
+    dirtyNodes.clear();
+    structureDirty = true;
+}
+
+void TransformHierarchy::link(int id, int parentId) {
+    Links& l = links[id];
+    l.parent = parentId;
+    if (parentId < 0) return;
+    Links& p = links[parentId];
+    l.prevSibling = p.lastChild;
+    if (p.lastChild != -1) links[p.lastChild].nextSibling = id;
+    else p.firstChild = id;
+    p.lastChild = id;
+}
+
+void TransformHierarchy::unlink(int id) {
+    Links& l = links[id];
+    if (l.parent >= 0) {
+        Links& p = links[l.parent];
+        if (l.prevSibling != -1) links[l.prevSibling].nextSibling = l.nextSibling; else p.firstChild = l.nextSibling;
+        if (l.nextSibling != -1) links[l.nextSibling].prevSibling = l.prevSibling; else p.lastChild = l.prevSibling;
+    }
+    l.parent = l.prevSibling = l.nextSibling = -1;
+}
+
+bool TransformHierarchy::isAncestor(int ancestor, int id) const {
+    for (int p = getParent(id); p != -1; p = links[p].parent) if (p == ancestor) return true;
+    return false;
+}
+
+bool TransformHierarchy::setParent(int id, int parentId) {
+    if (!valid(id)) return false;
+    if (parentId != -1 && (!valid(parentId) || parentId == id || isAncestor(id, parentId))) return false;
+    if (links[id].parent == parentId) return true;
+    unlink(id);
+    link(id, parentId);
+    structureDirty = true;
+    return true;
+}
+
+void TransformHierarchy::collectSubtree(int id, std::vector<int>& out) const {
+    if (!valid(id)) return;
+    std::vector<int> stack(1, id);
+    while (!stack.empty()) {
+        int cur = stack.back(); stack.pop_back();
+        out.push_back(cur);
+        for (int c = links[cur].lastChild; c != -1; c = links[c].prevSibling) stack.push_back(c);
+    }
+}
+
+// ==========================================
+// TABLICE DFS
+// ==========================================
+void TransformHierarchy::rebuild(const World& world) {
+    nodeIds.clear(); nodeParent.clear();
+    nodeOf.assign(links.size(), -1);
+    std::vector<int> stack;
+    // Korzenie w kolejności dodania (jak w panelu Hierarchy), dzieci w kolejności na liście rodzeństwa
+    for (int root : world.getOrder()) {
+        if (!valid(root) || links[root].parent != -1) continue;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int id = stack.back(); stack.pop_back();
+            nodeOf[id] = (int)nodeIds.size();
+            nodeIds.push_back(id);
+            nodeParent.push_back(links[id].parent >= 0 ? nodeOf[links[id].parent] : -1);
+            for (int c = links[id].lastChild; c != -1; c = links[c].prevSibling) stack.push_back(c);
+        }
+    }
+
+    size_t n = nodeIds.size();
+    subtreeEnd.resize(n);
+    for (size_t i = 0; i < n; ++i) subtreeEnd[i] = (int)i + 1;
+    for (size_t i = n; i-- > 0;) if (nodeParent[i] >= 0) subtreeEnd[nodeParent[i]] = std::max(subtreeEnd[nodeParent[i]], subtreeEnd[i]);
+
+    localMatrices.resize(n);
+    worldMatrices.resize(n);
+    localDirty.assign(n, 1);
+    dirtyNodes.clear();
+    for (size_t i = 0; i < n; ++i) if (nodeParent[i] < 0) dirtyNodes.push_back((int)i);
+    structureDirty = false;
+}
+
+void TransformHierarchy::markDirty(int id) {
+    if (structureDirty || id < 0 || (size_t)id >= nodeOf.size()) return;
+    int node = nodeOf[id];
+    if (node < 0 || localDirty[node]) return;
+    localDirty[node] = 1;
+    dirtyNodes.push_back(node);
+}
+
+const Mat4& TransformHierarchy::getWorldMatrix(int id) const {
+    static const Mat4 identity;
+    if (id < 0 || (size_t)id >= nodeOf.size() || nodeOf[id] < 0 || (size_t)nodeOf[id] >= worldMatrices.size()) return identity;
+    return worldMatrices[nodeOf[id]];
+}
+
+// ==========================================
+// PRZELICZANIE MACIERZY
+// ==========================================
+Mat4 TransformHierarchy::composeLocal(const Transform& t) {
+    float cx = std::cos(t.rotation.x), sx = std::sin(t.rotation.x);
+    float cy = std::cos(t.rotation.y), sy = std::sin(t.rotation.y);
+    float cz = std::cos(t.rotation.z), sz = std::sin(t.rotation.z);
+    Mat4 m;
+    m.m[0] = cz * cy * t.scale.x;                  m.m[1] = sz * cy * t.scale.x;                  m.m[2] = -sy * t.scale.x;
+    m.m[4] = (cz * sy * sx - sz * cx) * t.scale.y; m.m[5] = (sz * sy * sx + cz * cx) * t.scale.y; m.m[6] = cy * sx * t.scale.y;
+    m.m[8] = (cz * sy * cx + sz * sx) * t.scale.z; m.m[9] = (sz * sy * cx - cz * sx) * t.scale.z; m.m[10] = cy * cx * t.scale.z;
+    m.m[12] = t.position.x; m.m[13] = t.position.y; m.m[14] = t.position.z;
+    return m;
+}
+
+void TransformHierarchy::multiplyAffine(const Mat4& parent, const Mat4& local, Mat4& out) {
+    const float* p = parent.m;
+    const float* l = local.m;
+#ifdef DUCKY_SSE
+    // Kolumna wyniku = kombinacja kolumn rodzica (4 wiersze naraz)
+    __m128 c0 = _mm_loadu_ps(p), c1 = _mm_loadu_ps(p + 4), c2 = _mm_loadu_ps(p + 8), c3 = _mm_loadu_ps(p + 12);
+    for (int c = 0; c < 4; ++c) {
+        const float* lc = l + c * 4;
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(lc[0])), _mm_mul_ps(c1, _mm_set1_ps(lc[1]))), _mm_mul_ps(c2, _mm_set1_ps(lc[2])));
+        if (c == 3) r = _mm_add_ps(r, c3);
+        _mm_storeu_ps(out.m + c * 4, r);
+    }
+#else
+    for (int c = 0; c < 4; ++c) {
+        const float* lc = l + c * 4;
+        for (int r = 0; r < 4; ++r) out.m[c * 4 + r] = p[r] * lc[0] + p[4 + r] * lc[1] + p[8 + r] * lc[2] + (c == 3 ? p[12 + r] : 0.0f);
+    }
+#endif
+}
+
+// Rodzic węzła jest zawsze policzony wcześniej (kolejność DFS albo kręgosłup liczony przed zadaniami)
+void TransformHierarchy::computeNode(const World& world, int node) {
+    if (localDirty[node]) {
+        const Transform* t = world.get<Transform>(nodeIds[node]);
+        localMatrices[node] = t ? composeLocal(*t) : Mat4();
+        localDirty[node] = 0;
+    }
+    int p = nodeParent[node];
+    if (p < 0) worldMatrices[node] = localMatrices[node];
+    else multiplyAffine(worldMatrices[p], localMatrices[node], worldMatrices[node]);
+}
+
+void TransformHierarchy::update(const World& world, JobSystem& jobs) {
+    if (structureDirty) rebuild(world);
+    lastUpdated = 0;
+    if (dirtyNodes.empty()) return;
+
+    // 1. Brudne węzły -> rozłączne zakresy DFS (poddrzewo brudnego przodka pokrywa brudnych potomków)
+    std::sort(dirtyNodes.begin(), dirtyNodes.end());
+    tasks.clear();
+    std::vector<int> stack;
+    int coveredEnd = 0;
+    for (int node : dirtyNodes) {
+        if (node < coveredEnd) continue;
+        coveredEnd = subtreeEnd[node];
+        // 2. Duże poddrzewa: korzeń liczymy tu, a poddrzewa dzieci idą jako osobne zadania
+        stack.push_back(node);
+        while (!stack.empty()) {
+            int n = stack.back(); stack.pop_back();
+            if (subtreeEnd[n] - n <= SPLIT_NODES) { tasks.push_back({n, subtreeEnd[n]}); continue; }
+            computeNode(world, n);
+            lastUpdated++;
+            for (int c = n + 1; c < subtreeEnd[n]; c = subtreeEnd[c]) stack.push_back(c);
+        }
+    }
+    dirtyNodes.clear();
+
+    // 3. Paczki zakresów po ~BATCH_NODES węzłów -> workery. Zakresy są niezależne od siebie.
+    std::vector<size_t> batchStart(1, 0);
+    int batchNodes = 0;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        int size = tasks[i].end - tasks[i].begin;
+        lastUpdated += size;
+        batchNodes += size;
+        if (batchNodes >= BATCH_NODES) { batchStart.push_back(i + 1); batchNodes = 0; }
+    }
+    if (batchStart.back() != tasks.size()) batchStart.push_back(tasks.size());
+
+    jobs.parallelFor(batchStart.size() - 1, 1, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+            for (size_t t = batchStart[b]; t < batchStart[b + 1]; ++t)
+                for (int n = tasks[t].begin; n < tasks[t].end; ++n) computeNode(world, n);
+    });
+}
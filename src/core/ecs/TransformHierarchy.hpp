@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "../math/Mat4.hpp"
+#include "../sceneobject/SceneObject.hpp"
+
+class World;
+class JobSystem;
+
+// --- HIERARCHIA TRANSFORMÓW (RODZIC / DZIECI) ---
+// Powiązania trzymamy per id jako listy rodzeństwa (zmiana rodzica = O(1)).
+// Do liczenia macierzy węzły są ułożone w tablicach w kolejności DFS: rodzic zawsze przed dziećmi,
+// a poddrzewo węzła i to ciągły zakres [i, subtreeEnd[i]). Tablice przebudowujemy tylko po zmianie
+// struktury; w zwykłej klatce przeliczamy wyłącznie poddrzewa oznaczone markDirty().
+// Transform w komponencie jest lokalny (względem rodzica), macierz świata daje getWorldMatrix().
+class TransformHierarchy {
+public:
+    // Powiadomienia z World (create/destroy/clear)
+    void onCreate(int id);
+    void onDestroy(int id); // dzieci stają się korzeniami
+    void clear();
+
+    bool setParent(int id, int parentId); // false, gdyby powstał cykl
+    int getParent(int id) const { return valid(id) ? links[id].parent : -1; }
+    int getFirstChild(int id) const { return valid(id) ? links[id].firstChild : -1; }
+    int getNextSibling(int id) const { return valid(id) ? links[id].nextSibling : -1; }
+    bool isAncestor(int ancestor, int id) const;
+    void collectSubtree(int id, std::vector<int>& out) const; // id + wszyscy potomkowie (rodzic przed dziećmi)
+
+    void markDirty(int id);
+    void update(const World& world, JobSystem& jobs);
+
+    const Mat4& getWorldMatrix(int id) const;
+    Vec3 getWorldPosition(int id) const { const float* m = getWorldMatrix(id).data(); return Vec3(m[12], m[13], m[14]); }
+
+    // Statystyki ostatniego update() (okno Profiler)
+    size_t getNodeCount() const { return nodeIds.size(); }
+    size_t getLastUpdatedCount() const { return lastUpdated; }
+
+    // Lokalna macierz T * Rz * Ry * Rx * S bez mnożenia pięciu macierzy (to samo co Transform::getModelMatrix)
+    static Mat4 composeLocal(const Transform& t);
+    // Iloczyn dwóch macierzy afinicznych (ostatni wiersz 0,0,0,1) - SSE, gdy dostępne
+    static void multiplyAffine(const Mat4& parent, const Mat4& local, Mat4& out);
+
+private:
+    struct Links {
+        int parent = -1, firstChild = -1, lastChild = -1, prevSibling = -1, nextSibling = -1;
+        bool alive = false;
+    };
+    struct Range { int begin, end; };
+
+    bool valid(int id) const { return id >= 0 && (size_t)id < links.size() && links[id].alive; }
+    void link(int id, int parentId);
+    void unlink(int id);
+    void rebuild(const World& world);
+    void computeNode(const World& world, int node);
+
+    std::vector<Links> links;
+
+    // Tablice DFS (indeks = węzeł, nie id)
+    std::vector<int> nodeIds;
+    std::vector<int> nodeParent;
+    std::vector<int> subtreeEnd;
+    std::vector<Mat4> localMatrices;
+    std::vector<Mat4> worldMatrices;
+    std::vector<uint8_t> localDirty;
+    std::vector<int> nodeOf; // id -> węzeł (-1 = brak)
+
+    std::vector<int> dirtyNodes;
+    std::vector<Range> tasks;
+    bool structureDirty = false;
+    size_t lastUpdated = 0;
+};
@@ -0,0 +1,171 @@
+#include "World.hpp"
+#include <algorithm>
+
+static std::unique_ptr<ColumnBase> makeColumn(int index) {
+    switch (index) {
+        case ComponentIndex<Transform>::value:    return std::make_unique<Column<Transform>>();
+        case ComponentIndex<PhysicsBody>::value:  return std::make_unique<Column<PhysicsBody>>();
+        case ComponentIndex<MeshRenderer>::value: return std::make_unique<Column<MeshRenderer>>();
+        case ComponentIndex<Material>::value:     return std::make_unique<Column<Material>>();
+        case ComponentIndex<Collider>::value:     return std::make_unique<Column<Collider>>();
+        case ComponentIndex<Tag>::value:          return std::make_unique<Column<Tag>>();
+        case ComponentIndex<Light>::value:        return std::make_unique<Column<Light>>();
+        case ComponentIndex<PlayerController>::value: return std::make_unique<Column<PlayerController>>();
+    }
+    return nullptr;
+}
+
+Archetype& World::getArchetype(ComponentMask mask) {
+    if (Archetype* a = archetypeByMask[mask]) return *a;
+    archetypes.push_back(std::make_unique<Archetype>());
+    Archetype* a = archetypes.back().get();
+    a->mask = mask;
+    archetypeByMask[mask] = a;
+    return *a;
+}
+
+// Dokłada pusty wiersz (same id) na końcu archetypu - kolumny wypełnia wołający
+Chunk& World::reserveRow(Archetype& a, int id, Slot& slot) {
+    if (a.chunks.empty() || a.chunks.back()->size() >= CHUNK_CAPACITY) {
+        auto chunk = std::make_unique<Chunk>();
+        chunk->ids.reserve(CHUNK_CAPACITY);
+        for (int c = 0; c < COMPONENT_COUNT; ++c) if (a.mask & (1u << c)) chunk->columns[c] = makeColumn(c);
+        a.chunks.push_back(std::move(chunk));
+    }
+    Chunk& chunk = *a.chunks.back();
+    slot.archetype = &a;
+    slot.chunk = (uint32_t)(a.chunks.size() - 1);
+    slot.row = (uint32_t)chunk.size();
+    chunk.ids.push_back(id);
+    a.count++;
+    return chunk;
+}
+
+// Usuwa wiersz, wstawiając na jego miejsce ostatnią encję archetypu (chunki zostają gęste)
+void World::removeRow(const Slot& slot) {
+    Archetype& a = *slot.archetype;
+    Chunk& chunk = *a.chunks[slot.chunk];
+    Chunk& last = *a.chunks.back();
+    size_t lastRow = last.size() - 1;
+    if (&chunk != &last || slot.row != lastRow) {
+        for (int c = 0; c < COMPONENT_COUNT; ++c) if (a.mask & (1u << c)) chunk.columns[c]->moveRow(slot.row, *last.columns[c], lastRow);
+        int movedId = last.ids[lastRow];
+        chunk.ids[slot.row] = movedId;
+        slots[movedId].chunk = slot.chunk;
+        slots[movedId].row = slot.row;
+    }
+    for (int c = 0; c < COMPONENT_COUNT; ++c) if (a.mask & (1u << c)) last.columns[c]->popBack();
+    last.ids.pop_back();
+    if (last.ids.empty()) a.chunks.pop_back();
+    a.count--;
+}
+
+const std::vector<Archetype*>& World::matching(ComponentMask mask) {
+    QueryCache& q = queries[mask];
+    if (q.archetypeCount != archetypes.size()) {
+        // Archetypy tylko przybywają (do clear()), więc wystarczy dopisać nowe
+        if (q.archetypeCount > archetypes.size()) { q.archetypes.clear(); q.archetypeCount = 0; }
+        for (size_t i = q.archetypeCount; i < archetypes.size(); ++i)
+            if ((archetypes[i]->mask & mask) == mask) q.archetypes.push_back(archetypes[i].get());
+        q.archetypeCount = archetypes.size();
+    }
+    return q.archetypes;
+}
+
+int World::allocateId() {
+    while (!freeIds.empty()) {
+        int id = freeIds.front();
+        freeIds.pop_front();
+        if (!contains(id)) return id;
+    }
+    slots.emplace_back();
+    return (int)slots.size() - 1;
+}
+
+Entity World::create(int id, ComponentMask mask) {
+    if (id < 0 || contains(id) || (size_t)id > slots.size() + MAX_ID_GAP) return Entity();
+    if ((size_t)id >= slots.size()) {
+        // Jawne id spoza zakresu (np. z pliku) - pominięte sloty trafiają do wolnych
+        for (size_t i = slots.size(); i < (size_t)id; ++i) freeIds.push_back((int)i);
+        slots.resize((size_t)id + 1);
+    }
+    Slot& slot = slots[id];
+    Chunk& chunk = reserveRow(getArchetype(mask), id, slot);
+    for (int c = 0; c < COMPONENT_COUNT; ++c) if (mask & (1u << c)) chunk.columns[c]->pushDefault();
+    slot.sequence = nextSequence++;
+    aliveCount++;
+    if (!orderDirty) order.push_back(id);
+    hierarchy.onCreate(id);
+    structureVersion++;
+    return Entity{(uint32_t)id, slot.generation};
+}
+
+void World::destroy(int id) {
+    if (!contains(id)) return;
+    Slot& slot = slots[id];
+    removeRow(slot);
+    hierarchy.onDestroy(id);
+    structureVersion++;
+    slot.archetype = nullptr;
+    slot.generation++;
+    freeIds.push_back(id);
+    aliveCount--;
+    orderDirty = true;
+}
+
+// Sloty i generacje zostają - uchwyty sprzed clear() są od razu nieważne
+void World::clear() {
+    archetypes.clear();
+    for (auto& a : archetypeByMask) a = nullptr;
+    for (auto& q : queries) { q.archetypes.clear(); q.archetypeCount = 0; }
+    freeIds.clear();
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].archetype) slots[i].generation++;
+        slots[i].archetype = nullptr;
+        freeIds.push_back((int)i);
+    }
+    aliveCount = 0;
+    order.clear();
+    orderDirty = false;
+    nextSequence = 0;
+    hierarchy.clear();
+    touched.clear();
+    structureVersion++;
+}
+
+void World::setMask(int id, ComponentMask mask) {
+    if (!contains(id) || slots[id].archetype->mask == mask) return;
+    Slot src = slots[id];
+    Chunk& from = *src.archetype->chunks[src.chunk];
+    Slot& dst = slots[id];
+    Chunk& to = reserveRow(getArchetype(mask), id, dst);
+    for (int c = 0; c < COMPONENT_COUNT; ++c) {
+        if (!(mask & (1u << c))) continue;
+        if (src.archetype->mask & (1u << c)) to.columns[c]->pushFrom(*from.columns[c], src.row);
+        else to.columns[c]->pushDefault();
+    }
+    removeRow(src);
+    hierarchy.markDirty(id);
+    structureVersion++;
+}
+
+bool World::setParent(int id, int parentId) {
+    if (!contains(id)) return false;
+    if (hierarchy.getParent(id) == parentId) return true;
+    if (!hierarchy.setParent(id, parentId)) return false;
+    structureVersion++;
+    return true;
+}
+
+const std::vector<int>& World::getOrder() const {
+    if (orderDirty) {
+        std::vector<std::pair<uint64_t, int>> sorted;
+        sorted.reserve(aliveCount);
+        for (size_t i = 0; i < slots.size(); ++i) if (slots[i].archetype) sorted.push_back({slots[i].sequence, (int)i});
+        std::sort(sorted.begin(), sorted.end());
+        order.clear();
+        for (const auto& s : sorted) order.push_back(s.second);
+        orderDirty = false;
+    }
+    return order;
+}
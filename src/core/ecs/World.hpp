@@ -0,0 +1,200 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "Components.hpp"
+#include "Entity.hpp"
+#include "NameTable.hpp"
+#include "TransformHierarchy.hpp"
+#include "../jobs/JobSystem.hpp"
+
+// Liczba encji w jednym chunku (każda kolumna rezerwuje tyle miejsca z góry)
+constexpr size_t CHUNK_CAPACITY = 1024;
+
+// --- KOLUMNA: ciągła tablica jednego komponentu w chunku ---
+// Wirtualne są tylko operacje strukturalne (dodanie/usunięcie/przeniesienie wiersza),
+// iteracja idzie bezpośrednio po typowanym wskaźniku.
+struct ColumnBase {
+    virtual ~ColumnBase() = default;
+    virtual void pushDefault() = 0;
+    virtual void pushFrom(ColumnBase& src, size_t srcRow) = 0;
+    virtual void moveRow(size_t dstRow, ColumnBase& src, size_t srcRow) = 0;
+    virtual void popBack() = 0;
+};
+
+template<typename T>
+struct Column : ColumnBase {
+    std::vector<T> data;
+    Column() { data.reserve(CHUNK_CAPACITY); }
+    void pushDefault() override { data.emplace_back(); }
+    void pushFrom(ColumnBase& src, size_t srcRow) override { data.push_back(std::move(static_cast<Column<T>&>(src).data[srcRow])); }
+    void moveRow(size_t dstRow, ColumnBase& src, size_t srcRow) override { data[dstRow] = std::move(static_cast<Column<T>&>(src).data[srcRow]); }
+    void popBack() override { data.pop_back(); }
+};
+
+struct Chunk {
+    std::vector<int> ids;
+    std::unique_ptr<ColumnBase> columns[COMPONENT_COUNT];
+
+    size_t size() const { return ids.size(); }
+    template<typename T> T* array() { return static_cast<Column<T>*>(columns[ComponentIndex<T>::value].get())->data.data(); }
+};
+
+// Wszystkie encje z identycznym zestawem komponentów
+struct Archetype {
+    ComponentMask mask = 0;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    size_t count = 0;
+};
+
+// --- ŚWIAT ECS (ARCHETYPY + CHUNKI SoA) ---
+// Encje identyfikuje trwałe `int id` (to samo co SceneObject::id w plikach .ducky) - jest to numer slotu,
+// więc wyszukiwanie to zwykły indeks. Edytor trzyma uchwyty Entity (id + generacja), żeby wykryć
+// odwołania do usuniętych obiektów. Zwolnione sloty wracają do kolejki (FIFO) i są używane ponownie.
+// Zmiana zestawu komponentów przenosi encję do innego archetypu; usuwanie to swap z ostatnim wierszem.
+// W trakcie each()/parallelEach() nie wolno zmieniać struktury świata (create/destroy/add/remove).
+class World {
+public:
+    World() = default;
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    int allocateId(); // O(1): wolny slot z kolejki albo nowy na końcu
+    // Pusty uchwyt, jeśli id jest zajęte, ujemne albo dalej niż MAX_ID_GAP za ostatnim slotem (uszkodzony plik
+    // nie może zaalokować miliardów slotów)
+    Entity create(int id, ComponentMask mask);
+    static const int MAX_ID_GAP = 65536;
+    void destroy(int id);
+    void destroy(Entity e) { if (isAlive(e)) destroy((int)e.index); }
+    void clear();
+
+    bool contains(int id) const { return id >= 0 && (size_t)id < slots.size() && slots[id].archetype; }
+    bool isAlive(Entity e) const { return contains(e.id()) && slots[e.index].generation == e.generation; }
+    Entity handleOf(int id) const { return contains(id) ? Entity{(uint32_t)id, slots[id].generation} : Entity(); }
+    size_t size() const { return aliveCount; }
+    ComponentMask getMask(int id) const { return contains(id) ? slots[id].archetype->mask : 0; }
+    void setMask(int id, ComponentMask mask); // dodaje/usuwa komponenty (przenosiny między archetypami)
+
+    template<typename T> T* get(int id) {
+        if (!contains(id)) return nullptr;
+        const Slot& slot = slots[id];
+        if (!(slot.archetype->mask & componentMask<T>())) return nullptr;
+        return &slot.archetype->chunks[slot.chunk]->template array<T>()[slot.row];
+    }
+    template<typename T> const T* get(int id) const { return const_cast<World*>(this)->get<T>(id); }
+    template<typename T> T* get(Entity e) { return isAlive(e) ? get<T>((int)e.index) : nullptr; }
+    template<typename T> const T* get(Entity e) const { return isAlive(e) ? get<T>((int)e.index) : nullptr; }
+    template<typename T> bool has(int id) const { return (getMask(id) & componentMask<T>()) != 0; }
+    template<typename T> T& add(int id) { setMask(id, getMask(id) | componentMask<T>()); return *get<T>(id); }
+    template<typename T> void remove(int id) { setMask(id, getMask(id) & ~componentMask<T>()); }
+
+    // fn(count, ids, Ts*... tablice) - po jednym wywołaniu na chunk (pętle wsadowe / SIMD)
+    template<typename... Ts, typename F>
+    void eachChunk(F&& fn) {
+        for (Archetype* a : matching(componentMask<Ts...>()))
+            for (auto& c : a->chunks) fn(c->size(), (const int*)c->ids.data(), c->template array<Ts>()...);
+    }
+
+    // fn(Ts&...) albo fn(int id, Ts&...)
+    template<typename... Ts, typename F>
+    void each(F&& fn) {
+        eachChunk<Ts...>([&](size_t n, const int* ids, Ts*... arrays) {
+            for (size_t i = 0; i < n; ++i) invoke(fn, ids[i], arrays[i]...);
+        });
+    }
+
+    // Jak each(), ale chunki rozdzielone między workery. fn musi być bezpieczne wątkowo.
+    template<typename... Ts, typename F>
+    void parallelEach(JobSystem& jobs, F&& fn) {
+        std::vector<Chunk*> matched;
+        for (Archetype* a : matching(componentMask<Ts...>()))
+            for (auto& c : a->chunks) matched.push_back(c.get());
+        jobs.parallelFor(matched.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                Chunk* c = matched[k];
+                size_t n = c->size();
+                const int* ids = c->ids.data();
+                auto arrays = std::make_tuple(c->template array<Ts>()...);
+                for (size_t i = 0; i < n; ++i) invoke(fn, ids[i], std::get<Ts*>(arrays)[i]...);
+            }
+        });
+    }
+
+    // Pierwsza encja z komponentem roli (np. PlayerController) - koszt zależy od liczby archetypów, nie obiektów
+    template<typename T> int findFirst() {
+        for (Archetype* a : matching(componentMask<T>())) if (a->count) return a->chunks.front()->ids.front();
+        return -1;
+    }
+
+    // Indeks archetypów dla maski komponentów (odświeżany tylko, gdy powstanie nowy archetyp)
+    const std::vector<Archetype*>& matching(ComponentMask mask);
+
+    // Kolejność dodania encji (Hierarchy, zapis sceny). Przebudowywana tylko po usunięciach.
+    const std::vector<int>& getOrder() const;
+
+    uint32_t intern(const std::string& name) { return names.intern(name); }
+    const std::string& nameOf(uint32_t nameId) const { return names.str(nameId); }
+    const std::string& getName(int id) const { const Tag* t = get<Tag>(id); return names.str(t ? t->name : 0); }
+
+    // --- HIERARCHIA --- Transform jest lokalny; po każdej zmianie Transform trzeba wołać touch(id)
+    bool setParent(int id, int parentId);
+    int getParent(int id) const { return hierarchy.getParent(id); }
+    // Zmiana komponentów z zewnątrz (edytor, gra) - odświeża macierze i trafia do listy zmian dla fizyki.
+    // Systemy zapisujące własne wyniki (fizyka) wołają markMoved(), żeby nie wracały do nich jako edycje.
+    // Tylko z wątku głównego.
+    void touch(int id) { hierarchy.markDirty(id); touched.push_back(id); }
+    void markMoved(int id) { hierarchy.markDirty(id); }
+    const std::vector<int>& getTouched() const { return touched; }
+    void clearTouched() { touched.clear(); }
+    // Rośnie przy create/destroy/clear/zmianie komponentów lub rodzica - sygnał do przebudowy kopii świata
+    uint64_t getStructureVersion() const { return structureVersion; }
+    void updateTransforms(JobSystem& jobs) { hierarchy.update(*this, jobs); }
+    const Mat4& getWorldMatrix(int id) const { return hierarchy.getWorldMatrix(id); }
+    Vec3 getWorldPosition(int id) const { return hierarchy.getWorldPosition(id); }
+    const TransformHierarchy& getHierarchy() const { return hierarchy; }
+
+    size_t getArchetypeCount() const { return archetypes.size(); }
+
+private:
+    // Slot = położenie encji w archetypie. archetype == nullptr -> slot wolny.
+    struct Slot {
+        Archetype* archetype = nullptr;
+        uint32_t chunk = 0, row = 0;
+        uint64_t sequence = 0;
+        uint32_t generation = 0;
+    };
+
+    template<typename... Ts, typename F>
+    static void invoke(F& fn, int id, Ts&... components) {
+        if constexpr (std::is_invocable_v<F&, int, Ts&...>) fn(id, components...);
+        else fn(components...);
+    }
+
+    Archetype& getArchetype(ComponentMask mask);
+    Chunk& reserveRow(Archetype& archetype, int id, Slot& slot);
+    void removeRow(const Slot& slot);
+
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    Archetype* archetypeByMask[1u << COMPONENT_COUNT] = {};
+    struct QueryCache {
+        size_t archetypeCount = 0;
+        std::vector<Archetype*> archetypes;
+    };
+    QueryCache queries[1u << COMPONENT_COUNT];
+
+    NameTable names;
+    TransformHierarchy hierarchy;
+    std::vector<int> touched;
+    uint64_t structureVersion = 0;
+    std::vector<Slot> slots;
+    std::deque<int> freeIds; // może zawierać sloty zajęte później jawnym create(id) - pomijane przy pobraniu
+    size_t aliveCount = 0;
+    uint64_t nextSequence = 0;
+
+    mutable std::vector<int> order;
+    mutable bool orderDirty = false;
+};
@@ -0,0 +1,61 @@
+#include "Gameplay.hpp"
+#include <cmath>
+#include "../camera/Camera.hpp"
+#include "../ecs/World.hpp"
+#include "../physics/PhysicsWorld.hpp"
+#include "../physics/ProjectileSystem.hpp"
+
+static const float VIEW_ASPECT = 1000.0f / 581.0f; // viewport gry (jak projekcja w main.cpp)
+static const float VIEW_DISTANCE = 100.0f;         // daleka płaszczyzna
+static const float SHOT_SPEED = 80.0f;             // m/s
+static const float SHOT_LIFETIME = 3.0f;           // s
+static const float SHOT_GRAVITY = 0.25f;           // lekki opad toru
+
+// Widzowie LOD symulacji: kamera ze stożkiem opisanym na ostrosłupie widzenia i gracz (tylko odległość)
+static void updateSimulationLod(PhysicsWorld& physics, const Camera& camera, const Transform* player) {
+    if (!physics.lod.enabled) return;
+    LodViewer viewers[2];
+    size_t count = 0;
+    const float tanY = std::tan(camera.fov * 0.5f * 3.14159265f / 180.0f);
+    const float tanDiagonal = tanY * std::sqrt(1.0f + VIEW_ASPECT * VIEW_ASPECT);
+    viewers[count].position = camera.position;
+    viewers[count].forward = camera.front;
+    viewers[count].viewCos = 1.0f / std::sqrt(1.0f + tanDiagonal * tanDiagonal);
+    viewers[count].viewDistance = VIEW_DISTANCE;
+    count++;
+    if (player) viewers[count++].position = player->position;
+    physics.updateLod(viewers, count);
+}
+
+PlayFrameResult playFrame(World& world, PhysicsWorld& physics, ProjectileSystem& projectiles, JobSystem& jobs, Camera& camera, uint32_t input, float frameTime) {
+    PlayFrameResult result;
+    int playerId = world.findFirst<PlayerController>();
+    Transform* playerT = world.get<Transform>(playerId); PhysicsBody* playerBody = world.get<PhysicsBody>(playerId);
+    if (playerT && playerBody) {
+        const PlayerController& pc = *world.get<PlayerController>(playerId);
+        float moveSpeed = pc.moveSpeed; playerBody->velocity.x = 0; playerBody->velocity.z = 0;
+        if (input & Input_Up)    playerBody->velocity.z = -moveSpeed;
+        if (input & Input_Down)  playerBody->velocity.z = moveSpeed;
+        if (input & Input_Left)  playerBody->velocity.x = -moveSpeed;
+        if (input & Input_Right) playerBody->velocity.x = moveSpeed;
+        if ((input & Input_Jump) && std::abs(playerBody->velocity.y) < 0.01f) playerBody->velocity.y = pc.jumpSpeed;
+        world.touch(playerId);
+        camera.position = Vec3(playerT->position.x, playerT->position.y + 4.0f, playerT->position.z + 6.0f); camera.yaw = -90.0f; camera.pitch = -25.0f; camera.updateCameraVectors();
+        if (playerBody->canShoot && (input & Input_Shoot))
+            projectiles.spawn(camera.position + camera.front * 0.5f, camera.front * SHOT_SPEED, SHOT_LIFETIME, playerId, SHOT_GRAVITY);
+    }
+    physics.sync(world);
+    updateSimulationLod(physics, camera, playerT);
+    physics.simulate(frameTime, jobs);
+    physics.writeBack(world);
+
+    // Pociski lecą po kroku fizyki, przeciw świeżemu drzewu; trafienie podbija cel jak dawny strzał promieniem
+    RayFilter notPlayer; notPlayer.exclude = Tag_Player;
+    projectiles.update(physics.deterministic ? physics.fixedStep : frameTime, physics, jobs, notPlayer);
+    for (const ProjectileHit& hit : projectiles.getHits()) {
+        world.add<PhysicsBody>(hit.target).velocity.y = 5.0f;
+        world.touch(hit.target);
+        if (result.shotHit == -1) result.shotHit = hit.target;
+    }
+    return result;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+class World;
+class PhysicsWorld;
+class ProjectileSystem;
+class JobSystem;
+class Camera;
+
+// Stan wejścia trybu PLAY w klatce - to, co main.cpp czyta z GLFW (i co zapisuje nagranie sesji)
+enum InputBits : uint32_t {
+    Input_Up    = 1u << 0,
+    Input_Down  = 1u << 1,
+    Input_Left  = 1u << 2,
+    Input_Right = 1u << 3,
+    Input_Jump  = 1u << 4,
+    Input_Shoot = 1u << 5
+};
+
+struct PlayFrameResult {
+    int shotHit = -1; // pierwsza encja trafiona pociskiem w tej klatce
+};
+
+// --- KLATKA ROZGRYWKI ---
+// Sterowanie graczem z bitów wejścia, kamera za graczem, fizyka (sync -> LOD symulacji od kamery i gracza
+// -> simulate -> writeBack), potem pociski: wciśnięty strzał wypuszcza jeden na klatkę z kamery.
+// Ten sam kod woła edytor i DuckyReplay, więc nagrane wejście odtwarza dokładnie te same zmiany świata.
+PlayFrameResult playFrame(World& world, PhysicsWorld& physics, ProjectileSystem& projectiles, JobSystem& jobs, Camera& camera, uint32_t input, float frameTime);
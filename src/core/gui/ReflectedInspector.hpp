@@ -0,0 +1,71 @@
+#pragma once
+#include <imgui.h>
+#include <cstring>
+#include <string>
+#include "../reflection/Reflection.hpp"
+#include "../math/Vec3.hpp"
+
+// --- INSPEKTOR GENEROWANY Z Reflect<T> ---
+// Zwraca true, jeśli użytkownik zmienił którekolwiek pole.
+template<typename T> bool drawReflected(T& obj);
+
+template<typename F, typename V>
+bool drawReflectedField(const F& f, V& v) {
+    if constexpr (IsReflected<V>::value) {
+        if (!ImGui::CollapsingHeader(f.label, ImGuiTreeNodeFlags_DefaultOpen)) return false;
+        ImGui::PushID(f.key);
+        bool changed = drawReflected(v);
+        ImGui::PopID();
+        return changed;
+    }
+    else if constexpr (std::is_same_v<V, Vec3>) {
+        if (f.has(Field_ReadOnly)) { ImGui::Text("%s: %.2f %.2f %.2f", f.label, v.x, v.y, v.z); return false; }
+        if (!f.has(Field_Degrees)) return ImGui::DragFloat3(f.label, &v.x, f.speed);
+        const float toDeg = 180.0f / 3.1415926535f;
+        float deg[3] = { v.x * toDeg, v.y * toDeg, v.z * toDeg };
+        if (!ImGui::DragFloat3(f.label, deg, f.speed)) return false;
+        v = Vec3(deg[0] / toDeg, deg[1] / toDeg, deg[2] / toDeg);
+        return true;
+    }
+    else if constexpr (std::is_same_v<V, float>) {
+        if (f.has(Field_ReadOnly)) { ImGui::Text("%s: %.3f", f.label, v); return false; }
+        if (f.has(Field_Slider)) return ImGui::SliderFloat(f.label, &v, f.min, f.max);
+        return ImGui::DragFloat(f.label, &v, f.speed);
+    }
+    else if constexpr (std::is_same_v<V, bool>) {
+        if (f.has(Field_ReadOnly)) { ImGui::Text("%s: %s", f.label, v ? "true" : "false"); return false; }
+        return ImGui::Checkbox(f.label, &v);
+    }
+    else if constexpr (std::is_same_v<V, int>) {
+        if (f.has(Field_ReadOnly)) { ImGui::Text("%s: %d", f.label, v); return false; }
+        return ImGui::InputInt(f.label, &v);
+    }
+    else if constexpr (std::is_same_v<V, std::string>) {
+        if (f.has(Field_ReadOnly)) { ImGui::Text("%s: %s", f.label, v.c_str()); return false; }
+        char buf[128]; memset(buf, 0, 128); strncpy(buf, v.c_str(), 127);
+        if (!ImGui::InputText(f.label, buf, 128)) return false;
+        v = std::string(buf);
+        return true;
+    }
+    else return false; // typ bez widżetu (enumy, id GL)
+}
+
+template<typename T>
+bool drawReflected(T& obj) {
+    bool changed = false;
+    const char* currentGroup = nullptr;
+    bool groupOpen = true;
+    forEachField<T>([&](const auto& f) {
+        if (f.has(Field_Hidden)) return;
+        // Kolejne pola z tą samą grupą lądują pod jednym nagłówkiem
+        if (f.group != currentGroup && (!f.group || !currentGroup || strcmp(f.group, currentGroup) != 0)) {
+            currentGroup = f.group;
+            groupOpen = !currentGroup || ImGui::CollapsingHeader(currentGroup, ImGuiTreeNodeFlags_DefaultOpen);
+        }
+        if (!groupOpen) return;
+        ImGui::PushID(f.key);
+        changed |= drawReflectedField(f, obj.*(f.member));
+        ImGui::PopID();
+    });
+    return changed;
+}
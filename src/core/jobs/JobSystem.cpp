@@ -0,0 +1,172 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <chrono>
+
+// Wątek workera pamięta też swój system - zadanie z workera jednego JobSystem zgłaszane do innego
+// (np. kilka instancji w benchmarkach) traktujemy jak z wątku zewnętrznego
+static thread_local struct { const JobSystem* owner; int index; } tlsWorker = { nullptr, -1 };
+
+static uint64_t nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+JobSystem::JobSystem(unsigned int workerCount) : mainThreadId(std::this_thread::get_id()) {
+    if (workerCount == 0) workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    for (unsigned int i = 0; i < workerCount; ++i) workers.push_back(std::make_unique<Worker>());
+    for (unsigned int i = 0; i < workerCount; ++i) workers[i]->thread = std::thread(&JobSystem::workerMain, this, i);
+    utilization.assign(workerCount, 0.0f);
+}
+
+JobSystem::~JobSystem() {
+    stopping = true;
+    wakeCv.notify_all();
+    for (auto& w : workers) if (w->thread.joinable()) w->thread.join();
+}
+
+// ==========================================
+// ZGŁASZANIE ZADAŃ
+// ==========================================
+void JobSystem::run(std::function<void()> fn, JobCounter* counter) {
+    if (counter) counter->value.fetch_add(1, std::memory_order_relaxed);
+    push(Job{std::move(fn), counter});
+}
+
+void JobSystem::runAfter(JobCounter& dependency, std::function<void()> fn, JobCounter* counter) {
+    if (counter) counter->value.fetch_add(1, std::memory_order_relaxed);
+    Job job{std::move(fn), counter};
+    {
+        std::lock_guard<std::mutex> lock(dependency.mutex);
+        if (!dependency.done()) { dependency.continuations.push_back(std::move(job)); return; }
+    }
+    push(std::move(job));
+}
+
+void JobSystem::runOnMainThread(std::function<void()> fn, JobCounter* counter) {
+    if (counter) counter->value.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mainMutex);
+    mainJobs.push_back(Job{std::move(fn), counter});
+}
+
+int JobSystem::currentWorker() const {
+    return tlsWorker.owner == this ? tlsWorker.index : -1;
+}
+
+void JobSystem::push(Job&& job) {
+    // Worker dokłada do własnej kolejki, reszta wątków rozrzuca po kolei
+    const int self = currentWorker();
+    unsigned int index = self >= 0 ? (unsigned int)self : nextQueue.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->jobs.push_back(std::move(job));
+    }
+    pending.fetch_add(1, std::memory_order_release);
+    wakeCv.notify_one();
+}
+
+// ==========================================
+// WYKONYWANIE
+// ==========================================
+bool JobSystem::tryPop(unsigned int index, Job& out) {
+    Worker& w = *workers[index];
+    std::lock_guard<std::mutex> lock(w.mutex);
+    if (w.jobs.empty()) return false;
+    out = std::move(w.jobs.back());
+    w.jobs.pop_back();
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::trySteal(unsigned int thief, Job& out) {
+    size_t n = workers.size();
+    size_t start = thief < n ? thief + 1 : nextQueue.load(std::memory_order_relaxed);
+    for (size_t k = 0; k < n; ++k) {
+        size_t victim = (start + k) % n;
+        if (victim == thief) continue;
+        Worker& w = *workers[victim];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.jobs.empty()) continue;
+        out = std::move(w.jobs.front());
+        w.jobs.pop_front();
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::tryRunOne(int workerIndex) {
+    Job job;
+    unsigned int self = workerIndex >= 0 ? (unsigned int)workerIndex : (unsigned int)workers.size();
+    if ((workerIndex >= 0 && tryPop(self, job)) || trySteal(self, job)) {
+        execute(job);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(Job& job) {
+    const int self = currentWorker();
+    if (self >= 0) {
+        uint64_t start = nowNs();
+        job.fn();
+        workers[self]->busyNs.fetch_add(nowNs() - start, std::memory_order_relaxed);
+    } else {
+        job.fn();
+    }
+    jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    finish(job.counter);
+}
+
+void JobSystem::finish(JobCounter* counter) {
+    if (!counter) return;
+    std::vector<Job> ready;
+    {
+        // Dekrementacja pod mutexem licznika - wait() po wyjściu bierze ten sam mutex,
+        // więc licznik na stosie czekającego nie zniknie nam spod rąk
+        std::lock_guard<std::mutex> lock(counter->mutex);
+        if (counter->value.fetch_sub(1, std::memory_order_acq_rel) == 1) ready.swap(counter->continuations);
+    }
+    for (auto& job : ready) push(std::move(job));
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.done()) {
+        if (isMainThread()) pumpMainThread();
+        if (!tryRunOne(currentWorker())) std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+void JobSystem::pumpMainThread() {
+    std::vector<Job> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mainMutex);
+        jobs.swap(mainJobs);
+    }
+    for (auto& job : jobs) execute(job);
+}
+
+void JobSystem::workerMain(unsigned int index) {
+    tlsWorker.owner = this;
+    tlsWorker.index = (int)index;
+    for (;;) {
+        if (tryRunOne((int)index)) continue;
+        if (stopping) break;
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wakeCv.wait_for(lock, std::chrono::milliseconds(2), [&] { return stopping.load() || pending.load(std::memory_order_acquire) > 0; });
+    }
+}
+
+// ==========================================
+// STATYSTYKI
+// ==========================================
+void JobSystem::sampleStats() {
+    uint64_t now = nowNs();
+    uint64_t dt = now - lastSampleNs;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        uint64_t busy = workers[i]->busyNs.load(std::memory_order_relaxed);
+        if (lastSampleNs != 0 && dt > 0) utilization[i] = std::min(1.0f, (float)(busy - workers[i]->lastBusyNs) / (float)dt);
+        workers[i]->lastBusyNs = busy;
+    }
+    lastSampleNs = now;
+}
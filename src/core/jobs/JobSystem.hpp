@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct JobCounter;
+
+struct Job {
+    std::function<void()> fn;
+    JobCounter* counter = nullptr;
+};
+
+// Licznik zadań: rośnie przy zgłoszeniu, maleje po wykonaniu. 0 = grupa skończona.
+// Zadania zgłoszone przez runAfter() czekają tutaj, aż licznik spadnie do zera.
+struct JobCounter {
+    std::atomic<int> value{0};
+    std::mutex mutex;
+    std::vector<Job> continuations;
+
+    bool done() const { return value.load(std::memory_order_acquire) == 0; }
+};
+
+// --- SYSTEM ZADAŃ (WORK-STEALING) ---
+// Każdy worker ma własną kolejkę: właściciel bierze z końca (LIFO, ciepły cache),
+// złodzieje z początku (FIFO). Czekający wątek nie śpi, tylko pomaga wykonywać zadania.
+// Zadania z GL muszą iść przez runOnMainThread() - wykonuje je pumpMainThread() w pętli głównej.
+class JobSystem {
+public:
+    explicit JobSystem(unsigned int workerCount = 0); // 0 = liczba rdzeni - 1
+    ~JobSystem();
+
+    void run(std::function<void()> fn, JobCounter* counter = nullptr);
+    // Zależność: fn startuje dopiero, gdy `dependency` spadnie do zera
+    void runAfter(JobCounter& dependency, std::function<void()> fn, JobCounter* counter = nullptr);
+    void runOnMainThread(std::function<void()> fn, JobCounter* counter = nullptr);
+
+    void wait(JobCounter& counter);
+    void pumpMainThread();
+
+    // fn(begin, end) dla kawałków po `grain` elementów; wątek wołający też liczy
+    template<typename F>
+    void parallelFor(size_t count, size_t grain, F&& fn) {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+        if (count <= grain || workers.empty()) { fn((size_t)0, count); return; }
+        JobCounter counter;
+        for (size_t begin = grain; begin < count; begin += grain) {
+            size_t end = begin + grain < count ? begin + grain : count;
+            run([&fn, begin, end]() { fn(begin, end); }, &counter);
+        }
+        fn((size_t)0, grain);
+        wait(counter);
+    }
+
+    unsigned int getWorkerCount() const { return (unsigned int)workers.size(); }
+    bool isMainThread() const { return std::this_thread::get_id() == mainThreadId; }
+
+    // Statystyki do okna Profiler (odświeżane przez sampleStats() raz na klatkę)
+    void sampleStats();
+    const std::vector<float>& getUtilization() const { return utilization; }
+    uint64_t getJobsExecuted() const { return jobsExecuted.load(); }
+    uint64_t getSteals() const { return steals.load(); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::thread thread;
+        std::atomic<uint64_t> busyNs{0};
+        uint64_t lastBusyNs = 0;
+    };
+
+    void workerMain(unsigned int index);
+    int currentWorker() const; // indeks workera tego systemu na bieżącym wątku, -1 = wątek spoza niego
+    void push(Job&& job);
+    bool tryPop(unsigned int index, Job& out);
+    bool trySteal(unsigned int thief, Job& out);
+    bool tryRunOne(int workerIndex);
+    void execute(Job& job);
+    void finish(JobCounter* counter);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::thread::id mainThreadId;
+    std::atomic<bool> stopping{false};
+    std::atomic<int> pending{0};
+    std::atomic<unsigned int> nextQueue{0};
+    std::mutex wakeMutex;
+    std::condition_variable wakeCv;
+
+    std::mutex mainMutex;
+    std::vector<Job> mainJobs;
+
+    std::atomic<uint64_t> jobsExecuted{0};
+    std::atomic<uint64_t> steals{0};
+    std::vector<float> utilization;
+    uint64_t lastSampleNs = 0;
+};
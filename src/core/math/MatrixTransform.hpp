@@ -47,6 +47,37 @@ public:
         return res;
     }
 
+    static Mat4 orthographic(float left, float right, float bottom, float top, float zNear, float zFar) {
+        Mat4 res(1.0f);
+        res.m[0] = 2.0f / (right - left);
+        res.m[5] = 2.0f / (top - bottom);
+        res.m[10] = -2.0f / (zFar - zNear);
+        res.m[12] = -(right + left) / (right - left);
+        res.m[13] = -(top + bottom) / (top - bottom);
+        res.m[14] = -(zFar + zNear) / (zFar - zNear);
+        return res;
+    }
+
+    // Odwrotność macierzy afinicznej (ostatni wiersz 0,0,0,1) - 3x3 przez dopełnienia + przesunięcie
+    static Mat4 inverseAffine(const Mat4& a) {
+        const float* m = a.m;
+        float a00 = m[0], a10 = m[1], a20 = m[2], a01 = m[4], a11 = m[5], a21 = m[6], a02 = m[8], a12 = m[9], a22 = m[10];
+        float i00 = a11 * a22 - a12 * a21, i01 = a02 * a21 - a01 * a22, i02 = a01 * a12 - a02 * a11;
+        float i10 = a12 * a20 - a10 * a22, i11 = a00 * a22 - a02 * a20, i12 = a02 * a10 - a00 * a12;
+        float i20 = a10 * a21 - a11 * a20, i21 = a01 * a20 - a00 * a21, i22 = a00 * a11 - a01 * a10;
+        float det = a00 * i00 + a01 * i10 + a02 * i20;
+        if (std::fabs(det) < 1e-12f) return Mat4(1.0f);
+        float inv = 1.0f / det;
+        Mat4 res(1.0f);
+        res.m[0] = i00 * inv; res.m[4] = i01 * inv; res.m[8] = i02 * inv;
+        res.m[1] = i10 * inv; res.m[5] = i11 * inv; res.m[9] = i12 * inv;
+        res.m[2] = i20 * inv; res.m[6] = i21 * inv; res.m[10] = i22 * inv;
+        res.m[12] = -(res.m[0] * m[12] + res.m[4] * m[13] + res.m[8] * m[14]);
+        res.m[13] = -(res.m[1] * m[12] + res.m[5] * m[13] + res.m[9] * m[14]);
+        res.m[14] = -(res.m[2] * m[12] + res.m[6] * m[13] + res.m[10] * m[14]);
+        return res;
+    }
+
     static Mat4 lookAt(const Vec3& eye, const Vec3& center, const Vec3& up) {
         Vec3 f = (center - eye).normalize();
         Vec3 s = f.cross(up).normalize();
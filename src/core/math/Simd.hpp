@@ -0,0 +1,8 @@
+#pragma once
+
+// --- SIMD (SSE) ---
+// x86-64 zawsze ma SSE2; gdzie go nie ma, kod używa wersji skalarnej pod #else.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DUCKY_SSE 1
+#endif
@@ -5,6 +5,10 @@
 #include <GLFW/glfw3.h>
 #include "../json.hpp"
 #include "../renderer/Renderer.hpp"
+#include "../scene/SceneLoader.hpp"
+#include "../scene/EditJournal.hpp"
+#include "../sceneobject/SceneSerializer.hpp"
+#include "../ecs/SceneObjectAdapter.hpp"
 
 using json = nlohmann::json;
 
@@ -12,113 +16,71 @@ using json = nlohmann::json;
 extern "C" char const * tinyfd_openFileDialog(char const * aTitle, char const * aDefaultPathAndFile, int aNumOfFilterPatterns, char const * const * aFilterPatterns, char const * aSingleFilterDescription, int aAllowMultipleSelects);
 extern "C" char const * tinyfd_saveFileDialog(char const * aTitle, char const * aDefaultPathAndFile, int aNumOfFilterPatterns, char const * const * aFilterPatterns, char const * aSingleFilterDescription);
 
-// --- HELPERY DO SERIALIZACJI (JSON) ---
-// Służą do zapisywania i wczytywania stanu obiektów (Save/Load oraz Undo/Redo)
-static json serializeObjMB(const SceneObject& o) {
-    json obj;
-    obj["id"] = o.id;
-    obj["name"] = o.name;
-    obj["type"] = static_cast<int>(o.type);
-
-    obj["transform"]["pos"] = {o.transform.position.x, o.transform.position.y, o.transform.position.z};
-    obj["transform"]["rot"] = {o.transform.rotation.x, o.transform.rotation.y, o.transform.rotation.z};
-    obj["transform"]["scale"] = {o.transform.scale.x, o.transform.scale.y, o.transform.scale.z};
-
-    obj["hasCollider"] = o.hasCollider;
-    obj["useGravity"] = o.useGravity;
-    obj["canShoot"] = o.canShoot;
-
-    obj["velocity"] = {o.velocity.x, o.velocity.y, o.velocity.z};
-    obj["locks"] = {o.lockX, o.lockY, o.lockZ};
-
-    obj["texturePath"] = o.texturePath;
-    obj["modelPath"] = o.modelPath;
-
-    obj["material"]["shininess"] = o.material.shininess;
-    obj["material"]["specularStrength"] = o.material.specularStrength;
-    obj["material"]["specularMapPath"] = o.material.specularMapPath;
-    return obj;
-}
-
-static SceneObject deserializeObjMB(const json& e, PrimitiveRenderer& renderer) {
-    SceneObject o;
-    o.id = e.value("id", 0);
-    o.name = e.value("name", "Obj");
-    o.type = static_cast<MeshType>(e.value("type", 0));
-
-    if(e.contains("transform")) {
-        auto& t = e["transform"];
-        if(t.contains("pos")) o.transform.position = Vec3(t["pos"][0], t["pos"][1], t["pos"][2]);
-        if(t.contains("rot")) o.transform.rotation = Vec3(t["rot"][0], t["rot"][1], t["rot"][2]);
-        if(t.contains("scale")) o.transform.scale = Vec3(t["scale"][0], t["scale"][1], t["scale"][2]);
-    }
-
-    o.hasCollider = e.value("hasCollider", true);
-    o.useGravity = e.value("useGravity", false);
-    o.canShoot = e.value("canShoot", false);
-
-    if(e.contains("velocity")) o.velocity = Vec3(e["velocity"][0], e["velocity"][1], e["velocity"][2]);
-    if(e.contains("locks")) { o.lockX = e["locks"][0]; o.lockY = e["locks"][1]; o.lockZ = e["locks"][2]; }
-
-    o.texturePath = e.value("texturePath", "");
-    o.modelPath = e.value("modelPath", "");
-
-    if(e.contains("material")) {
-        o.material.shininess = e["material"].value("shininess", 32.0f);
-        o.material.specularStrength = e["material"].value("specularStrength", 0.5f);
-        o.material.specularMapPath = e["material"].value("specularMapPath", "");
-    }
-
-    // Ładowanie zasobów
-    if(o.type == MeshType::Model && !o.modelPath.empty()) {
-        SceneObject m = renderer.loadModel(o.modelPath);
-        o.vao = m.vao; o.vertexCount = m.vertexCount;
-    }
-    if(!o.texturePath.empty()) o.textureId = renderer.loadTexture(o.texturePath);
-    if(!o.material.specularMapPath.empty()) o.material.specularMapId = renderer.loadTexture(o.material.specularMapPath);
-
-    return o;
+// --- UNDO / REDO IMPLEMENTACJA ---
+// Na stosie trzymamy tylko różnice (SceneDelta). saveState zapamiętuje stan "przed",
+// a commitPending (na początku następnej klatki) zamienia go na diff względem stanu "po".
+// Diff liczymy na SceneObject (adapter ECS), bo łatki Undo/dziennika są opisane polami SceneObject.
+void MenuBar::saveState(const World& world) {
+    commitPending(world);
+    pendingBase = readScene(world);
+    hasPending = true;
+    redoStack.clear();
 }
 
-// --- UNDO / REDO IMPLEMENTACJA ---
-void MenuBar::saveState(const std::vector<SceneObject>& currentObjects) {
-    undoStack.push_back(currentObjects);
+void MenuBar::commitPending(const World& world) {
+    if (!hasPending) return;
+    SceneDelta delta = computeSceneDelta(pendingBase, readScene(world));
+    pendingBase.clear();
+    hasPending = false;
+    if (delta.empty()) return;
+    if (journal) journal->recordDelta(delta, true);
+    undoStack.push_back(std::move(delta));
     if (undoStack.size() > 50) undoStack.erase(undoStack.begin()); // Limit historii
-    redoStack.clear();
 }
 
-void MenuBar::performUndo(std::vector<SceneObject>& currentObjects, int& selectedId) {
+void MenuBar::performUndo(World& world, Entity& selected) {
+    commitPending(world);
     if (undoStack.empty()) return;
-    redoStack.push_back(currentObjects);
-    currentObjects = undoStack.back();
+    std::vector<SceneObject> objects = readScene(world);
+    applySceneDelta(objects, undoStack.back(), false);
+    writeScene(world, objects);
+    if (journal) journal->recordDelta(undoStack.back(), false);
+    redoStack.push_back(std::move(undoStack.back()));
     undoStack.pop_back();
-    selectedId = -1;
+    selected = Entity();
 }
 
-void MenuBar::performRedo(std::vector<SceneObject>& currentObjects, int& selectedId) {
+void MenuBar::performRedo(World& world, Entity& selected) {
+    commitPending(world);
     if (redoStack.empty()) return;
-    undoStack.push_back(currentObjects);
-    currentObjects = redoStack.back();
+    std::vector<SceneObject> objects = readScene(world);
+    applySceneDelta(objects, redoStack.back(), true);
+    writeScene(world, objects);
+    if (journal) journal->recordDelta(redoStack.back(), true);
+    undoStack.push_back(std::move(redoStack.back()));
     redoStack.pop_back();
-    selectedId = -1;
+    selected = Entity();
 }
 
 // --- GŁÓWNA FUNKCJA RYSOWANIA ---
 void MenuBar::draw(Window& window,
-                   std::vector<SceneObject>& objects,
-                   int& selectedId,
+                   World& world,
+                   Entity& selected,
                    ProjectBrowser& browser,
                    float fps,
                    Camera& camera,
                    PrimitiveRenderer& renderer,
                    Console& console,
                    EngineMode& currentMode,
-                   EditorSettings& settings) {
+                   EditorSettings& settings,
+                   SceneLoader& sceneLoader) {
+
+    commitPending(world);
 
     // Skróty klawiszowe
     if (ImGui::IsKeyDown(ImGuiKey_LeftCtrl)) {
-        if (ImGui::IsKeyPressed(ImGuiKey_Z)) { performUndo(objects, selectedId); console.log("Undo", LogType::Info); }
-        if (ImGui::IsKeyPressed(ImGuiKey_Y)) { performRedo(objects, selectedId); console.log("Redo", LogType::Info); }
+        if (ImGui::IsKeyPressed(ImGuiKey_Z)) { performUndo(world, selected); console.log("Undo", LogType::Info); }
+        if (ImGui::IsKeyPressed(ImGuiKey_Y)) { performRedo(world, selected); console.log("Redo", LogType::Info); }
     }
 
     if (ImGui::BeginMainMenuBar()) {
@@ -126,28 +88,16 @@ void MenuBar::draw(Window& window,
         // --- 1. FILE ---
         if (ImGui::BeginMenu("File")) {
             if (ImGui::MenuItem("New Scene")) {
-                saveState(objects);
-                objects.clear();
-                selectedId = -1;
+                saveState(world);
+                world.clear();
+                selected = Entity();
                 console.log("New Scene Created", LogType::Warning);
             }
             if (ImGui::MenuItem("Open Scene", "Ctrl+O")) {
                 const char* patterns[] = { "*.ducky" };
                 if (const char* path = tinyfd_openFileDialog("Open Scene", "", 1, patterns, nullptr, 0)) {
-                    std::ifstream file(path);
-                    if (file.is_open()) {
-                        saveState(objects);
-                        try {
-                            json j; file >> j;
-                            if (j.contains("objects")) {
-                                objects.clear();
-                                for (const auto& el : j["objects"]) objects.push_back(deserializeObjMB(el, renderer));
-                                selectedId = -1;
-                                browser.navigateTo(std::string(path));
-                                console.log("Scene Loaded: " + std::string(path), LogType::Success);
-                            }
-                        } catch (...) { console.log("Failed to load scene", LogType::Error); }
-                    }
+                    sceneLoader.begin(std::string(path));
+                    console.log("Loading Scene: " + std::string(path), LogType::Info);
                 }
             }
             ImGui::Separator();
@@ -155,7 +105,7 @@ void MenuBar::draw(Window& window,
                 const char* patterns[] = { "*.ducky" };
                 if (const char* path = tinyfd_saveFileDialog("Save Scene", "level.ducky", 1, patterns, nullptr)) {
                     json j; j["objects"] = json::array();
-                    for (const auto& obj : objects) j["objects"].push_back(serializeObjMB(obj));
+                    for (const auto& obj : readScene(world)) j["objects"].push_back(serializeSceneObject(obj));
                     std::ofstream file(path); file << j.dump(4);
                     console.log("Scene Saved: " + std::string(path), LogType::Success);
                 }
@@ -165,7 +115,7 @@ void MenuBar::draw(Window& window,
                 const char* patterns[] = { "*.ducky" };
                 if (const char* path = tinyfd_saveFileDialog("Save As", "level_copy.ducky", 1, patterns, nullptr)) {
                     json j; j["objects"] = json::array();
-                    for (const auto& obj : objects) j["objects"].push_back(serializeObjMB(obj));
+                    for (const auto& obj : readScene(world)) j["objects"].push_back(serializeSceneObject(obj));
                     std::ofstream file(path); file << j.dump(4);
                     console.log("Scene Saved As: " + std::string(path), LogType::Success);
                 }
@@ -174,11 +124,11 @@ void MenuBar::draw(Window& window,
             if (ImGui::MenuItem("Import Asset")) {
                 const char* f = tinyfd_openFileDialog("Import OBJ", "", 0, nullptr, nullptr, 0);
                 if (f) {
-                    saveState(objects);
+                    saveState(world);
                     SceneObject m = renderer.loadModel(f);
                     if(m.vertexCount > 0) {
-                        int maxId=0; for(auto& o:objects) if(o.id>maxId) maxId=o.id; m.id=maxId+1;
-                        objects.push_back(m);
+                        m.id = world.allocateId();
+                        writeSceneObject(world, m);
                         console.log("Imported Asset: " + m.name, LogType::Success);
                     }
                 }
@@ -191,28 +141,26 @@ void MenuBar::draw(Window& window,
 
         // --- 2. EDIT ---
         if (ImGui::BeginMenu("Edit")) {
-            if (ImGui::MenuItem("Undo", "Ctrl+Z", false, !undoStack.empty())) performUndo(objects, selectedId);
-            if (ImGui::MenuItem("Redo", "Ctrl+Y", false, !redoStack.empty())) performRedo(objects, selectedId);
+            if (ImGui::MenuItem("Undo", "Ctrl+Z", false, !undoStack.empty())) performUndo(world, selected);
+            if (ImGui::MenuItem("Redo", "Ctrl+Y", false, !redoStack.empty())) performRedo(world, selected);
             ImGui::Separator();
-            if (ImGui::MenuItem("Duplicate", "Ctrl+D", false, selectedId != -1)) {
-                saveState(objects);
-                SceneObject* original = nullptr;
-                for(auto& o : objects) if(o.id == selectedId) original = &o;
-                if(original) {
-                    SceneObject copy = *original;
-                    int maxId=0; for(auto& o:objects) if(o.id>maxId) maxId=o.id; copy.id=maxId+1;
+            if (ImGui::MenuItem("Duplicate", "Ctrl+D", false, world.isAlive(selected))) {
+                saveState(world);
+                if(world.isAlive(selected)) {
+                    SceneObject copy = readSceneObject(world, selected.id());
+                    copy.id = world.allocateId();
                     copy.name += "_Copy";
                     copy.transform.position.x += 1.0f;
-                    objects.push_back(copy);
-                    selectedId = copy.id;
+                    writeSceneObject(world, copy);
+                    selected = world.handleOf(copy.id);
                     console.log("Object Duplicated", LogType::Info);
                 }
             }
-            if (ImGui::MenuItem("Delete", "Del", false, selectedId != -1)) {
-                saveState(objects);
-                for(auto it=objects.begin(); it!=objects.end(); ++it) {
-                    if(it->id == selectedId) { objects.erase(it); selectedId = -1; break; }
-                }
+            if (ImGui::MenuItem("Delete", "Del", false, world.isAlive(selected))) {
+                saveState(world);
+                std::vector<int> doomed; world.getHierarchy().collectSubtree(selected.id(), doomed);
+                for (int id : doomed) world.destroy(id);
+                selected = Entity();
                 console.log("Object Deleted", LogType::Info);
             }
             if (ImGui::MenuItem("Select All", "Ctrl+A")) { console.log("Select All not implemented yet", LogType::Warning); }
@@ -223,41 +171,48 @@ void MenuBar::draw(Window& window,
 
         // --- 3. CREATE (TU JEST KLUCZ DO SFERY I WALCA) ---
         if (ImGui::BeginMenu("Create")) {
-            auto spawn = [&](std::string name, MeshType type, Vec3 scale = Vec3(1,1,1), bool light=false) {
-                saveState(objects);
+            auto spawn = [&](std::string name, MeshType type, Vec3 scale = Vec3(1,1,1), LightType light = LightType::None) {
+                saveState(world);
                 SceneObject obj; obj.name = name; obj.type = type;
-                int maxId=0; for(auto& o:objects) if(o.id>maxId) maxId=o.id; obj.id=maxId+1;
+                obj.id = world.allocateId();
                 obj.transform.position = camera.position + camera.front * 5.0f;
                 obj.transform.scale = scale;
-                if(light) { obj.hasCollider=false; obj.useGravity=false; }
-                objects.push_back(obj); selectedId=obj.id;
+                if(light != LightType::None) { obj.hasCollider=false; obj.useGravity=false; obj.light.type=light; }
+                writeSceneObject(world, obj); selected=world.handleOf(obj.id);
                 console.log("Created: " + name, LogType::Success);
             };
 
             if (ImGui::MenuItem("Cube")) spawn("Cube", MeshType::Cube);
 
-            // --- WAŻNE: Sfera i Walec jako MeshType::Model ---
-            // Ustawiamy typ na Model, mimo że nie ładujemy pliku.
-            // main.cpp wykryje (Name=="Sphere" && Type==Model && vao==0) i wygeneruje kształt.
-            if (ImGui::MenuItem("Sphere")) spawn("Sphere", MeshType::Model);
-            if (ImGui::MenuItem("Cylinder")) spawn("Cylinder", MeshType::Model);
+            // Sfera i Walec mają własne typy - renderer rysuje je wspólną siatką (nazwa nie ma znaczenia)
+            if (ImGui::MenuItem("Sphere")) spawn("Sphere", MeshType::Sphere);
+            if (ImGui::MenuItem("Cylinder")) spawn("Cylinder", MeshType::Cylinder);
 
             if (ImGui::MenuItem("Plane")) spawn("Plane", MeshType::Cube, Vec3(5, 0.1f, 5));
             if (ImGui::MenuItem("Floor")) spawn("Floor", MeshType::Cube, Vec3(10, 0.1f, 10));
             ImGui::Separator();
-            if (ImGui::MenuItem("Empty Object")) spawn("Empty", MeshType::Cube, Vec3(0.5f,0.5f,0.5f), true);
+            if (ImGui::MenuItem("Empty Object")) {
+                saveState(world);
+                SceneObject empty; empty.name="Empty"; empty.type=MeshType::Cube;
+                empty.id = world.allocateId();
+                empty.transform.position = camera.position + camera.front * 5.0f; empty.transform.scale=Vec3(0.5f,0.5f,0.5f);
+                empty.hasCollider=false; empty.useGravity=false;
+                writeSceneObject(world, empty); selected=world.handleOf(empty.id);
+                console.log("Created: Empty", LogType::Success);
+            }
             ImGui::Separator();
             if (ImGui::MenuItem("Sun")) {
-                saveState(objects);
+                saveState(world);
                 SceneObject sun; sun.name="Sun"; sun.type=MeshType::Cube;
-                int max=0; for(auto& o:objects) if(o.id>max) max=o.id; sun.id=max+1;
+                sun.id = world.allocateId();
                 sun.transform.position = Vec3(5,10,5); sun.transform.scale=Vec3(0.5f,0.5f,0.5f);
                 sun.hasCollider=false; sun.useGravity=false;
-                objects.push_back(sun); selectedId=sun.id;
+                sun.tags=Tag_NoShadow; sun.light.type=LightType::Directional;
+                writeSceneObject(world, sun); selected=world.handleOf(sun.id);
                 console.log("Sun Created", LogType::Warning);
             }
-            if (ImGui::MenuItem("Point Light")) spawn("PointLight", MeshType::Cube, Vec3(0.3f,0.3f,0.3f), true);
-            if (ImGui::MenuItem("Spot Light")) spawn("SpotLight", MeshType::Cube, Vec3(0.3f,0.3f,0.3f), true);
+            if (ImGui::MenuItem("Point Light")) spawn("PointLight", MeshType::Cube, Vec3(0.3f,0.3f,0.3f), LightType::Point);
+            if (ImGui::MenuItem("Spot Light")) spawn("SpotLight", MeshType::Cube, Vec3(0.3f,0.3f,0.3f), LightType::Spot);
             ImGui::Separator();
             if (ImGui::MenuItem("Skybox")) console.log("Use Inspector to set Skybox", LogType::Info);
             ImGui::EndMenu();
@@ -268,9 +223,9 @@ void MenuBar::draw(Window& window,
             if (ImGui::MenuItem("Reset Camera")) {
                 camera.position = Vec3(0, 2, 8); camera.yaw = -90.0f; camera.pitch = 0.0f; camera.updateCameraVectors();
             }
-            if (ImGui::MenuItem("Focus on Selected", "F", false, selectedId != -1)) {
-                for(auto& o : objects) if(o.id == selectedId) {
-                    camera.position = o.transform.position + Vec3(0, 2, 5);
+            if (ImGui::MenuItem("Focus on Selected", "F", false, world.isAlive(selected))) {
+                if(world.get<Transform>(selected)) {
+                    camera.position = world.getWorldPosition(selected.id()) + Vec3(0, 2, 5);
                     // Prosty reset kąta, lookAt wymagałoby więcej matematyki
                     camera.yaw = -90.0f; camera.pitch = -20.0f; camera.updateCameraVectors();
                 }
@@ -343,8 +298,9 @@ void MenuBar::draw(Window& window,
                 console.log("Game Stopped via Menu", LogType::Info);
             }
             if (ImGui::MenuItem("Play from Camera")) {
-                 saveState(objects);
-                 for(auto& o : objects) if(o.name == "Player") { o.transform.position = camera.position; break; }
+                 saveState(world);
+                 int playerId = world.findFirst<PlayerController>();
+                 if (Transform* t = world.get<Transform>(playerId)) { t->position = camera.position; world.touch(playerId); }
                  currentMode = EngineMode::PLAY;
                  console.log("Playing from Camera pos", LogType::Info);
             }
@@ -356,6 +312,9 @@ void MenuBar::draw(Window& window,
             if (ImGui::MenuItem("Reload Shaders")) console.log("Shaders Reloaded", LogType::Info);
             if (ImGui::MenuItem("Rebuild Lighting")) console.log("Baking Lightmaps...", LogType::Info);
             if (ImGui::MenuItem("Toggle Debug View", nullptr, &settings.debugView)) {}
+            if (ImGui::MenuItem("Deterministic Physics", nullptr, &settings.deterministicPhysics)) {}
+            if (ImGui::MenuItem("Record Play Session", nullptr, &settings.recordPlay)) {}
+            if (ImGui::MenuItem("Simulation LOD", nullptr, &settings.simulationLod)) {}
             if (ImGui::MenuItem("Screenshot")) console.log("Screenshot saved", LogType::Success);
             if (ImGui::MenuItem("Clear Cache")) console.log("Cache cleared", LogType::Warning);
             ImGui::EndMenu();
@@ -425,8 +384,10 @@ void MenuBar::draw(Window& window,
             static float guiScale = 1.0f;
             ImGui::DragFloat("UI Scale", &guiScale, 0.1f, 0.5f, 2.0f);
 
-            static bool autoSave = true;
-            ImGui::Checkbox("Auto Save on Play", &autoSave);
+            ImGui::Checkbox("Auto Save on Play", &settings.autoSave);
+            if (journal && journal->isRunning()) {
+                ImGui::TextDisabled("Journal: %d edits, %.1f KB since last snapshot", journal->getOpsSinceSnapshot(), journal->getJournalBytes() / 1024.0f);
+            }
 
             static int undoLimit = 50;
             ImGui::InputInt("Undo History Limit", &undoLimit);
@@ -5,8 +5,12 @@
 #include "../filesystem/ProjectBrowser.hpp"
 #include "../camera/Camera.hpp"
 #include "../gui/Console.hpp"
+#include "../sceneobject/SceneSerializer.hpp"
+#include "../ecs/World.hpp"
 
 class PrimitiveRenderer;
+class SceneLoader;
+class EditJournal;
 
 // Tryby silnika
 enum class EngineMode { EDIT, PLAY, PAUSE };
@@ -27,32 +31,49 @@ struct EditorSettings {
     bool showInspector = true;
     bool showAssets = true;
     bool showConsole = true;
-    bool showProfiler = false; // Placeholder
+    bool showProfiler = false;
 
     // Tools
     bool debugView = false;
+    bool deterministicPhysics = false; // jeden krok fizyki na klatkę (powtarzalne przebiegi)
+    bool recordPlay = false;           // nagrywa sesję PLAY do captures/ (odtwarzanie: DuckyReplay)
+    bool simulationLod = false;        // dalekie i niewidoczne ciała krokowane rzadziej albo zamrożone
+
+    // Autosave (dziennik edycji w tle)
+    bool autoSave = true;
 };
 
 class MenuBar {
 public:
     void draw(Window& window,
-              std::vector<SceneObject>& objects,
-              int& selectedId,
+              World& world,
+              Entity& selected,
               ProjectBrowser& browser,
               float fps,
               Camera& camera,
               PrimitiveRenderer& renderer,
               Console& console,
               EngineMode& currentMode,
-              EditorSettings& settings); // <--- Przekazujemy ustawienia
+              EditorSettings& settings, // <--- Przekazujemy ustawienia
+              SceneLoader& sceneLoader);
+
+    // Zapis stanu do Undo (wołane też z main.cpp przy podmianie wczytanej sceny)
+    void saveState(const World& world);
+
+    // Dziennik autosave - dostaje każdą zatwierdzoną zmianę z Undo/Redo
+    void setJournal(EditJournal* editJournal) { journal = editJournal; }
 
 private:
-    // Undo/Redo
-    std::vector<std::vector<SceneObject>> undoStack;
-    std::vector<std::vector<SceneObject>> redoStack;
-    void saveState(const std::vector<SceneObject>& currentObjects);
-    void performUndo(std::vector<SceneObject>& currentObjects, int& selectedId);
-    void performRedo(std::vector<SceneObject>& currentObjects, int& selectedId);
+    EditJournal* journal = nullptr;
+
+    // Undo/Redo (różnicowe)
+    std::vector<SceneDelta> undoStack;
+    std::vector<SceneDelta> redoStack;
+    std::vector<SceneObject> pendingBase;
+    bool hasPending = false;
+    void commitPending(const World& world);
+    void performUndo(World& world, Entity& selected);
+    void performRedo(World& world, Entity& selected);
 
     // Stan pełnego ekranu
     bool isFullscreen = false;
@@ -0,0 +1,169 @@
+#include "AabbTree.hpp"
+#include <algorithm>
+
+// ==========================================
+// WĘZŁY
+// ==========================================
+int AabbTree::allocateNode() {
+    if (freeList == NULL_NODE) {
+        nodes.emplace_back();
+        freeList = (int)nodes.size() - 1;
+        nodes[freeList].parent = NULL_NODE;
+    }
+    int index = freeList;
+    freeList = nodes[index].parent;
+    nodes[index] = Node();
+    nodes[index].height = 0;
+    return index;
+}
+
+void AabbTree::freeNode(int index) {
+    nodes[index].parent = freeList;
+    nodes[index].height = -1;
+    freeList = index;
+}
+
+void AabbTree::clear() {
+    nodes.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+}
+
+Aabb AabbTree::fatten(const Aabb& tight) const {
+    return { Vec3(tight.min.x - margin, tight.min.y - margin, tight.min.z - margin), Vec3(tight.max.x + margin, tight.max.y + margin, tight.max.z + margin) };
+}
+
+// ==========================================
+// API
+// ==========================================
+int AabbTree::insert(const Aabb& tight, int userData) {
+    int leaf = allocateNode();
+    nodes[leaf].box = fatten(tight);
+    nodes[leaf].userData = userData;
+    insertLeaf(leaf);
+    return leaf;
+}
+
+void AabbTree::remove(int proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+}
+
+bool AabbTree::move(int proxy, const Aabb& tight) {
+    if (nodes[proxy].box.contains(tight)) return false;
+    removeLeaf(proxy);
+    nodes[proxy].box = fatten(tight);
+    insertLeaf(proxy);
+    return true;
+}
+
+// ==========================================
+// WSTAWIANIE / USUWANIE
+// ==========================================
+void AabbTree::insertLeaf(int leaf) {
+    if (root == NULL_NODE) { root = leaf; nodes[leaf].parent = NULL_NODE; return; }
+
+    // Zejście po najtańszej gałęzi: koszt = przyrost powierzchni wszystkich przodków + nowy węzeł
+    const Aabb leafBox = nodes[leaf].box;
+    int index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node& n = nodes[index];
+        float area = n.box.area();
+        float combinedArea = Aabb::merge(n.box, leafBox).area();
+        float cost = 2.0f * combinedArea;
+        float inheritance = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](int child) {
+            const Node& c = nodes[child];
+            float merged = Aabb::merge(leafBox, c.box).area();
+            return (c.isLeaf() ? merged : merged - c.box.area()) + inheritance;
+        };
+        float cost1 = childCost(n.child1), cost2 = childCost(n.child2);
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? n.child1 : n.child2;
+    }
+
+    int sibling = index;
+    int oldParent = nodes[sibling].parent;
+    int newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = Aabb::merge(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+    if (oldParent != NULL_NODE) {
+        if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+        else nodes[oldParent].child2 = newParent;
+    } else root = newParent;
+
+    for (index = nodes[leaf].parent; index != NULL_NODE; index = nodes[index].parent) {
+        index = balance(index);
+        Node& n = nodes[index];
+        n.height = 1 + std::max(nodes[n.child1].height, nodes[n.child2].height);
+        n.box = Aabb::merge(nodes[n.child1].box, nodes[n.child2].box);
+    }
+}
+
+void AabbTree::removeLeaf(int leaf) {
+    if (leaf == root) { root = NULL_NODE; return; }
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+    if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+    else nodes[grandParent].child2 = sibling;
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    for (int index = grandParent; index != NULL_NODE; index = nodes[index].parent) {
+        index = balance(index);
+        Node& n = nodes[index];
+        n.height = 1 + std::max(nodes[n.child1].height, nodes[n.child2].height);
+        n.box = Aabb::merge(nodes[n.child1].box, nodes[n.child2].box);
+    }
+}
+
+// Rotacja, gdy wysokości dzieci różnią się o więcej niż 1 - wyższy wnuk idzie w górę. Zwraca nowy korzeń poddrzewa.
+int AabbTree::balance(int iA) {
+    Node& A = nodes[iA];
+    if (A.isLeaf() || A.height < 2) return iA;
+    int iB = A.child1, iC = A.child2;
+    int diff = nodes[iC].height - nodes[iB].height;
+
+    // up = dziecko wynoszone w górę, stay = drugie dziecko A
+    auto rotate = [&](int iUp, bool upIsChild2) {
+        Node& U = nodes[iUp];
+        int i1 = U.child1, i2 = U.child2;
+        U.child1 = iA;
+        U.parent = A.parent;
+        A.parent = iUp;
+        if (U.parent != NULL_NODE) {
+            if (nodes[U.parent].child1 == iA) nodes[U.parent].child1 = iUp;
+            else nodes[U.parent].child2 = iUp;
+        } else root = iUp;
+
+        int iStay = upIsChild2 ? iB : iC;
+        int iHigh = nodes[i1].height > nodes[i2].height ? i1 : i2;
+        int iLow = iHigh == i1 ? i2 : i1;
+        U.child2 = iHigh;
+        if (upIsChild2) A.child2 = iLow; else A.child1 = iLow;
+        nodes[iLow].parent = iA;
+        A.box = Aabb::merge(nodes[iStay].box, nodes[iLow].box);
+        A.height = 1 + std::max(nodes[iStay].height, nodes[iLow].height);
+        U.box = Aabb::merge(A.box, nodes[iHigh].box);
+        U.height = 1 + std::max(A.height, nodes[iHigh].height);
+        return iUp;
+    };
+
+    if (diff > 1) return rotate(iC, true);
+    if (diff < -1) return rotate(iB, false);
+    return iA;
+}
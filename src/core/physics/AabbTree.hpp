@@ -0,0 +1,145 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "../math/Simd.hpp"
+#include "../math/Vec3.hpp"
+
+struct Aabb {
+    Vec3 min, max;
+
+    bool overlaps(const Aabb& o) const {
+        return min.x <= o.max.x && max.x >= o.min.x && min.y <= o.max.y && max.y >= o.min.y && min.z <= o.max.z && max.z >= o.min.z;
+    }
+    bool contains(const Aabb& o) const {
+        return min.x <= o.min.x && min.y <= o.min.y && min.z <= o.min.z && max.x >= o.max.x && max.y >= o.max.y && max.z >= o.max.z;
+    }
+    float area() const { float dx = max.x - min.x, dy = max.y - min.y, dz = max.z - min.z; return 2.0f * (dx * dy + dy * dz + dz * dx); }
+    static Aabb merge(const Aabb& a, const Aabb& b) {
+        return { Vec3(a.min.x < b.min.x ? a.min.x : b.min.x, a.min.y < b.min.y ? a.min.y : b.min.y, a.min.z < b.min.z ? a.min.z : b.min.z),
+                 Vec3(a.max.x > b.max.x ? a.max.x : b.max.x, a.max.y > b.max.y ? a.max.y : b.max.y, a.max.z > b.max.z ? a.max.z : b.max.z) };
+    }
+};
+
+// Paczka 4 promieni (SoA) do raycast(). Lana nieaktywna ma tMax < 0.
+struct alignas(16) RayPacket {
+    float ox[4], oy[4], oz[4];
+    float ix[4], iy[4], iz[4]; // 1 / kierunek (duża liczba zamiast nieskończoności)
+    float tMax[4];             // najbliższe trafienie do tej pory - skraca dalsze przejście
+};
+
+// --- BROADPHASE: DYNAMICZNE DRZEWO AABB ---
+// Liście trzymają "grube" AABB (powiększone o margines), więc ciało poruszające się w obrębie
+// marginesu nie zmienia drzewa, a uśpione/statyczne ciała nie kosztują nic. Wstawianie wybiera
+// rodzeństwo po koszcie powierzchni (SAH), rotacje trzymają drzewo zbalansowane.
+// Zapytania są tylko do odczytu - można je wołać z wielu wątków naraz.
+class AabbTree {
+public:
+    static constexpr int NULL_NODE = -1;
+
+    int insert(const Aabb& tight, int userData); // zwraca uchwyt liścia
+    void remove(int proxy);
+    bool move(int proxy, const Aabb& tight);     // true, jeśli liść wyszedł poza grubą skrzynkę i został przełożony
+    void clear();
+
+    const Aabb& getFatAabb(int proxy) const { return nodes[proxy].box; }
+    int getUserData(int proxy) const { return nodes[proxy].userData; }
+    int getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+    // fn(userData) -> false przerywa zapytanie
+    template<typename F>
+    void query(const Aabb& box, F&& fn) const {
+        if (root == NULL_NODE) return;
+        // Stos na stosie wywołań; przepełnienie (bardzo wysokie drzewo) idzie do wektora
+        int fixed[64]; int top = 0;
+        std::vector<int> overflow;
+        auto push = [&](int i) { if (top < 64) fixed[top++] = i; else overflow.push_back(i); };
+        push(root);
+        while (top > 0 || !overflow.empty()) {
+            int index;
+            if (!overflow.empty()) { index = overflow.back(); overflow.pop_back(); }
+            else index = fixed[--top];
+            const Node& n = nodes[index];
+            if (!n.box.overlaps(box)) continue;
+            if (n.isLeaf()) { if (!fn(n.userData)) return; continue; }
+            push(n.child1);
+            push(n.child2);
+        }
+    }
+
+    // Paczka promieni w dół drzewa: węzeł odwiedzamy, jeśli trafia go którakolwiek lana.
+    // fn(userData, maskaLan) robi dokładny test liścia i może zmniejszyć packet.tMax.
+    template<typename F>
+    void raycast(RayPacket& packet, F&& fn) const {
+        if (root == NULL_NODE) return;
+        int fixed[64]; int top = 0;
+        std::vector<int> overflow;
+        auto push = [&](int i) { if (top < 64) fixed[top++] = i; else overflow.push_back(i); };
+        push(root);
+        while (top > 0 || !overflow.empty()) {
+            int index;
+            if (!overflow.empty()) { index = overflow.back(); overflow.pop_back(); }
+            else index = fixed[--top];
+            const Node& n = nodes[index];
+            int mask = slabMask(n.box, packet);
+            if (!mask) continue;
+            if (n.isLeaf()) { fn(n.userData, mask); continue; }
+            push(n.child1);
+            push(n.child2);
+        }
+    }
+
+    // Bit l = promień l wchodzi w skrzynkę przed swoim tMax
+    static int slabMask(const Aabb& box, const RayPacket& p) {
+#ifdef DUCKY_SSE
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.x), _mm_load_ps(p.ox)), _mm_load_ps(p.ix));
+        __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.x), _mm_load_ps(p.ox)), _mm_load_ps(p.ix));
+        __m128 tNear = _mm_min_ps(t1, t2), tFar = _mm_max_ps(t1, t2);
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.y), _mm_load_ps(p.oy)), _mm_load_ps(p.iy));
+        t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.y), _mm_load_ps(p.oy)), _mm_load_ps(p.iy));
+        tNear = _mm_max_ps(tNear, _mm_min_ps(t1, t2)); tFar = _mm_min_ps(tFar, _mm_max_ps(t1, t2));
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.z), _mm_load_ps(p.oz)), _mm_load_ps(p.iz));
+        t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.z), _mm_load_ps(p.oz)), _mm_load_ps(p.iz));
+        tNear = _mm_max_ps(tNear, _mm_min_ps(t1, t2)); tFar = _mm_min_ps(tFar, _mm_max_ps(t1, t2));
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(tNear, tFar), _mm_cmpge_ps(tFar, _mm_setzero_ps()));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(tNear, _mm_load_ps(p.tMax)));
+        return _mm_movemask_ps(hit);
+#else
+        int mask = 0;
+        for (int l = 0; l < 4; ++l) {
+            float tNear = -1e30f, tFar = 1e30f;
+            const float o[3] = { p.ox[l], p.oy[l], p.oz[l] }, inv[3] = { p.ix[l], p.iy[l], p.iz[l] };
+            const float lo[3] = { box.min.x, box.min.y, box.min.z }, hi[3] = { box.max.x, box.max.y, box.max.z };
+            for (int k = 0; k < 3; ++k) {
+                float t1 = (lo[k] - o[k]) * inv[k], t2 = (hi[k] - o[k]) * inv[k];
+                tNear = std::max(tNear, std::min(t1, t2));
+                tFar = std::min(tFar, std::max(t1, t2));
+            }
+            if (tNear <= tFar && tFar >= 0.0f && tNear <= p.tMax[l]) mask |= 1 << l;
+        }
+        return mask;
+#endif
+    }
+
+    float margin = 0.1f;
+
+private:
+    struct Node {
+        Aabb box;
+        int parent = NULL_NODE; // w wolnych węzłach: następny wolny
+        int child1 = NULL_NODE, child2 = NULL_NODE;
+        int height = -1;        // -1 = wolny, 0 = liść
+        int userData = -1;
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    int allocateNode();
+    void freeNode(int index);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int index);
+    Aabb fatten(const Aabb& tight) const;
+
+    std::vector<Node> nodes;
+    int root = NULL_NODE;
+    int freeList = NULL_NODE;
+};
@@ -0,0 +1,253 @@
+#include "ContactSolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "../jobs/JobSystem.hpp"
+#include "../math/Simd.hpp"
+
+static const float BAUMGARTE = 0.2f;    // ułamek penetracji usuwany na krok
+static const float SLOP = 0.005f;       // penetracja tolerowana bez korekcji (mniej drżenia)
+static const int OPEN_BATCHES = 8;      // ile paczek naraz czeka na kontakty bez konfliktu
+static const int TASK_BATCHES = 64;     // małe wyspy są sklejane w zadania po ~tyle paczek
+
+// ==========================================
+// BUDOWANIE WYSP
+// ==========================================
+void ContactSolver::begin() {
+    vx.clear(); vy.clear(); vz.clear();
+    imx.clear(); imy.clear(); imz.clear();
+    pending.clear();
+    batches.clear();
+    islands.clear();
+}
+
+int ContactSolver::beginIsland() {
+    int slot = addBody(Vec3(), Vec3());
+    islands.push_back({slot, (int)batches.size(), (int)batches.size()});
+    islandContactBegin = pending.size();
+    return slot;
+}
+
+int ContactSolver::addBody(const Vec3& velocity, const Vec3& invMass) {
+    vx.push_back(velocity.x); vy.push_back(velocity.y); vz.push_back(velocity.z);
+    imx.push_back(invMass.x); imy.push_back(invMass.y); imz.push_back(invMass.z);
+    return (int)vx.size() - 1;
+}
+
+void ContactSolver::addContact(int a, int b, const Vec3& normal, float separation, float dt, uint64_t key) {
+    pending.push_back({a, b, normal, separation, dt, key});
+}
+
+const ContactSolver::Cached* ContactSolver::findCached(uint64_t key) const {
+    if (cache.empty()) return nullptr;
+    const size_t mask = cache.size() - 1;
+    for (size_t i = slotOf(key, mask);; i = (i + 1) & mask) {
+        if (cache[i].key == key) return &cache[i];
+        if (cache[i].key == EMPTY_KEY) return nullptr;
+    }
+}
+
+void ContactSolver::fillLane(Batch& batch, int lane, int contact) {
+    const Pending& c = pending[contact];
+    const Vec3& n = c.normal;
+    // Baza styczna z normalnej (deterministyczna, więc impulsy tarcia z cache pasują do tych samych osi)
+    Vec3 t1 = std::abs(n.x) > 0.57f ? Vec3(n.y, -n.x, 0.0f) : Vec3(0.0f, n.z, -n.y);
+    float len = std::sqrt(t1.x * t1.x + t1.y * t1.y + t1.z * t1.z);
+    t1 = Vec3(t1.x / len, t1.y / len, t1.z / len);
+    Vec3 t2(n.y * t1.z - n.z * t1.y, n.z * t1.x - n.x * t1.z, n.x * t1.y - n.y * t1.x);
+
+    batch.nx[lane] = n.x;   batch.ny[lane] = n.y;   batch.nz[lane] = n.z;
+    batch.t1x[lane] = t1.x; batch.t1y[lane] = t1.y; batch.t1z[lane] = t1.z;
+    batch.t2x[lane] = t2.x; batch.t2y[lane] = t2.y; batch.t2z[lane] = t2.z;
+    batch.imAx[lane] = imx[c.a]; batch.imAy[lane] = imy[c.a]; batch.imAz[lane] = imz[c.a];
+    batch.imBx[lane] = imx[c.b]; batch.imBy[lane] = imy[c.b]; batch.imBz[lane] = imz[c.b];
+    auto effectiveMass = [&](const Vec3& d) {
+        float k = d.x * d.x * (imx[c.a] + imx[c.b]) + d.y * d.y * (imy[c.a] + imy[c.b]) + d.z * d.z * (imz[c.a] + imz[c.b]);
+        return k > 0.0f ? 1.0f / k : 0.0f;
+    };
+    batch.normalMass[lane] = effectiveMass(n);
+    batch.tangentMass1[lane] = effectiveMass(t1);
+    batch.tangentMass2[lane] = effectiveMass(t2);
+    // Kontakt spekulatywny (szczelina > 0): pozwala zbliżyć się najwyżej o szczelinę w tym kroku
+    batch.bias[lane] = c.separation > 0.0f ? c.separation / c.dt : -BAUMGARTE * std::max(-c.separation - SLOP, 0.0f) / c.dt;
+
+    batch.jn[lane] = batch.jt1[lane] = batch.jt2[lane] = 0.0f;
+    const Cached* cached = findCached(c.key);
+    if (cached && cached->normal.x * n.x + cached->normal.y * n.y + cached->normal.z * n.z > 0.95f) {
+        const float scale = c.dt / cached->dt; // impuls rośnie z krokiem (grawitacja, docisk)
+        batch.jn[lane] = cached->jn * scale; batch.jt1[lane] = cached->jt1 * scale; batch.jt2[lane] = cached->jt2 * scale;
+    }
+    batch.a[lane] = c.a; batch.b[lane] = c.b;
+    batch.contact[lane] = contact;
+}
+
+// Puste lany = kontakt slotu statycznego z samym sobą: zerowa masa, więc impuls zawsze 0
+void ContactSolver::padLanes(Batch& batch, int used, int staticSlot) {
+    for (int l = used; l < LANES; ++l) {
+        batch.nx[l] = 0.0f; batch.ny[l] = 1.0f; batch.nz[l] = 0.0f;
+        batch.t1x[l] = 1.0f; batch.t1y[l] = 0.0f; batch.t1z[l] = 0.0f;
+        batch.t2x[l] = 0.0f; batch.t2y[l] = 0.0f; batch.t2z[l] = 1.0f;
+        batch.imAx[l] = batch.imAy[l] = batch.imAz[l] = batch.imBx[l] = batch.imBy[l] = batch.imBz[l] = 0.0f;
+        batch.normalMass[l] = batch.tangentMass1[l] = batch.tangentMass2[l] = batch.bias[l] = 0.0f;
+        batch.jn[l] = batch.jt1[l] = batch.jt2[l] = 0.0f;
+        batch.a[l] = batch.b[l] = staticSlot;
+        batch.contact[l] = -1;
+    }
+}
+
+// Zachłanne kolorowanie: kontakt trafia do pierwszej otwartej paczki bez wspólnego ciała dynamicznego.
+// Slot statyczny może się powtarzać - nigdy nie zmienia prędkości.
+void ContactSolver::endIsland() {
+    Island& island = islands.back();
+    struct Open { Batch batch; int used; };
+    std::vector<Open> open;
+    auto emit = [&](size_t i) {
+        padLanes(open[i].batch, open[i].used, island.staticSlot);
+        batches.push_back(open[i].batch);
+        open.erase(open.begin() + i);
+    };
+    for (size_t c = islandContactBegin; c < pending.size(); ++c) {
+        int a = pending[c].a, b = pending[c].b;
+        size_t target = open.size();
+        for (size_t i = 0; i < open.size() && target == open.size(); ++i) {
+            bool conflict = false;
+            for (int l = 0; l < open[i].used && !conflict; ++l) {
+                const Batch& bt = open[i].batch;
+                conflict = bt.a[l] == a || bt.b[l] == a || (b != island.staticSlot && (bt.a[l] == b || bt.b[l] == b));
+            }
+            if (!conflict) target = i;
+        }
+        if (target == open.size()) {
+            if ((int)open.size() == OPEN_BATCHES) { emit(0); target = open.size(); }
+            open.push_back(Open());
+            open.back().used = 0;
+        }
+        Open& o = open[target];
+        fillLane(o.batch, o.used++, (int)c);
+        if (o.used == LANES) emit(target);
+    }
+    while (!open.empty()) emit(0);
+    island.batchEnd = (int)batches.size();
+}
+
+// ==========================================
+// ROZWIĄZYWANIE
+// ==========================================
+void ContactSolver::warmStart(const Batch& bt) {
+    for (int l = 0; l < LANES; ++l) {
+        float Px = bt.nx[l] * bt.jn[l] + bt.t1x[l] * bt.jt1[l] + bt.t2x[l] * bt.jt2[l];
+        float Py = bt.ny[l] * bt.jn[l] + bt.t1y[l] * bt.jt1[l] + bt.t2y[l] * bt.jt2[l];
+        float Pz = bt.nz[l] * bt.jn[l] + bt.t1z[l] * bt.jt1[l] + bt.t2z[l] * bt.jt2[l];
+        int a = bt.a[l], b = bt.b[l];
+        vx[a] -= bt.imAx[l] * Px; vy[a] -= bt.imAy[l] * Py; vz[a] -= bt.imAz[l] * Pz;
+        vx[b] += bt.imBx[l] * Px; vy[b] += bt.imBy[l] * Py; vz[b] += bt.imBz[l] * Pz;
+    }
+}
+
+void ContactSolver::solveBatch(Batch& bt) {
+    const int* A = bt.a;
+    const int* B = bt.b;
+#ifdef DUCKY_SSE
+    auto gather = [](const std::vector<float>& v, const int* idx) { return _mm_setr_ps(v[idx[0]], v[idx[1]], v[idx[2]], v[idx[3]]); };
+    auto scatter = [](std::vector<float>& v, const int* idx, __m128 value) {
+        alignas(16) float tmp[LANES];
+        _mm_store_ps(tmp, value);
+        for (int l = 0; l < LANES; ++l) v[idx[l]] = tmp[l];
+    };
+    __m128 vax = gather(vx, A), vay = gather(vy, A), vaz = gather(vz, A);
+    __m128 vbx = gather(vx, B), vby = gather(vy, B), vbz = gather(vz, B);
+    const __m128 imAx = _mm_load_ps(bt.imAx), imAy = _mm_load_ps(bt.imAy), imAz = _mm_load_ps(bt.imAz);
+    const __m128 imBx = _mm_load_ps(bt.imBx), imBy = _mm_load_ps(bt.imBy), imBz = _mm_load_ps(bt.imBz);
+    const __m128 zero = _mm_setzero_ps();
+
+    // Jeden wiersz: lambda = -masa * (dv + bias), obcięcie sumy do [lo, hi], impuls na oba ciała
+    auto row = [&](const float* dx, const float* dy, const float* dz, const float* mass, __m128 bias, float* accumulated, __m128 lo, __m128 hi) {
+        __m128 x = _mm_load_ps(dx), y = _mm_load_ps(dy), z = _mm_load_ps(dz);
+        __m128 dv = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(vbx, vax), x), _mm_mul_ps(_mm_sub_ps(vby, vay), y)), _mm_mul_ps(_mm_sub_ps(vbz, vaz), z));
+        __m128 lambda = _mm_mul_ps(_mm_sub_ps(zero, _mm_load_ps(mass)), _mm_add_ps(dv, bias));
+        __m128 old = _mm_load_ps(accumulated);
+        __m128 sum = _mm_min_ps(_mm_max_ps(_mm_add_ps(old, lambda), lo), hi);
+        _mm_store_ps(accumulated, sum);
+        lambda = _mm_sub_ps(sum, old);
+        __m128 px = _mm_mul_ps(x, lambda), py = _mm_mul_ps(y, lambda), pz = _mm_mul_ps(z, lambda);
+        vax = _mm_sub_ps(vax, _mm_mul_ps(imAx, px)); vay = _mm_sub_ps(vay, _mm_mul_ps(imAy, py)); vaz = _mm_sub_ps(vaz, _mm_mul_ps(imAz, pz));
+        vbx = _mm_add_ps(vbx, _mm_mul_ps(imBx, px)); vby = _mm_add_ps(vby, _mm_mul_ps(imBy, py)); vbz = _mm_add_ps(vbz, _mm_mul_ps(imBz, pz));
+    };
+    // Tarcie najpierw (limit z impulsu normalnego poprzedniej iteracji), potem kontakt bez przenikania
+    __m128 maxFriction = _mm_mul_ps(_mm_set1_ps(friction), _mm_load_ps(bt.jn));
+    __m128 minFriction = _mm_sub_ps(zero, maxFriction);
+    row(bt.t1x, bt.t1y, bt.t1z, bt.tangentMass1, zero, bt.jt1, minFriction, maxFriction);
+    row(bt.t2x, bt.t2y, bt.t2z, bt.tangentMass2, zero, bt.jt2, minFriction, maxFriction);
+    row(bt.nx, bt.ny, bt.nz, bt.normalMass, _mm_load_ps(bt.bias), bt.jn, zero, _mm_set1_ps(1e30f));
+
+    scatter(vx, A, vax); scatter(vy, A, vay); scatter(vz, A, vaz);
+    scatter(vx, B, vbx); scatter(vy, B, vby); scatter(vz, B, vbz);
+#else
+    for (int l = 0; l < LANES; ++l) {
+        int a = A[l], b = B[l];
+        auto row = [&](float dx, float dy, float dz, float mass, float bias, float& accumulated, float lo, float hi) {
+            float dv = (vx[b] - vx[a]) * dx + (vy[b] - vy[a]) * dy + (vz[b] - vz[a]) * dz;
+            float lambda = -mass * (dv + bias);
+            float old = accumulated;
+            accumulated = std::min(std::max(old + lambda, lo), hi);
+            lambda = accumulated - old;
+            vx[a] -= bt.imAx[l] * dx * lambda; vy[a] -= bt.imAy[l] * dy * lambda; vz[a] -= bt.imAz[l] * dz * lambda;
+            vx[b] += bt.imBx[l] * dx * lambda; vy[b] += bt.imBy[l] * dy * lambda; vz[b] += bt.imBz[l] * dz * lambda;
+        };
+        float maxFriction = friction * bt.jn[l];
+        row(bt.t1x[l], bt.t1y[l], bt.t1z[l], bt.tangentMass1[l], 0.0f, bt.jt1[l], -maxFriction, maxFriction);
+        row(bt.t2x[l], bt.t2y[l], bt.t2z[l], bt.tangentMass2[l], 0.0f, bt.jt2[l], -maxFriction, maxFriction);
+        row(bt.nx[l], bt.ny[l], bt.nz[l], bt.normalMass[l], bt.bias[l], bt.jn[l], 0.0f, 1e30f);
+    }
+#endif
+}
+
+void ContactSolver::solve(JobSystem& jobs) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Wyspy są niezależne - małe sklejamy w zadania, duża wyspa to jedno zadanie
+    std::vector<size_t> taskStart(1, 0);
+    int taskBatches = 0;
+    for (size_t i = 0; i < islands.size(); ++i) {
+        taskBatches += islands[i].batchEnd - islands[i].batchBegin;
+        if (taskBatches >= TASK_BATCHES) { taskStart.push_back(i + 1); taskBatches = 0; }
+    }
+    if (taskStart.back() != islands.size()) taskStart.push_back(islands.size());
+
+    jobs.parallelFor(taskStart.size() - 1, 1, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t)
+            for (size_t i = taskStart[t]; i < taskStart[t + 1]; ++i) {
+                const Island& island = islands[i];
+                for (int b = island.batchBegin; b < island.batchEnd; ++b) warmStart(batches[b]);
+                for (int it = 0; it < iterations; ++it)
+                    for (int b = island.batchBegin; b < island.batchEnd; ++b) solveBatch(batches[b]);
+            }
+    });
+
+    // Impulsy do rozgrzania następnego kroku (+ młode wpisy kontaktów, których w tym kroku nie było)
+    size_t kept = 0;
+    if (cacheSteps > 1)
+        for (const Cached& c : cache) if (c.key != EMPTY_KEY && c.age + 1 < cacheSteps) kept++;
+    size_t capacity = 16;
+    while (capacity < (pending.size() + kept) * 2) capacity *= 2;
+    nextCache.assign(capacity, Cached());
+    const size_t mask = capacity - 1;
+    for (const Batch& bt : batches)
+        for (int l = 0; l < LANES; ++l) {
+            if (bt.contact[l] < 0) continue;
+            const Pending& c = pending[bt.contact[l]];
+            size_t i = slotOf(c.key, mask);
+            while (nextCache[i].key != EMPTY_KEY && nextCache[i].key != c.key) i = (i + 1) & mask;
+            nextCache[i] = {c.key, c.normal, bt.jn[l], bt.jt1[l], bt.jt2[l], c.dt, 0};
+        }
+    if (kept > 0)
+        for (const Cached& c : cache) {
+            if (c.key == EMPTY_KEY || c.age + 1 >= cacheSteps) continue;
+            size_t i = slotOf(c.key, mask);
+            while (nextCache[i].key != EMPTY_KEY && nextCache[i].key != c.key) i = (i + 1) & mask;
+            if (nextCache[i].key == EMPTY_KEY) { nextCache[i] = c; nextCache[i].age++; }
+        }
+    cache.swap(nextCache);
+    contactCount = pending.size();
+    lastSolveMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../math/Vec3.hpp"
+
+class JobSystem;
+
+// --- SOLVER KONTAKTÓW (SEQUENTIAL IMPULSE) ---
+// Wyspa = ciągły zakres ciał solvera + własny slot statyczny (prędkość 0, masa nieskończona), do którego
+// trafiają kontakty z podłogą, ścianami i ciałami śpiącymi. Wyspy nie dzielą żadnego zapisywanego slotu,
+// więc są liczone równolegle na workerach. Kontakty wyspy są pakowane po 4 w paczki o rozłącznych ciałach
+// i liczone jednocześnie w lanach SSE (Gauss-Seidel między paczkami, w paczce nie ma konfliktów).
+// Impulsy z poprzedniego kroku (klucz = para encji) rozgrzewają solver - stosy nie drżą i szybciej się zbiegają.
+// Krok czasu jest per kontakt: ciała z LOD symulacji w jednym kroku mogą nadrabiać różne odcinki czasu.
+// Ich kontakty nie pojawiają się w każdym kroku, więc impuls w cache żyje `cacheSteps` kroków i jest
+// skalowany stosunkiem kroków czasu przy rozgrzewaniu.
+class ContactSolver {
+public:
+    static constexpr int LANES = 4;
+
+    void begin();                                         // nowy krok - czyści ciała, wyspy i kontakty
+    int beginIsland();                                    // zwraca slot statyczny wyspy
+    int addBody(const Vec3& velocity, const Vec3& invMass); // masa odwrotna per oś (0 = oś zablokowana)
+    void addContact(int a, int b, const Vec3& normal, float separation, float dt, uint64_t key); // normalna od a do b
+    void endIsland();
+
+    void solve(JobSystem& jobs);
+    void reset() { cache.clear(); nextCache.clear(); } // zapomina impulsy z poprzednich kroków
+    Vec3 getVelocity(int slot) const { return Vec3(vx[slot], vy[slot], vz[slot]); }
+
+    size_t getIslandCount() const { return islands.size(); }
+    size_t getContactCount() const { return contactCount; }
+    float getLastSolveMs() const { return lastSolveMs; }
+
+    int iterations = 8;
+    float friction = 0.5f;
+    int cacheSteps = 1; // ile kroków impuls nieodświeżonego kontaktu zostaje w cache
+
+private:
+    struct alignas(16) Batch {
+        float nx[LANES], ny[LANES], nz[LANES];
+        float t1x[LANES], t1y[LANES], t1z[LANES];
+        float t2x[LANES], t2y[LANES], t2z[LANES];
+        float imAx[LANES], imAy[LANES], imAz[LANES];
+        float imBx[LANES], imBy[LANES], imBz[LANES];
+        float normalMass[LANES], tangentMass1[LANES], tangentMass2[LANES], bias[LANES];
+        float jn[LANES], jt1[LANES], jt2[LANES]; // impulsy skumulowane
+        int a[LANES], b[LANES];
+        int contact[LANES];                      // indeks w `pending`, -1 = pusta lana
+    };
+    struct Pending { int a, b; Vec3 normal; float separation, dt; uint64_t key; };
+    struct Island { int staticSlot; int batchBegin, batchEnd; };
+    // Cache impulsów: płaska tablica z adresowaniem otwartym (klucz EMPTY_KEY = wolne miejsce), przebudowywana co krok
+    static constexpr uint64_t EMPTY_KEY = ~0ull;
+    struct Cached { uint64_t key = EMPTY_KEY; Vec3 normal; float jn = 0.0f, jt1 = 0.0f, jt2 = 0.0f, dt = 0.0f; int age = 0; };
+    static size_t slotOf(uint64_t key, size_t mask) { return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask; }
+    const Cached* findCached(uint64_t key) const;
+
+    void fillLane(Batch& batch, int lane, int contact);
+    void padLanes(Batch& batch, int used, int staticSlot);
+    void warmStart(const Batch& batch);
+    void solveBatch(Batch& batch);
+
+    // SoA ciał solvera
+    std::vector<float> vx, vy, vz;
+    std::vector<float> imx, imy, imz;
+
+    std::vector<Pending> pending;  // kontakty bieżącego kroku
+    std::vector<Batch> batches;
+    std::vector<Island> islands;
+    size_t islandContactBegin = 0;
+
+    std::vector<Cached> cache, nextCache; // rozmiar = potęga dwójki
+    size_t contactCount = 0;
+    float lastSolveMs = 0.0f;
+};
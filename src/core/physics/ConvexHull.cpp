@@ -0,0 +1,259 @@
+#include "ConvexHull.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include "../math/Simd.hpp"
+
+static const float MIN_THICKNESS = 0.01f; // względem rozmiaru siatki - płaski model dostaje tyle grubości
+static const float PLANE_MERGE = 1e-4f;   // ściany prawie współpłaszczyznowe = jedna płaszczyzna do raycastów
+static const float WELD = 1e-4f;          // względem rozmiaru siatki - bliższe punkty są jednym (szwy UV, bieguny sfer)
+
+int ConvexHull::support(const Vec3& d) const {
+    int best = 0;
+    float bestDot = -FLT_MAX;
+    size_t i = 0;
+#ifdef DUCKY_SSE
+    const __m128 dx = _mm_set1_ps(d.x), dy = _mm_set1_ps(d.y), dz = _mm_set1_ps(d.z);
+    __m128 bestV = _mm_set1_ps(-FLT_MAX);
+    __m128i bestI = _mm_setzero_si128(), index = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i four = _mm_set1_epi32(4);
+    for (; i + 4 <= x.size(); i += 4) {
+        __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&x[i]), dx), _mm_mul_ps(_mm_loadu_ps(&y[i]), dy)), _mm_mul_ps(_mm_loadu_ps(&z[i]), dz));
+        __m128i greater = _mm_castps_si128(_mm_cmpgt_ps(v, bestV));
+        bestV = _mm_max_ps(v, bestV);
+        bestI = _mm_or_si128(_mm_and_si128(greater, index), _mm_andnot_si128(greater, bestI));
+        index = _mm_add_epi32(index, four);
+    }
+    alignas(16) float lanes[4];
+    alignas(16) int lanesI[4];
+    _mm_store_ps(lanes, bestV);
+    _mm_store_si128((__m128i*)lanesI, bestI);
+    for (int l = 0; l < 4; ++l)
+        if (lanes[l] > bestDot) { bestDot = lanes[l]; best = lanesI[l]; }
+#endif
+    for (; i < (size_t)vertexCount; ++i) {
+        float v = x[i] * d.x + y[i] * d.y + z[i] * d.z;
+        if (v > bestDot) { bestDot = v; best = (int)i; }
+    }
+    return best;
+}
+
+// ==========================================
+// QUICKHULL
+// ==========================================
+namespace {
+struct Face {
+    int v[3];
+    Vec3 normal;
+    float offset;
+    std::vector<int> outside; // punkty nad ścianą, jeszcze nie w otoczce
+    int farthest = -1;
+    float farthestDistance = 0.0f;
+    bool alive = true;
+};
+}
+
+static Face makeFace(const std::vector<Vec3>& p, int a, int b, int c) {
+    Face f;
+    f.v[0] = a; f.v[1] = b; f.v[2] = c;
+    f.normal = (p[b] - p[a]).cross(p[c] - p[a]).normalize();
+    f.offset = f.normal.dot(p[a]);
+    return f;
+}
+
+static void addOutside(Face& f, int point, float distance) {
+    f.outside.push_back(point);
+    if (distance > f.farthestDistance) { f.farthestDistance = distance; f.farthest = point; }
+}
+
+// Punkt trafia do ściany, nad którą jest najwyżej (albo przepada, jeśli jest pod wszystkimi)
+static void assign(std::vector<Face>& faces, const std::vector<Vec3>& p, int point, float eps) {
+    int best = -1;
+    float bestDistance = eps;
+    for (size_t i = 0; i < faces.size(); ++i) {
+        if (!faces[i].alive) continue;
+        float d = faces[i].normal.dot(p[point]) - faces[i].offset;
+        if (d > bestDistance) { bestDistance = d; best = (int)i; }
+    }
+    if (best >= 0) addOutside(faces[best], point, bestDistance);
+}
+
+static void finish(const std::vector<Vec3>& p, const std::vector<Face>& faces, float eps, ConvexHull& out) {
+    std::vector<int> remap(p.size(), -1);
+    std::vector<Vec3> used;
+    for (const Face& f : faces) {
+        if (!f.alive) continue;
+        for (int k = 0; k < 3; ++k)
+            if (remap[f.v[k]] < 0) { remap[f.v[k]] = (int)used.size(); used.push_back(p[f.v[k]]); }
+        bool merged = false;
+        for (const ConvexHull::Plane& q : out.planes)
+            if (q.normal.dot(f.normal) > 1.0f - PLANE_MERGE && std::abs(q.offset - f.offset) <= eps) { merged = true; break; }
+        if (!merged) out.planes.push_back({ f.normal, f.offset });
+    }
+    out.vertexCount = (int)used.size();
+    size_t padded = (used.size() + 3) & ~(size_t)3;
+    out.x.resize(padded); out.y.resize(padded); out.z.resize(padded);
+    for (size_t i = 0; i < padded; ++i) {
+        const Vec3& v = used[std::min(i, used.size() - 1)];
+        out.x[i] = v.x; out.y[i] = v.y; out.z[i] = v.z;
+        out.extent = Vec3(std::max(out.extent.x, std::abs(v.x)), std::max(out.extent.y, std::abs(v.y)), std::max(out.extent.z, std::abs(v.z)));
+    }
+}
+
+// Płaska / liniowa siatka: pudełko otaczające, pogrubione tam, gdzie nie ma grubości
+static void boxHull(Vec3 lo, Vec3 hi, float size, ConvexHull& out) {
+    const float t = MIN_THICKNESS * size * 0.5f;
+    if (hi.x - lo.x < 2.0f * t) { float c = (lo.x + hi.x) * 0.5f; lo.x = c - t; hi.x = c + t; }
+    if (hi.y - lo.y < 2.0f * t) { float c = (lo.y + hi.y) * 0.5f; lo.y = c - t; hi.y = c + t; }
+    if (hi.z - lo.z < 2.0f * t) { float c = (lo.z + hi.z) * 0.5f; lo.z = c - t; hi.z = c + t; }
+    std::vector<Vec3> corners;
+    for (int i = 0; i < 8; ++i) corners.push_back(Vec3((i & 1) ? hi.x : lo.x, (i & 2) ? hi.y : lo.y, (i & 4) ? hi.z : lo.z));
+    // 6 ścian po 2 trójkąty (obieg wierzchołków wokół ściany), normalne odwrócone na zewnątrz
+    static const int quads[6][4] = { {0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4}, {2, 6, 7, 3}, {0, 2, 3, 1}, {4, 5, 7, 6} };
+    const Vec3 center = (lo + hi) * 0.5f;
+    std::vector<Face> faces;
+    for (const auto& q : quads)
+        for (int t = 0; t < 2; ++t) {
+            Face f = makeFace(corners, q[0], q[t + 1], q[t + 2]);
+            if (f.normal.dot(center) > f.offset) f = makeFace(corners, q[0], q[t + 2], q[t + 1]);
+            faces.push_back(f);
+        }
+    finish(corners, faces, 1e-6f * size, out);
+}
+
+bool buildConvexHull(const float* vertices, size_t count, size_t stride, int maxVertices, ConvexHull& out) {
+    out = ConvexHull();
+    if (count == 0) return false;
+
+    std::vector<Vec3> p(count);
+    for (size_t i = 0; i < count; ++i) p[i] = Vec3(vertices[i * stride], vertices[i * stride + 1], vertices[i * stride + 2]);
+    Vec3 lo = p[0], hi = p[0];
+    for (const Vec3& v : p) {
+        lo = Vec3(std::min(lo.x, v.x), std::min(lo.y, v.y), std::min(lo.z, v.z));
+        hi = Vec3(std::max(hi.x, v.x), std::max(hi.y, v.y), std::max(hi.z, v.z));
+    }
+    const float size = std::max(1e-6f, std::max(hi.x - lo.x, std::max(hi.y - lo.y, hi.z - lo.z)));
+    const float eps = 1e-5f * size;
+    maxVertices = std::max(maxVertices, 4);
+
+    // Dane renderera powtarzają wierzchołek dla każdego trójkąta, a prawie pokrywające się punkty dają ściany-drzazgi
+    // o niepewnych normalnych - zostaje jeden punkt na komórkę siatki WELD
+    const float cell = 1.0f / (WELD * size);
+    struct Welded { long long x, y, z; Vec3 p; };
+    std::vector<Welded> grid(count);
+    for (size_t i = 0; i < count; ++i)
+        grid[i] = { std::llround((p[i].x - lo.x) * cell), std::llround((p[i].y - lo.y) * cell), std::llround((p[i].z - lo.z) * cell), p[i] };
+    auto less = [](const Welded& a, const Welded& b) { return a.x != b.x ? a.x < b.x : a.y != b.y ? a.y < b.y : a.z < b.z; };
+    auto same = [](const Welded& a, const Welded& b) { return a.x == b.x && a.y == b.y && a.z == b.z; };
+    std::sort(grid.begin(), grid.end(), less);
+    grid.erase(std::unique(grid.begin(), grid.end(), same), grid.end());
+    p.resize(grid.size());
+    for (size_t i = 0; i < grid.size(); ++i) p[i] = grid[i].p;
+
+    int extreme[6] = { 0, 0, 0, 0, 0, 0 }; // min x, max x, min y, ...
+    for (int i = 0; i < (int)p.size(); ++i) {
+        if (p[i].x < p[extreme[0]].x) extreme[0] = i;
+        if (p[i].x > p[extreme[1]].x) extreme[1] = i;
+        if (p[i].y < p[extreme[2]].y) extreme[2] = i;
+        if (p[i].y > p[extreme[3]].y) extreme[3] = i;
+        if (p[i].z < p[extreme[4]].z) extreme[4] = i;
+        if (p[i].z > p[extreme[5]].z) extreme[5] = i;
+    }
+
+    // 1. Czworościan startowy: najdłuższa para skrajnych punktów, najdalszy od prostej, najdalszy od płaszczyzny
+    int a = extreme[0], b = extreme[1];
+    for (int i = 0; i < 6; i += 2)
+        if ((p[extreme[i + 1]] - p[extreme[i]]).length() > (p[b] - p[a]).length()) { a = extreme[i]; b = extreme[i + 1]; }
+    const Vec3 ab = (p[b] - p[a]).normalize();
+    int c = -1;
+    float best = eps;
+    for (int i = 0; i < (int)p.size(); ++i) {
+        float d = (p[i] - p[a]).cross(ab).length();
+        if (d > best) { best = d; c = i; }
+    }
+    if (c < 0) { boxHull(lo, hi, size, out); return true; }
+    const Vec3 n = (p[b] - p[a]).cross(p[c] - p[a]).normalize();
+    int d = -1;
+    best = eps;
+    for (int i = 0; i < (int)p.size(); ++i) {
+        float h = std::abs(n.dot(p[i] - p[a]));
+        if (h > best) { best = h; d = i; }
+    }
+    if (d < 0) { boxHull(lo, hi, size, out); return true; }
+
+    // Krawędź skierowana (u, v) -> ściana, która ją ma; sąsiad przez krawędź = właściciel (v, u)
+    std::vector<Face> faces;
+    std::unordered_map<uint64_t, int> edgeFace;
+    auto edgeKey = [](int u, int v) { return ((uint64_t)(uint32_t)u << 32) | (uint32_t)v; };
+    auto addFace = [&](int i, int j, int k) {
+        faces.push_back(makeFace(p, i, j, k));
+        const int f = (int)faces.size() - 1;
+        edgeFace[edgeKey(i, j)] = f; edgeFace[edgeKey(j, k)] = f; edgeFace[edgeKey(k, i)] = f;
+    };
+    if (n.dot(p[d] - p[a]) > 0.0f) std::swap(b, c); // normalne na zewnątrz: d musi być pod ścianą (a, b, c)
+    addFace(a, b, c);
+    addFace(a, d, b);
+    addFace(b, d, c);
+    addFace(c, d, a);
+    for (int i = 0; i < (int)p.size(); ++i)
+        if (i != a && i != b && i != c && i != d) assign(faces, p, i, eps);
+
+    // 2. Dokładanie najdalszego punktu: ściany widoczne z niego znikają, horyzont łączy się z nowym wierzchołkiem
+    int hullVertices = 4;
+    std::vector<int> visible, orphans, stack;
+    std::vector<std::pair<int, int>> horizon;
+    std::vector<uint8_t> seen;
+    for (;;) {
+        int top = -1;
+        for (int i = 0; i < (int)faces.size(); ++i)
+            if (faces[i].alive && faces[i].farthest >= 0 && (top < 0 || faces[i].farthestDistance > faces[top].farthestDistance)) top = i;
+        if (top < 0) break;
+        if (hullVertices >= maxVertices) { out.error = faces[top].farthestDistance; break; }
+        const int eye = faces[top].farthest;
+
+        // Widoczne ściany = spójny obszar od `top`, bez tolerancji (ściana, nad którą `eye` jest choćby minimalnie,
+        // też znika - inaczej nowa ściana obok prawie współpłaszczyznowej tworzy wklęsłe zagięcie).
+        // Krawędź do niewidocznego sąsiada należy do horyzontu.
+        visible.assign(1, top);
+        horizon.clear();
+        seen.assign(faces.size(), 0);
+        seen[top] = 1;
+        stack.assign(1, top);
+        while (!stack.empty()) {
+            const int f = stack.back();
+            stack.pop_back();
+            for (int k = 0; k < 3; ++k) {
+                const int u = faces[f].v[k], v = faces[f].v[(k + 1) % 3];
+                const int nb = edgeFace[edgeKey(v, u)];
+                if (seen[nb] == 1) continue;
+                if (seen[nb] == 0 && faces[nb].normal.dot(p[eye]) - faces[nb].offset > 0.0f) {
+                    seen[nb] = 1;
+                    visible.push_back(nb);
+                    stack.push_back(nb);
+                } else {
+                    seen[nb] = 2;
+                    horizon.push_back({ u, v });
+                }
+            }
+        }
+        orphans.clear();
+        for (int f : visible) {
+            faces[f].alive = false;
+            for (int q : faces[f].outside) if (q != eye) orphans.push_back(q);
+            std::vector<int>().swap(faces[f].outside);
+            for (int k = 0; k < 3; ++k) {
+                auto it = edgeFace.find(edgeKey(faces[f].v[k], faces[f].v[(k + 1) % 3]));
+                if (it != edgeFace.end() && it->second == f) edgeFace.erase(it);
+            }
+        }
+        for (const auto& e : horizon) addFace(e.first, e.second, eye);
+        // Sierota może leżeć nad nową ścianą albo nad starą, niewidoczną z `eye` - sprawdzamy wszystkie
+        for (int q : orphans) assign(faces, p, q, eps);
+        hullVertices++;
+    }
+
+    finish(p, faces, eps, out);
+    return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "../math/Vec3.hpp"
+
+// --- OTOCZKA WYPUKŁA (collider modelu) ---
+// Wierzchołki w przestrzeni modelu jako SoA dopełnione do wielokrotności 4 (support liczony po 4 naraz SSE)
+// i płaszczyzny ścian do raycastów. Budowana raz przy imporcie modelu, współdzielona przez wszystkie jego instancje.
+struct ConvexHull {
+    struct Plane { Vec3 normal; float offset; }; // wewnątrz: normal · p <= offset
+
+    std::vector<float> x, y, z;
+    int vertexCount = 0;
+    std::vector<Plane> planes;
+    Vec3 extent;        // największe |x|, |y|, |z| - połówki pudełka wokół początku układu modelu
+    float error = 0.0f; // o ile najdalszy pominięty (przez budżet) wierzchołek siatki wystaje poza otoczkę
+
+    Vec3 vertex(int i) const { return Vec3(x[i], y[i], z[i]); }
+    int support(const Vec3& direction) const; // indeks wierzchołka najdalej w danym kierunku
+};
+
+// Quickhull z budżetem wierzchołków: zawsze dokładany jest najdalszy punkt spoza otoczki, więc po `maxVertices`
+// zostaje najlepsze przybliżenie tej wielkości (kanciaste rekwizyty mieszczą się w budżecie dokładnie, kula
+// z 64 wierzchołków odstaje o ~5% promienia). Otoczka leży wewnątrz siatki - błąd w `error`.
+// `stride` w floatach (dane z decodeModel: 8). Płaska albo zdegenerowana siatka dostaje cienkie pudełko.
+bool buildConvexHull(const float* vertices, size_t count, size_t stride, int maxVertices, ConvexHull& out);
@@ -0,0 +1,320 @@
+#include "Gjk.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+static const int GJK_ITERATIONS = 32;
+static const float GJK_TOLERANCE = 1e-5f;   // względna poprawa |v|^2, poniżej której GJK uznaje odległość za końcową
+static const float GJK_TOUCH = 1e-12f;      // |v|^2 - początek na simpleksie = styk, liczymy EPA
+static const int EPA_ITERATIONS = 32;
+static const float EPA_TOLERANCE = 1e-4f;   // m - nowy wierzchołek tak blisko ściany = ściana jest brzegiem
+static const float DEGENERATE = 1e-5f;      // m - przy rozdmuchiwaniu simpleksu do czworościanu
+static const int EPA_MAX_VERTICES = 64;
+static const int EPA_MAX_FACES = 128;
+
+Vec3 ConvexShape::vertex(int i) const {
+    Vec3 l = hull ? hull->vertex(i) : Vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+    return frame.center + frame.axis[0] * (l.x * frame.half.x) + frame.axis[1] * (l.y * frame.half.y) + frame.axis[2] * (l.z * frame.half.z);
+}
+
+int ConvexShape::support(const Vec3& d) const {
+    Vec3 l(d.dot(frame.axis[0]) * frame.half.x, d.dot(frame.axis[1]) * frame.half.y, d.dot(frame.axis[2]) * frame.half.z);
+    if (hull) return hull->support(l);
+    return (l.x > 0.0f ? 1 : 0) | (l.y > 0.0f ? 2 : 0) | (l.z > 0.0f ? 4 : 0);
+}
+
+// ==========================================
+// GJK
+// ==========================================
+namespace {
+// Wierzchołki różnicy Minkowskiego a - b razem z indeksami, z których powstały
+struct Simplex {
+    Vec3 w[4];
+    int a[4], b[4];
+    int count = 0;
+};
+
+// Najbliższy początkowi punkt cechy simpleksu i wierzchołki, które ją tworzą
+struct Feature {
+    Vec3 v;
+    int n;
+    int id[3];
+};
+
+struct Minkowski {
+    const ConvexShape& a;
+    const ConvexShape& b;
+
+    void push(Simplex& s, const Vec3& d) const {
+        int ia = a.support(d), ib = b.support(d * -1.0f);
+        s.w[s.count] = a.vertex(ia) - b.vertex(ib);
+        s.a[s.count] = ia; s.b[s.count] = ib;
+        s.count++;
+    }
+};
+}
+
+static Feature onSegment(const Vec3* w, int i, int j) {
+    const Vec3 ab = w[j] - w[i];
+    const float t = -w[i].dot(ab), len2 = ab.dot(ab);
+    if (t <= 0.0f || len2 <= 0.0f) return { w[i], 1, { i } };
+    if (t >= len2) return { w[j], 1, { j } };
+    return { w[i] + ab * (t / len2), 2, { i, j } };
+}
+
+// Obszary Voronoia trójkąta (Ericson, Real-Time Collision Detection 5.1.5) dla punktu w początku układu
+static Feature onTriangle(const Vec3* w, int i, int j, int k) {
+    const Vec3 &a = w[i], &b = w[j], &c = w[k];
+    const Vec3 ab = b - a, ac = c - a;
+    const float d1 = -ab.dot(a), d2 = -ac.dot(a);
+    if (d1 <= 0.0f && d2 <= 0.0f) return { a, 1, { i } };
+    const float d3 = -ab.dot(b), d4 = -ac.dot(b);
+    if (d3 >= 0.0f && d4 <= d3) return { b, 1, { j } };
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return { a + ab * (d1 / (d1 - d3)), 2, { i, j } };
+    const float d5 = -ab.dot(c), d6 = -ac.dot(c);
+    if (d6 >= 0.0f && d5 <= d6) return { c, 1, { k } };
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return { a + ac * (d2 / (d2 - d6)), 2, { i, k } };
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return { b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))), 2, { j, k } };
+    const float denom = va + vb + vc;
+    if (denom <= 0.0f) return onSegment(w, i, j); // trójkąt zdegenerowany
+    return { a + ab * (vb / denom) + ac * (vc / denom), 3, { i, j, k } };
+}
+
+// Najbliższy punkt simpleksu i simpleks zredukowany do tworzącej go cechy. true = początek w czworościanie.
+static bool reduce(Simplex& s, Vec3& v) {
+    Feature f = { s.w[0], 1, { 0 } }; // count == 1 albo czworościan z samymi zdegenerowanymi ścianami
+    if (s.count == 2) f = onSegment(s.w, 0, 1);
+    else if (s.count == 3) f = onTriangle(s.w, 0, 1, 2);
+    else if (s.count == 4) {
+        static const int faces[4][4] = { {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 3, 1}, {1, 2, 3, 0} }; // 3 wierzchołki + przeciwległy
+        float best = FLT_MAX;
+        bool outside = false;
+        for (const auto& t : faces) {
+            const Vec3 &a = s.w[t[0]], &b = s.w[t[1]], &c = s.w[t[2]], &d = s.w[t[3]];
+            const Vec3 n = (b - a).cross(c - a);
+            const float side = n.dot(d - a), origin = -n.dot(a);
+            if (side != 0.0f && origin * side >= 0.0f) continue; // początek po stronie czwartego wierzchołka
+            outside = true;
+            Feature g = onTriangle(s.w, t[0], t[1], t[2]);
+            float dist = g.v.dot(g.v);
+            if (!std::isfinite(dist)) continue; // ściana zdegenerowana (NaN) - zostaje inna albo wierzchołek 0
+            if (dist < best) { best = dist; f = g; }
+        }
+        if (!outside) { v = Vec3(); return true; }
+    }
+    Simplex r;
+    for (int k = 0; k < f.n; ++k) {
+        r.w[k] = s.w[f.id[k]]; r.a[k] = s.a[f.id[k]]; r.b[k] = s.b[f.id[k]];
+    }
+    r.count = f.n;
+    s = r;
+    v = f.v;
+    return false;
+}
+
+// ==========================================
+// EPA
+// ==========================================
+// Styk albo bardzo płytka penetracja zostawia GJK z simpleksem mniejszym niż czworościan - dokładamy wierzchołki
+// w kierunkach prostopadłych do tego, co już jest
+static bool blowUp(Simplex& s, const Minkowski& m) {
+    static const Vec3 axes[6] = { Vec3(1, 0, 0), Vec3(-1, 0, 0), Vec3(0, 1, 0), Vec3(0, -1, 0), Vec3(0, 0, 1), Vec3(0, 0, -1) };
+    if (s.count == 1)
+        for (const Vec3& d : axes) {
+            m.push(s, d);
+            if ((s.w[1] - s.w[0]).length() > DEGENERATE) break;
+            s.count--;
+        }
+    if (s.count == 2) {
+        const Vec3 ab = s.w[1] - s.w[0];
+        const Vec3 least = std::abs(ab.x) < std::abs(ab.y) ? (std::abs(ab.x) < std::abs(ab.z) ? axes[0] : axes[4]) : (std::abs(ab.y) < std::abs(ab.z) ? axes[2] : axes[4]);
+        const Vec3 p1 = ab.cross(least).normalize(), p2 = ab.cross(p1).normalize();
+        for (const Vec3& d : { p1, p2, p1 * -1.0f, p2 * -1.0f }) {
+            m.push(s, d);
+            if ((s.w[2] - s.w[0]).cross(ab).length() > DEGENERATE * ab.length()) break;
+            s.count--;
+        }
+    }
+    if (s.count == 3) {
+        const Vec3 n = (s.w[1] - s.w[0]).cross(s.w[2] - s.w[0]).normalize();
+        for (const Vec3& d : { n, n * -1.0f }) {
+            m.push(s, d);
+            if (std::abs(n.dot(s.w[3] - s.w[0])) > DEGENERATE) break;
+            s.count--;
+        }
+    }
+    return s.count == 4;
+}
+
+namespace {
+struct EpaFace {
+    int v[3];
+    Vec3 normal;
+    float distance; // od początku układu do płaszczyzny ściany
+};
+}
+
+// Wielościan rośnie w stronę najbliższej ściany, aż nowy wierzchołek przestaje ją odsuwać.
+// Normalna najbliższej ściany różnicy a - b = kierunek, w którym trzeba przesunąć b, żeby rozdzielić ciała.
+static EpaFace expand(const Simplex& s, const Minkowski& m) {
+    Vec3 pts[EPA_MAX_VERTICES];
+    EpaFace faces[EPA_MAX_FACES];
+    std::pair<int, int> edges[EPA_MAX_FACES * 3];
+    int vertexCount = 4, faceCount = 0;
+    for (int k = 0; k < 4; ++k) pts[k] = s.w[k];
+    if ((pts[1] - pts[0]).cross(pts[2] - pts[0]).dot(pts[3] - pts[0]) > 0.0f) std::swap(pts[1], pts[2]);
+
+    auto addFace = [&](int i, int j, int k) {
+        if (faceCount == EPA_MAX_FACES) return;
+        Vec3 n = (pts[j] - pts[i]).cross(pts[k] - pts[i]);
+        float len = n.length();
+        EpaFace& f = faces[faceCount++];
+        f.v[0] = i; f.v[1] = j; f.v[2] = k;
+        f.normal = len > 1e-12f ? n * (1.0f / len) : Vec3();
+        f.distance = len > 1e-12f ? f.normal.dot(pts[i]) : FLT_MAX;
+    };
+    addFace(0, 1, 2); addFace(0, 3, 1); addFace(1, 3, 2); addFace(2, 3, 0);
+
+    EpaFace closest = faces[0];
+    for (int it = 0; it < EPA_ITERATIONS; ++it) {
+        int c = 0;
+        for (int i = 1; i < faceCount; ++i) if (faces[i].distance < faces[c].distance) c = i;
+        closest = faces[c];
+        if (closest.distance == FLT_MAX || vertexCount == EPA_MAX_VERTICES) break;
+
+        Simplex probe;
+        m.push(probe, closest.normal);
+        const Vec3 w = probe.w[0];
+        if (closest.normal.dot(w) - closest.distance < EPA_TOLERANCE) break;
+
+        // Ściany widoczne z nowego wierzchołka znikają; krawędź wspólna dwóm z nich się znosi, reszta to horyzont
+        const int eye = vertexCount++;
+        pts[eye] = w;
+        int edgeCount = 0;
+        for (int i = 0; i < faceCount;) {
+            const EpaFace& f = faces[i];
+            if (f.normal.dot(w - pts[f.v[0]]) <= 0.0f) { ++i; continue; }
+            for (int k = 0; k < 3; ++k) {
+                std::pair<int, int> e(f.v[k], f.v[(k + 1) % 3]);
+                int twin = -1;
+                for (int q = 0; q < edgeCount; ++q) if (edges[q].first == e.second && edges[q].second == e.first) { twin = q; break; }
+                if (twin >= 0) edges[twin] = edges[--edgeCount];
+                else edges[edgeCount++] = e;
+            }
+            faces[i] = faces[--faceCount];
+        }
+        for (int q = 0; q < edgeCount; ++q) addFace(edges[q].first, edges[q].second, eye);
+    }
+    return closest;
+}
+
+SatResult gjkEpa(const ConvexShape& a, const ConvexShape& b, GjkSimplex& cache) {
+    const Minkowski m{ a, b };
+    const int limitA = a.hull ? (int)a.hull->x.size() : 8, limitB = b.hull ? (int)b.hull->x.size() : 8;
+    Simplex s;
+    for (int k = 0; k < cache.count; ++k) {
+        if (cache.a[k] >= limitA || cache.b[k] >= limitB) { s.count = 0; break; }
+        s.w[s.count] = a.vertex(cache.a[k]) - b.vertex(cache.b[k]);
+        s.a[s.count] = cache.a[k]; s.b[s.count] = cache.b[k];
+        s.count++;
+    }
+    if (s.count == 0) {
+        Vec3 d = b.frame.center - a.frame.center;
+        m.push(s, d.dot(d) > 0.0f ? d * -1.0f : Vec3(1, 0, 0));
+    }
+
+    Vec3 v;
+    bool inside = reduce(s, v);
+    for (int it = 0; !inside && it < GJK_ITERATIONS; ++it) {
+        const float vv = v.dot(v);
+        if (vv < GJK_TOUCH) { inside = true; break; }
+        const int ia = a.support(v * -1.0f), ib = b.support(v);
+        bool known = false;
+        for (int k = 0; k < s.count; ++k) known |= s.a[k] == ia && s.b[k] == ib;
+        const Vec3 w = a.vertex(ia) - b.vertex(ib);
+        if (known || vv - v.dot(w) <= GJK_TOLERANCE * vv) break;
+        s.w[s.count] = w; s.a[s.count] = ia; s.b[s.count] = ib;
+        s.count++;
+        inside = reduce(s, v);
+    }
+
+    SatResult r;
+    if (!inside) {
+        const float dist = v.length();
+        r.separation = dist;
+        r.normal = v * (-1.0f / dist);
+    } else if (blowUp(s, m)) {
+        EpaFace f = expand(s, m);
+        r.separation = -std::max(0.0f, f.distance);
+        r.normal = f.normal;
+    } else {
+        // Kształty bez objętości w tym miejscu - styk wzdłuż linii środków
+        Vec3 d = (b.frame.center - a.frame.center).normalize();
+        r.separation = 0.0f;
+        r.normal = d.dot(d) > 0.0f ? d : Vec3(0, 1, 0);
+    }
+    if (r.normal.dot(r.normal) == 0.0f) r.normal = Vec3(0, 1, 0);
+
+    cache.count = s.count;
+    for (int k = 0; k < s.count; ++k) { cache.a[k] = (uint16_t)s.a[k]; cache.b[k] = (uint16_t)s.b[k]; }
+    return r;
+}
+
+// ==========================================
+// RAYCAST
+// ==========================================
+// Promień przeniesiony do układu modelu (osie i skala), przycinany płaszczyznami ścian. Odwzorowanie jest liniowe,
+// więc parametr t zostaje odległością w świecie; normalna wraca przez odwrotność skali.
+bool rayHull(const ConvexShape& shape, const Vec3& origin, const Vec3& direction, float maxDistance, float& distance, Vec3& normal) {
+    if (!shape.hull) return rayObb(shape.frame, origin, direction, maxDistance, distance, normal);
+    const Obb& f = shape.frame;
+    const Vec3 rel = origin - f.center;
+    const Vec3 o(rel.dot(f.axis[0]) / f.half.x, rel.dot(f.axis[1]) / f.half.y, rel.dot(f.axis[2]) / f.half.z);
+    const Vec3 d(direction.dot(f.axis[0]) / f.half.x, direction.dot(f.axis[1]) / f.half.y, direction.dot(f.axis[2]) / f.half.z);
+    float enter = -FLT_MAX, exit = FLT_MAX;
+    const ConvexHull::Plane* entry = nullptr;
+    for (const ConvexHull::Plane& p : shape.hull->planes) {
+        const float denom = p.normal.dot(d), dist = p.offset - p.normal.dot(o);
+        if (denom == 0.0f) {
+            if (dist < 0.0f) return false;
+            continue;
+        }
+        const float t = dist / denom;
+        if (denom < 0.0f) { if (t > enter) { enter = t; entry = &p; } }
+        else exit = std::min(exit, t);
+        if (enter > exit) return false;
+    }
+    if (!entry || enter < 0.0f || enter >= maxDistance) return false;
+    distance = enter;
+    const Vec3 n = entry->normal;
+    normal = (f.axis[0] * (n.x / f.half.x) + f.axis[1] * (n.y / f.half.y) + f.axis[2] * (n.z / f.half.z)).normalize();
+    return true;
+}
+
+// ==========================================
+// CACHE SIMPLEKSÓW
+// ==========================================
+const GjkSimplex* SimplexCache::find(uint64_t key) const {
+    if (table.empty()) return nullptr;
+    const size_t mask = table.size() - 1;
+    for (size_t i = slotOf(key, mask);; i = (i + 1) & mask) {
+        if (table[i].key == key) return &table[i].simplex;
+        if (table[i].key == EMPTY_KEY) return nullptr;
+    }
+}
+
+void SimplexCache::flip() {
+    size_t capacity = 16;
+    while (capacity < fresh.size() * 2) capacity *= 2;
+    table.assign(capacity, Entry());
+    const size_t mask = capacity - 1;
+    for (const Entry& e : fresh) {
+        size_t i = slotOf(e.key, mask);
+        while (table[i].key != EMPTY_KEY && table[i].key != e.key) i = (i + 1) & mask;
+        table[i] = e;
+    }
+    fresh.clear();
+}
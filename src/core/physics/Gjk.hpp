@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "ConvexHull.hpp"
+#include "Obb.hpp"
+
+// Kształt wypukły dla GJK: pudełko (hull == nullptr, frame.half = połówki wymiarów)
+// albo otoczka modelu (frame.half = skala, wierzchołek w świecie = środek + Σ osie * skala * punkt otoczki).
+// Wierzchołki mają stałe indeksy (pudełko: bity narożnika 0..7), dzięki czemu simpleks można zapamiętać między krokami.
+struct ConvexShape {
+    Obb frame;
+    const ConvexHull* hull = nullptr;
+
+    Vec3 vertex(int index) const;
+    int support(const Vec3& direction) const;
+};
+
+// Simpleks GJK jako pary indeksów wierzchołków (a, b) - pozycje liczone od nowa z bieżących transformacji
+struct GjkSimplex {
+    int count = 0;
+    uint16_t a[4], b[4];
+};
+
+// Odległość (separation > 0, GJK) albo penetracja (< 0, EPA) dwóch kształtów wypukłych; normal od a do b.
+// `simplex` na wejściu rozgrzewa GJK (simpleks tej pary z poprzedniego kroku), na wyjściu jest końcowy.
+SatResult gjkEpa(const ConvexShape& a, const ConvexShape& b, GjkSimplex& simplex);
+
+// Promień (kierunek znormalizowany) przez płaszczyzny otoczki; false, jeśli pudło albo start w środku
+bool rayHull(const ConvexShape& shape, const Vec3& origin, const Vec3& direction, float maxDistance, float& distance, Vec3& normal);
+
+// --- CACHE SIMPLEKSÓW ---
+// Klucz = para encji. Krok fizyki przesuwa ciała o ułamki centymetra, więc simpleks z poprzedniego kroku
+// zwykle jest już końcowy i GJK kończy się po 1-2 iteracjach. Płaska tablica z adresowaniem otwartym,
+// przebudowywana co krok z par sprawdzonych w poprzednim (pary, które wypadły z broadphase, znikają same).
+class SimplexCache {
+public:
+    const GjkSimplex* find(uint64_t key) const;
+    void store(uint64_t key, const GjkSimplex& simplex) { fresh.push_back({ key, simplex }); }
+    void flip(); // wpisy z store() stają się widoczne dla find()
+    void clear() { table.clear(); fresh.clear(); }
+
+private:
+    static constexpr uint64_t EMPTY_KEY = ~0ull;
+    struct Entry { uint64_t key = EMPTY_KEY; GjkSimplex simplex; };
+    static size_t slotOf(uint64_t key, size_t mask) { return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask; }
+
+    std::vector<Entry> table; // rozmiar = potęga dwójki
+    std::vector<Entry> fresh;
+};
@@ -0,0 +1,191 @@
+#include "Obb.hpp"
+#include <algorithm>
+#include <cmath>
+#include "../math/Simd.hpp"
+
+static const float AXIS_EPSILON = 1e-6f; // krawędzie równoległe - iloczyn wektorowy bez kierunku
+static const float EDGE_BIAS = 1e-3f;
+
+static float dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+Obb Obb::fromMatrix(const float* m, const Vec3& halfExtents) {
+    Obb o;
+    o.center = Vec3(m[12], m[13], m[14]);
+    const float h[3] = { halfExtents.x, halfExtents.y, halfExtents.z };
+    float half[3];
+    for (int k = 0; k < 3; ++k) {
+        Vec3 c(m[k * 4], m[k * 4 + 1], m[k * 4 + 2]);
+        float len = std::sqrt(dot(c, c));
+        o.axis[k] = len > 0.0f ? Vec3(c.x / len, c.y / len, c.z / len) : o.axis[k];
+        half[k] = h[k] * len;
+    }
+    o.half = Vec3(half[0], half[1], half[2]);
+    return o;
+}
+
+Vec3 Obb::aabbHalf() const {
+    return Vec3(std::abs(axis[0].x) * half.x + std::abs(axis[1].x) * half.y + std::abs(axis[2].x) * half.z,
+                std::abs(axis[0].y) * half.x + std::abs(axis[1].y) * half.y + std::abs(axis[2].y) * half.z,
+                std::abs(axis[0].z) * half.x + std::abs(axis[1].z) * half.y + std::abs(axis[2].z) * half.z);
+}
+
+bool Obb::isAxisAligned() const {
+    const float e = 1e-5f;
+    return std::abs(axis[0].y) < e && std::abs(axis[0].z) < e && std::abs(axis[1].x) < e && std::abs(axis[1].z) < e && std::abs(axis[2].x) < e && std::abs(axis[2].y) < e;
+}
+
+// ==========================================
+// AABB
+// ==========================================
+SatResult aabbTest(const Vec3& ca, const Vec3& ha, const Vec3& cb, const Vec3& hb) {
+    float dx = cb.x - ca.x, dy = cb.y - ca.y, dz = cb.z - ca.z;
+    float sx = std::abs(dx) - (ha.x + hb.x);
+    float sy = std::abs(dy) - (ha.y + hb.y);
+    float sz = std::abs(dz) - (ha.z + hb.z);
+    SatResult r;
+    r.separation = std::max(sx, std::max(sy, sz));
+    if (r.separation == sx) r.normal = Vec3(dx < 0.0f ? -1.0f : 1.0f, 0, 0);
+    else if (r.separation == sy) r.normal = Vec3(0, dy < 0.0f ? -1.0f : 1.0f, 0);
+    else r.normal = Vec3(0, 0, dz < 0.0f ? -1.0f : 1.0f);
+    return r;
+}
+
+// ==========================================
+// SAT
+// ==========================================
+SatResult satTest(const Obb& a, const Obb& b) {
+    const Vec3 d(b.center.x - a.center.x, b.center.y - a.center.y, b.center.z - a.center.z);
+    const Vec3 ea[3] = { Vec3(a.axis[0].x * a.half.x, a.axis[0].y * a.half.x, a.axis[0].z * a.half.x),
+                         Vec3(a.axis[1].x * a.half.y, a.axis[1].y * a.half.y, a.axis[1].z * a.half.y),
+                         Vec3(a.axis[2].x * a.half.z, a.axis[2].y * a.half.z, a.axis[2].z * a.half.z) };
+    const Vec3 eb[3] = { Vec3(b.axis[0].x * b.half.x, b.axis[0].y * b.half.x, b.axis[0].z * b.half.x),
+                         Vec3(b.axis[1].x * b.half.y, b.axis[1].y * b.half.y, b.axis[1].z * b.half.y),
+                         Vec3(b.axis[2].x * b.half.z, b.axis[2].y * b.half.z, b.axis[2].z * b.half.z) };
+#ifdef DUCKY_SSE
+    // 5 grup po 4 lany: ściany A, ściany B, a_0 x b_j, a_1 x b_j, a_2 x b_j (lana 3 = wypełnienie)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 bx = _mm_setr_ps(b.axis[0].x, b.axis[1].x, b.axis[2].x, 0.0f);
+    const __m128 by = _mm_setr_ps(b.axis[0].y, b.axis[1].y, b.axis[2].y, 0.0f);
+    const __m128 bz = _mm_setr_ps(b.axis[0].z, b.axis[1].z, b.axis[2].z, 0.0f);
+    __m128 gx[5], gy[5], gz[5], gvalid[5];
+    gx[0] = _mm_setr_ps(a.axis[0].x, a.axis[1].x, a.axis[2].x, 0.0f);
+    gy[0] = _mm_setr_ps(a.axis[0].y, a.axis[1].y, a.axis[2].y, 0.0f);
+    gz[0] = _mm_setr_ps(a.axis[0].z, a.axis[1].z, a.axis[2].z, 0.0f);
+    gx[1] = bx; gy[1] = by; gz[1] = bz;
+    const __m128 firstThree = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    gvalid[0] = gvalid[1] = firstThree;
+    for (int i = 0; i < 3; ++i) {
+        __m128 ux = _mm_set1_ps(a.axis[i].x), uy = _mm_set1_ps(a.axis[i].y), uz = _mm_set1_ps(a.axis[i].z);
+        __m128 cx = _mm_sub_ps(_mm_mul_ps(uy, bz), _mm_mul_ps(uz, by));
+        __m128 cy = _mm_sub_ps(_mm_mul_ps(uz, bx), _mm_mul_ps(ux, bz));
+        __m128 cz = _mm_sub_ps(_mm_mul_ps(ux, by), _mm_mul_ps(uy, bx));
+        __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cy, cy)), _mm_mul_ps(cz, cz));
+        __m128 ok = _mm_and_ps(_mm_cmpgt_ps(len2, _mm_set1_ps(AXIS_EPSILON)), firstThree);
+        __m128 inv = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(len2, _mm_set1_ps(AXIS_EPSILON)))), ok);
+        gx[2 + i] = _mm_mul_ps(cx, inv); gy[2 + i] = _mm_mul_ps(cy, inv); gz[2 + i] = _mm_mul_ps(cz, inv);
+        gvalid[2 + i] = ok;
+    }
+    auto absProject = [&](const Vec3& e, __m128 x, __m128 y, __m128 z) {
+        __m128 p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(e.x), x), _mm_mul_ps(_mm_set1_ps(e.y), y)), _mm_mul_ps(_mm_set1_ps(e.z), z));
+        return _mm_andnot_ps(signMask, p);
+    };
+    __m128 gsep[5], gproj[5];
+    const __m128 invalidSep = _mm_set1_ps(-1e30f);
+    for (int g = 0; g < 5; ++g) {
+        __m128 x = gx[g], y = gy[g], z = gz[g];
+        gproj[g] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(d.x), x), _mm_mul_ps(_mm_set1_ps(d.y), y)), _mm_mul_ps(_mm_set1_ps(d.z), z));
+        __m128 radius = _mm_add_ps(_mm_add_ps(absProject(ea[0], x, y, z), absProject(ea[1], x, y, z)), absProject(ea[2], x, y, z));
+        radius = _mm_add_ps(radius, _mm_add_ps(_mm_add_ps(absProject(eb[0], x, y, z), absProject(eb[1], x, y, z)), absProject(eb[2], x, y, z)));
+        __m128 sg = _mm_sub_ps(_mm_andnot_ps(signMask, gproj[g]), radius);
+        gsep[g] = _mm_or_ps(_mm_and_ps(gvalid[g], sg), _mm_andnot_ps(gvalid[g], invalidSep));
+    }
+    // Maksimum poziome i wybór lany bez wychodzenia z rejestrów
+    auto horizontalMax = [](__m128 v) {
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(v);
+    };
+    float faceMax = horizontalMax(_mm_max_ps(gsep[0], gsep[1]));
+    float edgeMax = horizontalMax(_mm_max_ps(_mm_max_ps(gsep[2], gsep[3]), gsep[4]));
+    bool edge = edgeMax > -1e29f && edgeMax > faceMax + EDGE_BIAS;
+    float bestSep = edge ? edgeMax : faceMax;
+    int group = edge ? 2 : 0, mask = 0;
+    for (int last = edge ? 4 : 1; group <= last; ++group) {
+        mask = _mm_movemask_ps(_mm_cmpeq_ps(gsep[group], _mm_set1_ps(bestSep)));
+        if (mask) break;
+    }
+    int lane = 0;
+    while (!(mask & (1 << lane))) ++lane;
+    alignas(16) float tx[4], ty[4], tz[4], td[4];
+    _mm_store_ps(tx, gx[group]); _mm_store_ps(ty, gy[group]); _mm_store_ps(tz, gz[group]); _mm_store_ps(td, gproj[group]);
+    SatResult r;
+    r.separation = bestSep;
+    float s = td[lane] < 0.0f ? -1.0f : 1.0f;
+    r.normal = Vec3(tx[lane] * s, ty[lane] * s, tz[lane] * s);
+    return r;
+#else
+    // 0-2 osie ścian A, 3-5 ściany B, 6-14 krawędzie (a_i x b_j -> 6 + 3i + j)
+    float Lx[15], Ly[15], Lz[15], sep[15], dl[15];
+    bool valid[15];
+    for (int i = 0; i < 3; ++i) {
+        Lx[i] = a.axis[i].x; Ly[i] = a.axis[i].y; Lz[i] = a.axis[i].z;
+        Lx[3 + i] = b.axis[i].x; Ly[3 + i] = b.axis[i].y; Lz[3 + i] = b.axis[i].z;
+        valid[i] = valid[3 + i] = true;
+    }
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) {
+            const Vec3& u = a.axis[i];
+            const Vec3& v = b.axis[j];
+            Vec3 c(u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+            float len2 = dot(c, c);
+            int k = 6 + i * 3 + j;
+            valid[k] = len2 > AXIS_EPSILON;
+            float inv = valid[k] ? 1.0f / std::sqrt(len2) : 0.0f;
+            Lx[k] = c.x * inv; Ly[k] = c.y * inv; Lz[k] = c.z * inv;
+        }
+    for (int k = 0; k < 15; ++k) {
+        Vec3 L(Lx[k], Ly[k], Lz[k]);
+        dl[k] = dot(d, L);
+        float radius = 0.0f;
+        for (int i = 0; i < 3; ++i) radius += std::abs(dot(ea[i], L)) + std::abs(dot(eb[i], L));
+        sep[k] = std::abs(dl[k]) - radius;
+    }
+
+    int bestFace = 0, bestEdge = -1;
+    for (int k = 1; k < 6; ++k) if (sep[k] > sep[bestFace]) bestFace = k;
+    for (int k = 6; k < 15; ++k) if (valid[k] && (bestEdge < 0 || sep[k] > sep[bestEdge])) bestEdge = k;
+    int best = bestEdge >= 0 && sep[bestEdge] > sep[bestFace] + EDGE_BIAS ? bestEdge : bestFace;
+
+    SatResult r;
+    r.separation = sep[best];
+    float s = dl[best] < 0.0f ? -1.0f : 1.0f;
+    r.normal = Vec3(Lx[best] * s, Ly[best] * s, Lz[best] * s);
+    return r;
+#endif
+}
+
+// ==========================================
+// PROMIEŃ
+// ==========================================
+bool rayObb(const Obb& box, const Vec3& origin, const Vec3& direction, float maxDistance, float& distance, Vec3& normal) {
+    const Vec3 rel(origin.x - box.center.x, origin.y - box.center.y, origin.z - box.center.z);
+    const float h[3] = { box.half.x, box.half.y, box.half.z };
+    float tNear = -1e30f, tFar = 1e30f;
+    int axis = 0;
+    float sign = 1.0f;
+    for (int k = 0; k < 3; ++k) {
+        float o = dot(rel, box.axis[k]), dk = dot(direction, box.axis[k]);
+        if (std::abs(dk) < 1e-12f) {
+            if (o < -h[k] || o > h[k]) return false;
+            continue;
+        }
+        float t1 = (-h[k] - o) / dk, t2 = (h[k] - o) / dk;
+        float tk = std::min(t1, t2);
+        if (tk > tNear) { tNear = tk; axis = k; sign = dk < 0.0f ? 1.0f : -1.0f; }
+        tFar = std::min(tFar, std::max(t1, t2));
+    }
+    if (tNear < 0.0f || tNear > tFar || tNear >= maxDistance) return false;
+    distance = tNear;
+    normal = Vec3(box.axis[axis].x * sign, box.axis[axis].y * sign, box.axis[axis].z * sign);
+    return true;
+}
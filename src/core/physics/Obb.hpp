@@ -0,0 +1,31 @@
+#pragma once
+#include "../math/Vec3.hpp"
+
+// --- OBB (prostopadłościan zorientowany) ---
+// Osie są jednostkowe, skala siedzi w połówkach wymiarów. Budowany z macierzy modelu (kolumny = osie * skala).
+struct Obb {
+    Vec3 center;
+    Vec3 axis[3] = { Vec3(1, 0, 0), Vec3(0, 1, 0), Vec3(0, 0, 1) };
+    Vec3 half;
+
+    static Obb fromMatrix(const float* m, const Vec3& halfExtents);
+    Vec3 aabbHalf() const; // połówki AABB otaczającego
+    bool isAxisAligned() const;
+};
+
+// Wynik testu pary: separation > 0 = odstęp, < 0 = penetracja; normal od a do b
+struct SatResult {
+    float separation;
+    Vec3 normal;
+};
+
+// Oś najmniejszej penetracji dla dwóch AABB (ciała bez obrotu)
+SatResult aabbTest(const Vec3& centerA, const Vec3& halfA, const Vec3& centerB, const Vec3& halfB);
+
+// Test osi rozdzielających: 3 + 3 osie ścian i 9 iloczynów wektorowych krawędzi.
+// Rzuty na wszystkie osie liczone po 4 naraz (SSE); osie krawędzi wygrywają tylko wyraźnie lepszym wynikiem,
+// żeby leżące płasko pudełka nie dostawały ukośnych normalnych.
+SatResult satTest(const Obb& a, const Obb& b);
+
+// Promień (kierunek znormalizowany) w układzie OBB; false, jeśli pudło albo start w środku
+bool rayObb(const Obb& box, const Vec3& origin, const Vec3& direction, float maxDistance, float& distance, Vec3& normal);
@@ -0,0 +1,824 @@
+#include "PhysicsWorld.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "../ecs/World.hpp"
+#include "../jobs/JobSystem.hpp"
+#include "../math/Simd.hpp"
+
+static const float GRAVITY = 9.81f;
+static const float REST_SPEED = 0.001f;
+static const float DAMPING = 0.95f;
+static const float SLEEP_SPEED = 0.05f;   // m/s
+static const float SLEEP_TIME = 0.5f;     // s bez ruchu, zanim wyspa zaśnie
+static const float CONTACT_MARGIN = 0.05f; // odstęp, przy którym ciała są jeszcze w jednej wyspie
+static const float SWEEP_SKIN = 0.005f;    // ciało CCD zatrzymuje się tyle przed powierzchnią
+static const int SWEEP_PASSES = 3;         // zderzenie -> ślizg resztą czasu, najwyżej tyle razy
+static const uint16_t LOD_HOLD_STEPS = 60; // tyle kroków popchnięte ciało nie schodzi na rzadszy poziom
+static const float LOD_HYSTERESIS = 2.0f;  // m za granicą, zanim ciało zejdzie na rzadszy poziom
+static const float LOD_MIN_SCALE = 0.25f;  // najmniejszy mnożnik odległości z kontrolera budżetu
+
+// Klucz pary encji dla cache impulsów i simpleksów
+static uint64_t pairKey(int a, int b) { return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b; }
+
+// ==========================================
+// SYNC ECS -> FIZYKA
+// ==========================================
+void PhysicsWorld::rebuild(World& world) {
+    // Uśpione ciała zostają uśpione; sąsiedzi ciał, które znikają, muszą się obudzić
+    // Poziom LOD i zebrany czas też przechodzą, inaczej przebudowa gubiłaby ciałom kroki
+    struct OldLod { int id; uint8_t tier; uint16_t hold; float time; };
+    std::vector<int> oldSleeping;
+    std::vector<OldLod> oldLod;
+    std::vector<std::pair<int, Aabb>> oldColliders;
+    for (size_t b = 0; b < entity.size(); ++b) {
+        if ((flags[b] & Body_Dynamic) && !awake[b]) oldSleeping.push_back(entity[b]);
+        if ((flags[b] & Body_Dynamic) && (lodTier[b] != Tier_Full || lodHold[b] || lodTime[b] != 0.0f)) oldLod.push_back({ entity[b], lodTier[b], lodHold[b], lodTime[b] });
+        if (flags[b] & Body_Collider) oldColliders.push_back({entity[b], bounds((int)b)});
+    }
+
+    entity.clear(); px.clear(); py.clear(); pz.clear(); vx.clear(); vy.clear(); vz.clear();
+    invMass.clear(); hx.clear(); hy.clear(); hz.clear(); gravityScale.clear(); damping.clear(); sleepTimer.clear();
+    flags.clear(); awake.clear(); moved.clear(); tagFlags.clear(); shapes.clear(); hulls.clear(); ownerId.clear(); solverSlot.clear(); proxy.clear(); islandNext.clear();
+    triggerDirty.clear(); triggerLinks.clear(); lodTier.clear(); lodHold.clear(); lodTime.clear(); stepDt.clear();
+    dynamicBodies.clear(); awakeBodies.clear(); stepBodies.clear(); childBodies.clear(); movedBodies.clear(); dirtyBodies.clear();
+    bodyIndex.clear();
+    tree.clear();
+    triggerTree.clear();
+    triggerCount = 0;
+
+    // Kolejność ciał po id - wynik kroku nie zależy od kolejności obiektów w scenie
+    const ComponentMask physical = componentMask<PhysicsBody>() | componentMask<Collider>();
+    std::vector<int> ids(world.getOrder());
+    std::sort(ids.begin(), ids.end());
+    for (int id : ids) {
+        ComponentMask mask = world.getMask(id);
+        if (!(mask & physical) || !(mask & componentMask<Transform>())) continue;
+        int b = (int)entity.size();
+        if ((size_t)id >= bodyIndex.size()) bodyIndex.resize((size_t)id + 1, -1);
+        bodyIndex[id] = b;
+        entity.push_back(id);
+        for (auto* a : {&px, &py, &pz, &vx, &vy, &vz, &invMass, &hx, &hy, &hz, &gravityScale, &damping, &sleepTimer, &lodTime, &stepDt}) a->push_back(0.0f);
+        flags.push_back(0);
+        awake.push_back(1);
+        moved.push_back(0);
+        ownerId.push_back(-1);
+        tagFlags.push_back(0);
+        shapes.push_back(Obb());
+        hulls.push_back(nullptr);
+        solverSlot.push_back(-1);
+        proxy.push_back(AabbTree::NULL_NODE);
+        islandNext.push_back(b);
+        triggerDirty.push_back(0);
+        triggerLinks.emplace_back();
+        lodTier.push_back(Tier_Full);
+        lodHold.push_back(0);
+        pull(world, b);
+        if (flags[b] & Body_Collider) proxy[b] = treeOf(b).insert(bounds(b), b);
+        if (flags[b] & Body_Trigger) triggerCount++;
+        if (flags[b] & Body_Dynamic) dynamicBodies.push_back(b);
+        if (flags[b] & Body_Child) childBodies.push_back(b);
+    }
+    islandParent.assign(entity.size(), 0);
+    islandHead.assign(entity.size(), -1);
+    structureVersion = world.getStructureVersion();
+
+    for (int id : oldSleeping) {
+        int b = bodyOf(id);
+        if (b < 0 || !(flags[b] & Body_Dynamic)) continue;
+        awake[b] = 0; gravityScale[b] = 0.0f; vx[b] = vy[b] = vz[b] = 0.0f;
+    }
+    for (const OldLod& o : oldLod) {
+        int b = bodyOf(o.id);
+        if (b < 0 || !(flags[b] & Body_Dynamic)) continue;
+        lodTier[b] = o.tier; lodHold[b] = o.hold; lodTime[b] = o.time;
+    }
+    for (const auto& c : oldColliders) if (bodyOf(c.first) < 0) wakeOverlapping(c.second);
+    for (int b : dynamicBodies) if (awake[b]) awakeBodies.push_back(b);
+
+    // Pary stref przeżywają przebudowę (bez ponownego Enter); znikniętym ciałom wysyłamy Exit od razu
+    for (size_t i = 0; i < triggerPairs.size(); ++i) {
+        TriggerPair& p = triggerPairs[i];
+        if (p.trigger == -1) continue;
+        int t = bodyOf(p.triggerId), o = bodyOf(p.otherId);
+        if (t < 0 || o < 0 || !(flags[t] & Body_Trigger) || (flags[o] & (Body_Trigger | Body_Collider)) != Body_Collider) {
+            triggerEvents.push_back({ p.triggerId, p.otherId, TriggerEventType::Exit });
+            triggerPairIndex.erase(pairKey(p.triggerId, p.otherId));
+            p.trigger = -1;
+            freeTriggerPairs.push_back((int)i);
+            continue;
+        }
+        p.trigger = t; p.other = o;
+        triggerLinks[t].push_back((int)i);
+        triggerLinks[o].push_back((int)i);
+    }
+    for (size_t b = 0; b < entity.size(); ++b) markTriggerDirty((int)b);
+}
+
+// Skład komponentów i rodzic nie zmieniają się między przebudowami, więc lista dynamicznych ciał też nie
+void PhysicsWorld::pull(World& world, int b) {
+    int id = entity[b];
+    const Transform& t = *world.get<Transform>(id);
+    const PhysicsBody* body = world.get<PhysicsBody>(id);
+    const Collider* collider = world.get<Collider>(id);
+    const Tag* tag = world.get<Tag>(id);
+    const MeshRenderer* mesh = world.get<MeshRenderer>(id);
+    bool child = world.getParent(id) != -1;
+    hulls[b] = collider && mesh && mesh->type == MeshType::Model ? mesh->hull.get() : nullptr;
+
+    uint16_t f = 0;
+    if (body && !child) f |= Body_Dynamic;
+    if (collider) f |= Body_Collider;
+    if (collider && collider->trigger) f |= Body_Trigger;
+    if (hulls[b]) f |= Body_Hull;
+    if (child) f |= Body_Child;
+    if (body && body->lockX) f |= Body_LockX;
+    if (body && body->lockY) f |= Body_LockY;
+    if (body && body->lockZ) f |= Body_LockZ;
+    if (body && !child && body->useGravity && !body->lockY) f |= Body_Gravity;
+    if (body && !child && body->continuous && !(f & Body_Trigger)) f |= Body_Continuous;
+    if (tag && (tag->flags & Tag_Player)) f |= Body_Player;
+    flags[b] = f;
+    tagFlags[b] = tag ? tag->flags : 0;
+    int owner = -1;
+    for (int p = world.getParent(id); p != -1; p = world.getParent(p)) owner = p;
+    ownerId[b] = owner;
+
+    bool dynamic = (f & Body_Dynamic) != 0;
+    px[b] = t.position.x; py[b] = t.position.y; pz[b] = t.position.z;
+    Vec3 v = dynamic ? body->velocity : Vec3();
+    vx[b] = v.x; vy[b] = v.y; vz[b] = v.z;
+    invMass[b] = dynamic ? 1.0f : 0.0f;
+    gravityScale[b] = (f & Body_Gravity) && awake[b] ? 1.0f : 0.0f;
+    damping[b] = dynamic && !(f & Body_Player) ? DAMPING : 1.0f;
+    // Dziecko dostaje kształt z macierzy świata w refreshChildBounds()
+    if (collider && !child) {
+        Mat4 m = TransformHierarchy::composeLocal(t);
+        setShape(b, m.data(), collider->halfExtents);
+    } else if (!collider) hx[b] = hy[b] = hz[b] = 0.0f;
+}
+
+// Otoczka: OBB niesie tylko osie i skalę, a AABB liczymy z pudełka otoczki wokół początku układu modelu
+void PhysicsWorld::setShape(int b, const float* m, const Vec3& halfExtents) {
+    Vec3 h;
+    if (const ConvexHull* hull = hulls[b]) {
+        shapes[b] = Obb::fromMatrix(m, Vec3(1, 1, 1));
+        Obb box = shapes[b];
+        box.half = Vec3(box.half.x * hull->extent.x, box.half.y * hull->extent.y, box.half.z * hull->extent.z);
+        h = box.aabbHalf();
+    } else {
+        shapes[b] = Obb::fromMatrix(m, halfExtents);
+        h = shapes[b].aabbHalf();
+    }
+    hx[b] = h.x; hy[b] = h.y; hz[b] = h.z;
+    if (shapes[b].isAxisAligned()) flags[b] &= ~Body_Rotated;
+    else flags[b] |= Body_Rotated;
+}
+
+// Dzieci nie są symulowane, ale ich rodzic mógł się ruszyć - AABB obróconego prostopadłościanu z macierzy świata
+void PhysicsWorld::refreshChildBounds(World& world) {
+    for (int b : childBodies) {
+        int id = entity[b];
+        const float* m = world.getWorldMatrix(id).data();
+        const float before[6] = { px[b], py[b], pz[b], hx[b], hy[b], hz[b] };
+        px[b] = m[12]; py[b] = m[13]; pz[b] = m[14];
+        const Collider* c = world.get<Collider>(id);
+        if (!c) continue;
+        setShape(b, m, c->halfExtents);
+        updateProxy(b);
+        if (before[0] != px[b] || before[1] != py[b] || before[2] != pz[b] || before[3] != hx[b] || before[4] != hy[b] || before[5] != hz[b]) markTriggerDirty(b);
+    }
+}
+
+void PhysicsWorld::sync(World& world) {
+    triggerEvents.clear();
+    triggerFrame++;
+    triggerTests = 0;
+    if (structureVersion != world.getStructureVersion()) rebuild(world);
+    else {
+        for (int id : world.getTouched()) {
+            int b = bodyOf(id);
+            if (b < 0) continue;
+            // Edycja z zewnątrz budzi ciało i wszystko, co leżało na nim w starym albo nowym miejscu
+            bool collider = (flags[b] & Body_Collider) != 0;
+            const uint16_t oldFlags = flags[b];
+            Aabb before = bounds(b);
+            pull(world, b);
+            if (collider && ((oldFlags ^ flags[b]) & Body_Trigger)) {
+                // Przełączona strefa zmienia drzewo; jej stare pary wygasną w updateTriggers()
+                ((oldFlags & Body_Trigger) ? triggerTree : tree).remove(proxy[b]);
+                proxy[b] = treeOf(b).insert(bounds(b), b);
+                if (flags[b] & Body_Trigger) triggerCount++; else triggerCount--;
+            } else updateProxy(b);
+            markTriggerDirty(b);
+            if (collider) wakeOverlapping(Aabb::merge(before, bounds(b)));
+            wake(b);
+            lodTier[b] = Tier_Full;
+            lodHold[b] = LOD_HOLD_STEPS;
+        }
+    }
+    world.clearTouched();
+    refreshChildBounds(world);
+}
+
+// ==========================================
+// BROADPHASE I USYPIANIE
+// ==========================================
+Aabb PhysicsWorld::bounds(int b) const {
+    return { Vec3(px[b] - hx[b], py[b] - hy[b], pz[b] - hz[b]), Vec3(px[b] + hx[b], py[b] + hy[b], pz[b] + hz[b]) };
+}
+
+Obb PhysicsWorld::shapeOf(int b) const {
+    Obb o = shapes[b];
+    o.center = Vec3(px[b], py[b], pz[b]);
+    return o;
+}
+
+ConvexShape PhysicsWorld::convexOf(int b) const {
+    ConvexShape s;
+    s.frame = shapeOf(b);
+    s.hull = hulls[b];
+    return s;
+}
+
+void PhysicsWorld::updateProxy(int b) {
+    if (proxy[b] != AabbTree::NULL_NODE) treeOf(b).move(proxy[b], bounds(b));
+}
+
+void PhysicsWorld::wake(int b) {
+    if (!(flags[b] & Body_Dynamic) || awake[b]) return;
+    int m = b;
+    do {
+        int next = islandNext[m];
+        awake[m] = 1;
+        sleepTimer[m] = 0.0f;
+        lodTime[m] = 0.0f; // czas snu nie jest do nadrobienia
+        gravityScale[m] = (flags[m] & Body_Gravity) ? 1.0f : 0.0f;
+        islandNext[m] = m;
+        awakeBodies.push_back(m);
+        m = next;
+    } while (m != b);
+}
+
+void PhysicsWorld::wakeOverlapping(const Aabb& box) {
+    Aabb grown = { Vec3(box.min.x - CONTACT_MARGIN, box.min.y - CONTACT_MARGIN, box.min.z - CONTACT_MARGIN), Vec3(box.max.x + CONTACT_MARGIN, box.max.y + CONTACT_MARGIN, box.max.z + CONTACT_MARGIN) };
+    tree.query(grown, [&](int other) { wake(other); return true; });
+}
+
+void PhysicsWorld::wakeAll() {
+    for (int b : dynamicBodies) wake(b);
+}
+
+// Bez starych ciał rebuild() nie przenosi uśpienia, a drzewo i cache startują puste jak w świeżym PhysicsWorld
+void PhysicsWorld::reset() {
+    entity.clear(); flags.clear(); awake.clear(); bodyIndex.clear();
+    tree.clear(); triggerTree.clear(); // raycast przed pierwszym sync() nie może trafić w stare ciała
+    triggerPairs.clear(); freeTriggerPairs.clear(); triggerPairIndex.clear();
+    solver.reset();
+    simplexCache.clear();
+    accumulator = 0.0f;
+    lodStep = 0;
+    lodScale = 1.0f;
+    lodFrameMs = 0.0f;
+    structureVersion = ~0ull;
+}
+
+uint64_t PhysicsWorld::stateHash() const {
+    uint64_t h = 0xcbf29ce484222325ull; // FNV-1a
+    auto mix = [&](const void* data, size_t size) {
+        const unsigned char* p = (const unsigned char*)data;
+        for (size_t i = 0; i < size; ++i) { h ^= p[i]; h *= 0x100000001b3ull; }
+    };
+    for (size_t b = 0; b < entity.size(); ++b) {
+        const float state[6] = { px[b], py[b], pz[b], vx[b], vy[b], vz[b] };
+        mix(&entity[b], sizeof(int));
+        mix(state, sizeof(state));
+        mix(&awake[b], 1);
+    }
+    return h;
+}
+
+int PhysicsWorld::findRoot(int b) {
+    while (islandParent[b] != b) { islandParent[b] = islandParent[islandParent[b]]; b = islandParent[b]; }
+    return b;
+}
+
+// Ciała CCD nie potrzebują kontaktów na zapas - ich ruch i tak jest sprawdzany odcinkiem w sweep()
+float PhysicsWorld::reach(int b, float dt) const {
+    if (flags[b] & Body_Continuous) return CONTACT_MARGIN;
+    return CONTACT_MARGIN + std::max(std::abs(vx[b]), std::max(std::abs(vy[b]), std::abs(vz[b]))) * dt;
+}
+
+SatResult PhysicsWorld::convexTest(int a, int b) {
+    const uint64_t key = pairKey(entity[a], entity[b]);
+    GjkSimplex simplex;
+    if (const GjkSimplex* cached = simplexCache.find(key)) simplex = *cached;
+    SatResult r = gjkEpa(convexOf(a), convexOf(b), simplex);
+    simplexCache.store(key, simplex);
+    return r;
+}
+
+SatResult PhysicsWorld::narrowphase(int a, int b) {
+    const uint16_t shape = flags[a] | flags[b];
+    if (shape & Body_Hull) return convexTest(a, b);
+    if (shape & Body_Rotated) return satTest(shapeOf(a), shapeOf(b));
+    return aabbTest(Vec3(px[a], py[a], pz[a]), Vec3(hx[a], hy[a], hz[a]), Vec3(px[b], py[b], pz[b]), Vec3(hx[b], hy[b], hz[b]));
+}
+
+// Broadphase: kandydaci z drzewa, których dokładny AABB (a nie gruby liść) leży w zasięgu kontaktu.
+// Dalej kształty i tak nie mogą się zetknąć w tym kroku, więc narrowphase ich nie ogląda.
+void PhysicsWorld::findCandidates() {
+    candidates.clear();
+    for (int b : stepBodies) {
+        if ((flags[b] & (Body_Collider | Body_Trigger)) != Body_Collider) continue;
+        const float r = reach(b, stepDt[b]);
+        Aabb box = bounds(b);
+        box.min = Vec3(box.min.x - r, box.min.y - r, box.min.z - r);
+        box.max = Vec3(box.max.x + r, box.max.y + r, box.max.z + r);
+        tree.query(box, [&](int other) {
+            if (other == b || ownerId[other] == entity[b] || !box.overlaps(bounds(other))) return true;
+            candidates.push_back({b, other, r});
+            return true;
+        });
+    }
+}
+
+// Narrowphase: para (ciało kroku, collider) z normalną wzdłuż osi najmniejszej penetracji. Ciało śpiące budzimy,
+// ale w tym kroku jest dla solvera statyczne; para dwóch ciał kroku powstaje tylko raz.
+// Ciało rzadszego poziomu LOD dotknięte przez ciało kroku przechodzi na jego poziom od następnego kroku.
+void PhysicsWorld::findContacts() {
+    pairs.clear();
+    simplexCache.flip();
+    for (const Candidate& c : candidates) {
+        const int b = c.b, other = c.other;
+        SatResult test = narrowphase(b, other);
+        if (test.separation > c.reach) continue;
+        bool inStep = solverSlot[other] != -1;
+        if (inStep && other < b && test.separation <= reach(other, stepDt[other])) continue; // znajdzie ją `other`
+        if (flags[other] & Body_Dynamic) {
+            if (!awake[other]) wake(other);
+            if (lodTier[other] > lodTier[b]) { lodTier[other] = lodTier[b]; lodHold[other] = LOD_HOLD_STEPS; }
+        }
+        pairs.push_back({b, other, test.normal, test.separation});
+    }
+}
+
+// Wyspy = spójne składowe grafu kontaktów między ciałami kroku (statyczne i śpiące nie łączą wysp).
+// Każda wyspa idzie do solvera jako ciągły zakres ciał z własnymi kontaktami.
+void PhysicsWorld::buildIslands() {
+    const size_t count = stepBodies.size();
+    for (int b : stepBodies) islandParent[b] = b;
+    for (const Pair& p : pairs)
+        if (solverSlot[p.b] != -1) {
+            int ra = findRoot(p.a), rb = findRoot(p.b);
+            if (ra != rb) islandParent[ra] = rb;
+        }
+
+    int islandCount = 0;
+    stepIsland.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        int r = findRoot(stepBodies[k]);
+        if (islandHead[r] == -1) islandHead[r] = islandCount++;
+        stepIsland[k] = islandHead[r];
+    }
+    for (int b : stepBodies) islandHead[findRoot(b)] = -1;
+
+    // Sortowanie przez zliczanie: ciała i pary po numerze wyspy
+    islandStart.assign((size_t)islandCount + 1, 0);
+    for (size_t k = 0; k < count; ++k) islandStart[stepIsland[k] + 1]++;
+    for (int i = 0; i < islandCount; ++i) islandStart[i + 1] += islandStart[i];
+    islandOrder.resize(count);
+    std::vector<int> cursor(islandStart.begin(), islandStart.end() - 1);
+    for (size_t k = 0; k < count; ++k) islandOrder[cursor[stepIsland[k]]++] = stepBodies[k];
+    std::vector<int> pairStart((size_t)islandCount + 1, 0);
+    for (const Pair& p : pairs) pairStart[stepIsland[solverSlot[p.a]] + 1]++;
+    for (int i = 0; i < islandCount; ++i) pairStart[i + 1] += pairStart[i];
+    pairOrder.resize(pairs.size());
+    cursor.assign(pairStart.begin(), pairStart.end() - 1);
+    for (size_t i = 0; i < pairs.size(); ++i) pairOrder[cursor[stepIsland[solverSlot[pairs[i].a]]]++] = (int)i;
+
+    solver.begin();
+    for (int i = 0; i < islandCount; ++i) {
+        int staticSlot = solver.beginIsland();
+        for (int k = islandStart[i]; k < islandStart[i + 1]; ++k) {
+            int b = islandOrder[k];
+            const uint16_t f = flags[b];
+            Vec3 im((f & Body_LockX) ? 0.0f : invMass[b], (f & Body_LockY) ? 0.0f : invMass[b], (f & Body_LockZ) ? 0.0f : invMass[b]);
+            solverSlot[b] = solver.addBody(Vec3(vx[b], vy[b], vz[b]), im);
+        }
+        for (int k = pairStart[i]; k < pairStart[i + 1]; ++k) {
+            const Pair& p = pairs[pairOrder[k]];
+            // Dłuższy z dwóch kroków: ciało nadrabiające czas nie może przelecieć przez szczelinę kontaktu spekulatywnego
+            solver.addContact(solverSlot[p.a], solverSlot[p.b] >= 0 ? solverSlot[p.b] : staticSlot, p.normal, p.separation,
+                              std::max(stepDt[p.a], stepDt[p.b]), pairKey(entity[p.a], entity[p.b]));
+        }
+        solver.endIsland();
+    }
+}
+
+// Wyspa zasypia, gdy każde jej ciało jest wolne od SLEEP_TIME; śpiąca wyspa = lista cykliczna do budzenia
+void PhysicsWorld::updateIslands() {
+    const size_t count = stepBodies.size();
+    const size_t islandCount = islandStart.empty() ? 0 : islandStart.size() - 1;
+    islandMinTimer.assign(islandCount, SLEEP_TIME);
+    islandFirst.assign(islandCount, -1);
+    for (size_t k = 0; k < count; ++k) {
+        int b = stepBodies[k];
+        float speed2 = vx[b] * vx[b] + vy[b] * vy[b] + vz[b] * vz[b];
+        if ((flags[b] & Body_Player) || speed2 > SLEEP_SPEED * SLEEP_SPEED) sleepTimer[b] = 0.0f;
+        else sleepTimer[b] += stepDt[b];
+        float timer = (flags[b] & Body_Player) ? -1.0f : sleepTimer[b];
+        islandMinTimer[stepIsland[k]] = std::min(islandMinTimer[stepIsland[k]], timer);
+    }
+
+    // Zasypiają tylko ciała kroku; obudzone w trakcie i pominięte przez LOD zostają nieśpiące
+    for (size_t k = 0; k < count; ++k) {
+        if (islandMinTimer[stepIsland[k]] < SLEEP_TIME) continue;
+        int b = stepBodies[k];
+        int island = stepIsland[k];
+        awake[b] = 0;
+        gravityScale[b] = 0.0f;
+        stepDt[b] = 0.0f;
+        if (vx[b] != 0.0f || vy[b] != 0.0f || vz[b] != 0.0f) {
+            vx[b] = vy[b] = vz[b] = 0.0f;
+            if (!moved[b]) { moved[b] = 1; movedBodies.push_back(b); }
+        }
+        if (islandFirst[island] == -1) { islandFirst[island] = b; islandNext[b] = b; }
+        else { islandNext[b] = islandNext[islandFirst[island]]; islandNext[islandFirst[island]] = b; }
+    }
+    size_t kept = 0;
+    for (int b : awakeBodies) if (awake[b]) awakeBodies[kept++] = b;
+    awakeBodies.resize(kept);
+}
+
+// ==========================================
+// STREFY (TRIGGERY)
+// ==========================================
+void PhysicsWorld::markTriggerDirty(int b) {
+    if (triggerDirty[b] || !(flags[b] & Body_Collider) || (triggerCount == 0 && triggerPairIndex.empty())) return;
+    triggerDirty[b] = 1;
+    dirtyBodies.push_back(b);
+}
+
+int PhysicsWorld::addTriggerPair(int t, int o) {
+    int pair;
+    if (!freeTriggerPairs.empty()) { pair = freeTriggerPairs.back(); freeTriggerPairs.pop_back(); }
+    else { pair = (int)triggerPairs.size(); triggerPairs.emplace_back(); }
+    triggerPairs[pair] = { t, o, entity[t], entity[o], triggerStep, triggerFrame };
+    triggerPairIndex[pairKey(entity[t], entity[o])] = pair;
+    triggerLinks[t].push_back(pair);
+    triggerLinks[o].push_back(pair);
+    triggerEvents.push_back({ entity[t], entity[o], TriggerEventType::Enter });
+    return pair;
+}
+
+void PhysicsWorld::removeTriggerPair(int pair) {
+    TriggerPair& p = triggerPairs[pair];
+    triggerEvents.push_back({ p.triggerId, p.otherId, TriggerEventType::Exit });
+    triggerPairIndex.erase(pairKey(p.triggerId, p.otherId));
+    for (int b : { p.trigger, p.other }) {
+        std::vector<int>& links = triggerLinks[b];
+        *std::find(links.begin(), links.end(), pair) = links.back();
+        links.pop_back();
+    }
+    p.trigger = -1;
+    freeTriggerPairs.push_back(pair);
+}
+
+// Para może zmienić stan tylko wtedy, gdy jedno z jej ciał się ruszyło, więc sprawdzamy wyłącznie ciała
+// z dirtyBodies: ich nowych sąsiadów z drugiego drzewa i ich dotychczasowe pary (te, których zapytanie
+// nie znalazło, już się nie przecinają). Stojące ciało w stojącej strefie nie kosztuje nic.
+void PhysicsWorld::updateTriggers() {
+    triggerStep++;
+    for (int b : dirtyBodies) {
+        triggerDirty[b] = 0;
+        if (flags[b] & Body_Collider) {
+            const bool isTrigger = (flags[b] & Body_Trigger) != 0;
+            const int root = ownerId[b] != -1 ? ownerId[b] : entity[b];
+            const Aabb box = bounds(b);
+            (isTrigger ? tree : triggerTree).query(box, [&](int other) {
+                if ((ownerId[other] != -1 ? ownerId[other] : entity[other]) == root) return true;
+                const int t = isTrigger ? b : other, o = isTrigger ? other : b;
+                auto it = triggerPairIndex.find(pairKey(entity[t], entity[o]));
+                int pair = it != triggerPairIndex.end() ? it->second : -1;
+                if (pair >= 0 && triggerPairs[pair].seen == triggerStep) return true; // sprawdzona już z drugiej strony
+                triggerTests++;
+                bool inside = box.overlaps(bounds(other)) && narrowphase(t, o).separation < 0.0f;
+                if (inside) {
+                    if (pair < 0) pair = addTriggerPair(t, o);
+                    triggerPairs[pair].seen = triggerStep;
+                } else if (pair >= 0) removeTriggerPair(pair);
+                return true;
+            });
+        }
+        std::vector<int>& links = triggerLinks[b];
+        for (size_t i = 0; i < links.size();) {
+            if (triggerPairs[links[i]].seen == triggerStep) ++i;
+            else removeTriggerPair(links[i]); // zdejmuje ją z `links`
+        }
+    }
+    dirtyBodies.clear();
+}
+
+// ==========================================
+// CCD
+// ==========================================
+// Promień ze środka ciała przez collidery powiększone o jego połówki (suma Minkowskiego dwóch AABB).
+// Kandydaci z drzewa dla AABB całego odcinka. Po trafieniu ciało staje tuż przed powierzchnią, traci prędkość
+// wzdłuż normalnej i ślizga się pozostałym czasem. Ciała, które już się przenikają, zostawiamy solverowi.
+void PhysicsWorld::sweep(int b, float dt) {
+    const uint16_t f = flags[b];
+    float remaining = dt;
+    for (int pass = 0; pass < SWEEP_PASSES && remaining > 0.0f; ++pass) {
+        const float dx = (f & Body_LockX) ? 0.0f : vx[b] * remaining;
+        const float dy = (f & Body_LockY) ? 0.0f : vy[b] * remaining;
+        const float dz = (f & Body_LockZ) ? 0.0f : vz[b] * remaining;
+        if (dx == 0.0f && dy == 0.0f && dz == 0.0f) return;
+
+        Aabb from = bounds(b);
+        Aabb to = { Vec3(from.min.x + dx, from.min.y + dy, from.min.z + dz), Vec3(from.max.x + dx, from.max.y + dy, from.max.z + dz) };
+        float toi = 1.0f;
+        int hit = -1, hitAxis = 0;
+        tree.query(Aabb::merge(from, to), [&](int other) {
+            if (other == b || ownerId[other] == entity[b]) return true;
+            const float o[3] = { px[b], py[b], pz[b] };
+            const float d[3] = { dx, dy, dz };
+            const float c[3] = { px[other], py[other], pz[other] };
+            const float e[3] = { hx[other] + hx[b], hy[other] + hy[b], hz[other] + hz[b] };
+            float enter = -1e30f, exit = 1e30f;
+            int axis = 0;
+            for (int k = 0; k < 3; ++k) {
+                float lo = c[k] - e[k] - o[k], hi = c[k] + e[k] - o[k];
+                if (d[k] == 0.0f) {
+                    if (lo > 0.0f || hi < 0.0f) return true;
+                    continue;
+                }
+                float t0 = lo / d[k], t1 = hi / d[k];
+                if (t0 > t1) std::swap(t0, t1);
+                if (t0 > enter) { enter = t0; axis = k; }
+                exit = std::min(exit, t1);
+            }
+            if (enter >= 0.0f && enter < exit && enter < toi) { toi = enter; hit = other; hitAxis = axis; }
+            return true;
+        });
+
+        if (hit < 0) { px[b] += dx; py[b] += dy; pz[b] += dz; return; }
+        const float len = std::sqrt(dx * dx + dy * dy + dz * dz);
+        const float t = std::max(0.0f, toi - SWEEP_SKIN / len);
+        px[b] += dx * t; py[b] += dy * t; pz[b] += dz * t;
+        // Normalna = oś wejścia; zostaje tylko ruch styczny
+        if (hitAxis == 0) vx[b] = 0.0f; else if (hitAxis == 1) vy[b] = 0.0f; else vz[b] = 0.0f;
+        wake(hit);
+        sweepHits++;
+        remaining *= 1.0f - toi;
+    }
+}
+
+// ==========================================
+// RAYCASTY
+// ==========================================
+static const int RAY_PACKETS_PER_TASK = 16;
+
+void PhysicsWorld::raycastPacket(const Ray* rays, RayHit* hits, int lanes, const RayFilter& filter) const {
+    RayPacket packet;
+    auto inverse = [](float d) { return std::abs(d) > 1e-12f ? 1.0f / d : (d < 0.0f ? -1e30f : 1e30f); };
+    for (int l = 0; l < 4; ++l) {
+        const Ray& r = rays[l < lanes ? l : 0];
+        packet.ox[l] = r.origin.x; packet.oy[l] = r.origin.y; packet.oz[l] = r.origin.z;
+        packet.ix[l] = inverse(r.direction.x); packet.iy[l] = inverse(r.direction.y); packet.iz[l] = inverse(r.direction.z);
+        packet.tMax[l] = l < lanes ? r.maxDistance : -1e30f;
+        if (l < lanes) hits[l] = RayHit();
+    }
+
+    tree.raycast(packet, [&](int body, int mask) {
+        if ((tagFlags[body] & filter.require) != filter.require || (tagFlags[body] & filter.exclude)) return;
+        if (flags[body] & (Body_Rotated | Body_Hull)) {
+            const ConvexShape shape = convexOf(body);
+            for (int l = 0; l < lanes; ++l) {
+                if (!(mask & (1 << l))) continue;
+                const Ray& r = rays[l];
+                float distance;
+                Vec3 normal;
+                if (!rayHull(shape, r.origin, r.direction, packet.tMax[l], distance, normal)) continue;
+                packet.tMax[l] = distance;
+                hits[l].id = entity[body];
+                hits[l].distance = distance;
+                hits[l].normal = normal;
+            }
+            return;
+        }
+        const float lo[3] = { px[body] - hx[body], py[body] - hy[body], pz[body] - hz[body] };
+        const float hi[3] = { px[body] + hx[body], py[body] + hy[body], pz[body] + hz[body] };
+        for (int l = 0; l < lanes; ++l) {
+            if (!(mask & (1 << l))) continue;
+            const float o[3] = { packet.ox[l], packet.oy[l], packet.oz[l] };
+            const float inv[3] = { packet.ix[l], packet.iy[l], packet.iz[l] };
+            float tNear = -1e30f, tFar = 1e30f;
+            int axis = 0;
+            for (int k = 0; k < 3; ++k) {
+                float t1 = (lo[k] - o[k]) * inv[k], t2 = (hi[k] - o[k]) * inv[k];
+                float tk = std::min(t1, t2);
+                if (tk > tNear) { tNear = tk; axis = k; }
+                tFar = std::min(tFar, std::max(t1, t2));
+            }
+            if (tNear < 0.0f || tNear > tFar || tNear >= packet.tMax[l]) continue;
+            packet.tMax[l] = tNear;
+            RayHit& hit = hits[l];
+            hit.id = entity[body];
+            hit.distance = tNear;
+            hit.normal = Vec3();
+            float n = inv[axis] < 0.0f ? 1.0f : -1.0f;
+            if (axis == 0) hit.normal.x = n; else if (axis == 1) hit.normal.y = n; else hit.normal.z = n;
+        }
+    });
+}
+
+void PhysicsWorld::raycast(const Ray* rays, RayHit* hits, size_t count, const RayFilter& filter, JobSystem& jobs) const {
+    size_t packets = (count + 3) / 4;
+    jobs.parallelFor(packets, RAY_PACKETS_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            size_t first = p * 4;
+            raycastPacket(rays + first, hits + first, (int)std::min<size_t>(4, count - first), filter);
+        }
+    });
+}
+
+RayHit PhysicsWorld::raycast(const Ray& ray, const RayFilter& filter) const {
+    RayHit hit;
+    raycastPacket(&ray, &hit, 1, filter);
+    return hit;
+}
+
+// ==========================================
+// LOD SYMULACJI
+// ==========================================
+// Poziom z odległości do najbliższego widza (od brzegu ciała, nie od środka) i widoczności w którymś stożku.
+// Na rzadszy poziom ciało schodzi dopiero LOD_HYSTERESIS za granicą i nie w trakcie lodHold, na gęstszy - od razu.
+void PhysicsWorld::updateLod(const LodViewer* viewers, size_t count) {
+    for (int t = 0; t < SIM_TIERS; ++t) tierCounts[t] = 0;
+    if (!lod.enabled) { tierCounts[Tier_Full] = awakeBodies.size(); return; }
+    const float nearDistance = lod.nearDistance * lodScale, farDistance = lod.farDistance * lodScale;
+    auto tierFor = [&](float distance, bool visible) {
+        if (distance < nearDistance) return (int)Tier_Full;
+        if (distance < farDistance) return visible ? (int)Tier_Half : (int)Tier_Quarter;
+        return visible ? (int)Tier_Quarter : (int)Tier_Frozen;
+    };
+    for (int b : awakeBodies) {
+        int tier = Tier_Full;
+        if (!(flags[b] & Body_Player) && count > 0) {
+            const Vec3 p(px[b], py[b], pz[b]);
+            const float radius = std::sqrt(hx[b] * hx[b] + hy[b] * hy[b] + hz[b] * hz[b]);
+            float nearest = 1e30f;
+            bool visible = false;
+            for (size_t v = 0; v < count; ++v) {
+                const LodViewer& viewer = viewers[v];
+                const Vec3 d = p - viewer.position;
+                const float distance = d.length();
+                nearest = std::min(nearest, distance - radius);
+                if (viewer.viewCos <= 1.0f && distance - radius < viewer.viewDistance && d.dot(viewer.forward) >= viewer.viewCos * distance - radius) visible = true;
+            }
+            tier = tierFor(nearest, visible);
+            if (tier > lodTier[b]) tier = lodHold[b] ? lodTier[b] : std::max<int>(lodTier[b], tierFor(nearest - LOD_HYSTERESIS, visible));
+        }
+        lodTier[b] = (uint8_t)tier;
+        tierCounts[tier]++;
+    }
+}
+
+// Poziom 1/2 wypada w krokach nieparzystych, 1/4 w co czwartym parzystym - rzadsze poziomy nie spotykają się
+// w jednym kroku. Ciało dostaje cały czas zebrany od swojego poprzedniego kroku; zamrożone nie zbiera nic.
+void PhysicsWorld::collectStepBodies(float dt) {
+    lodStep++;
+    stepBodies.clear();
+    for (int b : awakeBodies) {
+        const int tier = lod.enabled ? (int)lodTier[b] : (int)Tier_Full;
+        if (lodHold[b]) lodHold[b]--;
+        stepDt[b] = 0.0f;
+        if (tier == Tier_Frozen) continue;
+        lodTime[b] += dt;
+        const uint32_t stride = 1u << tier;
+        if (lodStep % stride != stride / 2) continue;
+        stepDt[b] = lodTime[b];
+        lodTime[b] = 0.0f;
+        stepBodies.push_back(b);
+    }
+}
+
+// ==========================================
+// KROK SYMULACJI
+// ==========================================
+// Kontroler budżetu: średni czas fizyki na klatkę ponad `lod.budgetMs` zwęża odległości LOD o 10% na klatkę,
+// wyraźnie poniżej - rozszerza je z powrotem powoli (bez oscylacji na granicy budżetu)
+int PhysicsWorld::simulate(float frameTime, JobSystem& jobs) {
+    frameSteps = 0;
+    float frameMs = 0.0f;
+    if (deterministic) {
+        step(fixedStep, jobs);
+        frameMs += lastStepMs;
+        frameSteps = 1;
+    } else {
+        accumulator += frameTime;
+        while (accumulator >= fixedStep && frameSteps < maxSubSteps) {
+            step(fixedStep, jobs);
+            frameMs += lastStepMs;
+            accumulator -= fixedStep;
+            frameSteps++;
+        }
+        if (accumulator >= fixedStep) accumulator = 0.0f;
+    }
+    if (lod.enabled && lod.budgetMs > 0.0f && !deterministic && frameSteps > 0) {
+        lodFrameMs = lodFrameMs * 0.8f + frameMs * 0.2f;
+        if (lodFrameMs > lod.budgetMs) lodScale = std::max(LOD_MIN_SCALE, lodScale * 0.9f);
+        else if (lodFrameMs < lod.budgetMs * 0.7f) lodScale = std::min(1.0f, lodScale * 1.02f);
+    }
+    for (const TriggerPair& p : triggerPairs)
+        if (p.trigger != -1 && p.enteredFrame != triggerFrame) triggerEvents.push_back({ p.triggerId, p.otherId, TriggerEventType::Stay });
+    return frameSteps;
+}
+
+void PhysicsWorld::step(float dt, JobSystem& jobs) {
+    auto start = std::chrono::steady_clock::now();
+    auto phase = start;
+    auto lap = [&phase](float& ms) {
+        auto now = std::chrono::steady_clock::now();
+        ms = std::chrono::duration<float, std::milli>(now - phase).count();
+        phase = now;
+    };
+    const size_t n = entity.size();
+    sweepHits = 0;
+    // Ciała obudzone w trakcie trafiają na koniec listy i ruszą się dopiero w następnym kroku
+    collectStepBodies(dt);
+    const size_t count = stepBodies.size();
+    solver.cacheSteps = lod.enabled ? 4 : 1; // kontakt ciała 1/4 wraca co 4 kroki
+
+    // 1. Grawitacja dla wszystkich ciał naraz (statyczne, śpiące i pominięte przez LOD mają stepDt = 0)
+    size_t i = 0;
+#ifdef DUCKY_SSE
+    const __m128 G = _mm_set1_ps(GRAVITY);
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(&vy[i], _mm_sub_ps(_mm_loadu_ps(&vy[i]), _mm_mul_ps(_mm_mul_ps(G, _mm_loadu_ps(&stepDt[i])), _mm_loadu_ps(&gravityScale[i]))));
+#endif
+    for (; i < n; ++i) vy[i] -= GRAVITY * stepDt[i] * gravityScale[i];
+    lap(timings.gravity);
+
+    // 2. Kontakty, wyspy, impulsy (solverSlot = indeks kroku do czasu przydziału slotów solvera)
+    for (size_t k = 0; k < count; ++k) solverSlot[stepBodies[k]] = (int)k;
+    findCandidates();
+    lap(timings.broadphase);
+    findContacts();
+    lap(timings.narrowphase);
+    buildIslands();
+    lap(timings.islands);
+    solver.solve(jobs);
+    lap(timings.solve);
+
+    // 3. Całkowanie pozycji
+    for (int b : stepBodies) {
+        const uint16_t f = flags[b];
+        const float bdt = stepDt[b];
+        const float ox = px[b], oy = py[b], oz = pz[b];
+        const float ovx = vx[b], ovy = vy[b] + GRAVITY * bdt * gravityScale[b], ovz = vz[b];
+        Vec3 v = solver.getVelocity(solverSlot[b]);
+        vx[b] = v.x; vy[b] = v.y; vz[b] = v.z;
+        if ((f & Body_Player) || std::abs(v.x) >= REST_SPEED || std::abs(v.y) >= REST_SPEED || std::abs(v.z) >= REST_SPEED) {
+            if (f & Body_Continuous) sweep(b, bdt);
+            else {
+                if (!(f & Body_LockX)) px[b] += v.x * bdt;
+                if (!(f & Body_LockY)) py[b] += v.y * bdt;
+                if (!(f & Body_LockZ)) pz[b] += v.z * bdt;
+            }
+            // Tłumienie jest na krok - ciało nadrabiające kilka kroków naraz dostaje je tyle razy
+            const float d = bdt == dt ? damping[b] : std::pow(damping[b], bdt / dt);
+            vx[b] *= d; vz[b] *= d;
+        }
+        bool changed = px[b] != ox || py[b] != oy || pz[b] != oz || vx[b] != ovx || vy[b] != ovy || vz[b] != ovz;
+        if (changed && !moved[b]) { moved[b] = 1; movedBodies.push_back(b); }
+        if (px[b] != ox || py[b] != oy || pz[b] != oz) { updateProxy(b); markTriggerDirty(b); }
+    }
+    for (int b : stepBodies) solverSlot[b] = -1;
+    lap(timings.integrate);
+
+    // 4. Strefy - tylko pary ciał, które się ruszyły
+    updateTriggers();
+    lap(timings.triggers);
+
+    // 5. Usypianie
+    updateIslands();
+    lap(timings.sleep);
+    lastStepMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ==========================================
+// SYNC FIZYKA -> ECS
+// ==========================================
+void PhysicsWorld::writeBack(World& world) {
+    movedCount = movedBodies.size();
+    for (int b : movedBodies) {
+        int id = entity[b];
+        world.get<Transform>(id)->position = Vec3(px[b], py[b], pz[b]);
+        world.get<PhysicsBody>(id)->velocity = Vec3(vx[b], vy[b], vz[b]);
+        world.markMoved(id);
+        moved[b] = 0;
+    }
+    movedBodies.clear();
+}
@@ -0,0 +1,255 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "AabbTree.hpp"
+#include "ContactSolver.hpp"
+#include "Gjk.hpp"
+#include "Obb.hpp"
+#include "../math/Vec3.hpp"
+
+class World;
+class JobSystem;
+
+enum BodyFlags : uint16_t {
+    Body_Dynamic  = 1u << 0, // ma PhysicsBody i jest korzeniem hierarchii
+    Body_Collider = 1u << 1,
+    Body_LockX    = 1u << 2,
+    Body_LockY    = 1u << 3,
+    Body_LockZ    = 1u << 4,
+    Body_Player   = 1u << 5, // bez tłumienia, ruch zawsze sprawdzany, nigdy nie zasypia
+    Body_Child    = 1u << 6, // collider dziecka - granice z macierzy świata
+    Body_Gravity  = 1u << 7,
+    Body_Continuous = 1u << 8, // CCD: ruch sprawdzany całym odcinkiem (sweep), bez kontaktów spekulatywnych
+    Body_Rotated    = 1u << 9, // collider nie jest równoległy do osi świata - para idzie przez SAT
+    Body_Hull       = 1u << 10, // otoczka wypukła modelu - para idzie przez GJK/EPA
+    Body_Trigger    = 1u << 11  // strefa w osobnym drzewie: bez kontaktów, CCD i raycastów
+};
+
+struct Ray {
+    Vec3 origin;
+    Vec3 direction;         // znormalizowany - odległość trafienia jest wtedy w metrach
+    float maxDistance = 1000.0f;
+};
+
+struct RayHit {
+    int id = -1;            // encja, -1 = pudło
+    float distance = 0.0f;
+    Vec3 normal;
+};
+
+enum class TriggerEventType : uint8_t { Enter, Stay, Exit };
+
+// Encje strefy i ciała, które do niej weszło / w niej jest / z niej wyszło
+struct TriggerEvent {
+    int trigger;
+    int other;
+    TriggerEventType type;
+};
+
+// Czasy faz ostatniego kroku (ms)
+struct StepTimings {
+    float gravity = 0.0f, broadphase = 0.0f, narrowphase = 0.0f, islands = 0.0f, solve = 0.0f, integrate = 0.0f, triggers = 0.0f, sleep = 0.0f;
+};
+
+// Poziom szczegółowości symulacji ciała: krok fizyki co 1, 2 albo 4 kroki świata albo wcale
+enum SimTier : uint8_t { Tier_Full = 0, Tier_Half = 1, Tier_Quarter = 2, Tier_Frozen = 3 };
+static const int SIM_TIERS = 4;
+
+// Punkt, od którego liczy się odległość ciał (kamera, gracz). Kamera ma też stożek widzenia.
+struct LodViewer {
+    Vec3 position;
+    Vec3 forward;               // znormalizowany
+    float viewCos = 2.0f;       // cos połowy kąta stożka; > 1 = bez widoczności, tylko odległość (gracz)
+    float viewDistance = 0.0f;  // dalej nic nie jest widoczne (daleka płaszczyzna)
+};
+
+struct SimulationLod {
+    bool enabled = false;
+    float nearDistance = 25.0f; // bliżej któregokolwiek widza: zawsze pełny krok
+    float farDistance = 80.0f;  // do tej odległości widoczne co 2 kroki, niewidoczne co 4; dalej co 4 albo zamrożone
+    float budgetMs = 4.0f;      // czas fizyki na klatkę - przekroczony zwęża odległości (0 = bez limitu)
+};
+
+// Filtr po Tag::flags: ciało musi mieć wszystkie bity `require` i żadnego z `exclude`
+struct RayFilter {
+    uint32_t require = 0;
+    uint32_t exclude = 0;
+};
+
+// --- ŚWIAT FIZYKI (SoA) ---
+// Własna kopia ciał w osobnych tablicach (pozycje, prędkości, odwrotna masa, flagi, połówki wymiarów),
+// więc krok symulacji nie dotyka nazw, materiałów ani ścieżek. ECS jest źródłem edycji:
+// sync() przebudowuje wszystko po zmianie struktury świata, a w zwykłej klatce czyta tylko encje z touch().
+// writeBack() zapisuje do ECS wyłącznie ciała, które się ruszyły albo zmieniły prędkość.
+//
+// Collider = OBB z macierzy modelu (obrót i skala) albo otoczka wypukła z MeshRenderer::hull (modele);
+// drzewo i sweep CCD używają otaczającego go AABB. Pary z otoczką liczy GJK/EPA z simpleksem z poprzedniego kroku.
+// Krok: grawitacja -> kontakty z drzewa AABB (także spekulatywne, na odległość ruchu w tym kroku) -> wyspy
+// -> ContactSolver (impulsy, wyspy równolegle) -> całkowanie pozycji (ciała CCD: sweep do chwili zderzenia) -> usypianie.
+// simulate() dzieli czas klatki na stałe kroki `fixedStep` (z limitem kroków na klatkę).
+// Tryb `deterministic`: dokładnie jeden krok na wywołanie simulate(), bez zależności od czasu klatki.
+// Ciała są zawsze ułożone po id encji (nie po kolejności obiektów w scenie), wyspy nie dzielą stanu między
+// workerami, a reset() zaczyna od pustych cache - ten sam stan startowy i te same wejścia dają ten sam wynik bit w bit.
+//
+// Strefy (Collider::trigger) leżą w osobnym drzewie. Stan par (strefa, ciało) jest pamiętany między krokami
+// i sprawdzany tylko dla ciał, które się w tym kroku ruszyły: poruszony zwykły collider pyta drzewo stref,
+// poruszona strefa - drzewo colliderów. Wejścia i wyjścia trafiają do listy zdarzeń w chwili zmiany,
+// a raz na klatkę (koniec simulate()) każda trwająca para dostaje Stay. Lista żyje od sync() do następnego sync().
+//
+// LOD symulacji (`lod`): updateLod() przydziela nieśpiącym ciałom poziom z odległości do widzów i widoczności.
+// Ciało poza pełnym poziomem zbiera czas i nadrabia go jednym dłuższym krokiem, gdy przyjdzie jego kolej
+// (poziomy 1/2 i 1/4 wypadają w różnych krokach), więc zmiana poziomu nie gubi ani nie dubluje czasu.
+// Zamrożone ciało stoi z zachowaną prędkością (i nie zasypia). Gracz ma zawsze pełny poziom; kontakt z ciałem
+// gęstszego poziomu albo touch() przenoszą ciało wyżej na LOD_HOLD_STEPS kroków - popchnięta sterta dogania popychającego.
+// Kontroler budżetu skaluje odległości, gdy czas fizyki na klatkę przekracza `lod.budgetMs`
+// (w trybie deterministic wyłączony - poziomy zależą wtedy tylko od pozycji widzów).
+//
+// Usypianie: ciała połączone kontaktami tworzą wyspę. Wyspa zasypia, gdy wszystkie jej ciała są wolniejsze
+// niż SLEEP_SPEED przez SLEEP_TIME; śpiące ciała nie są w ogóle odwiedzane przez step(). Budzi je touch()
+// (gizmo, inspektor, strzał), zderzenie z ciałem nieśpiącym albo zmiana/usunięcie ciała, na którym leżą.
+class PhysicsWorld {
+public:
+    void sync(World& world);
+    int simulate(float frameTime, JobSystem& jobs); // zwraca liczbę wykonanych kroków
+    void step(float dt, JobSystem& jobs);
+    void writeBack(World& world);
+    void wakeAll();
+    void reset(); // zapomina ciała, uśpienie, pary stref i cache; następny sync() buduje wszystko od zera
+    uint64_t stateHash() const; // skrót pozycji, prędkości i uśpienia (porównanie przebiegów)
+    void updateLod(const LodViewer* viewers, size_t count); // poziomy nieśpiących ciał, przed simulate()
+
+    // Promienie w paczkach po 4 (SSE) przez drzewo AABB, paczki rozdzielone między workery.
+    // Trafienie = najbliższy collider (pudełko albo otoczka), którego promień nie zaczyna się w środku.
+    void raycast(const Ray* rays, RayHit* hits, size_t count, const RayFilter& filter, JobSystem& jobs) const;
+    RayHit raycast(const Ray& ray, const RayFilter& filter = RayFilter()) const;
+
+    int bodyOf(int id) const { return id >= 0 && (size_t)id < bodyIndex.size() ? bodyIndex[id] : -1; }
+    bool isSleeping(int id) const { int b = bodyOf(id); return b >= 0 && (flags[b] & Body_Dynamic) && !awake[b]; }
+    size_t getBodyCount() const { return entity.size(); }
+    size_t getAwakeCount() const { return awakeBodies.size(); }
+    size_t getMovedCount() const { return movedCount; }
+    float getLastStepMs() const { return lastStepMs; }
+    const StepTimings& getStepTimings() const { return timings; }
+    int getFrameSteps() const { return frameSteps; }
+    size_t getSweepHits() const { return sweepHits; }
+    size_t getCandidateCount() const { return candidates.size(); } // pary z broadphase w ostatnim kroku
+    size_t getPairCount() const { return pairs.size(); }           // kontakty po narrowphase
+    const std::vector<TriggerEvent>& getTriggerEvents() const { return triggerEvents; }
+    size_t getTriggerPairCount() const { return triggerPairIndex.size(); }
+    size_t getTriggerTests() const { return triggerTests; } // testy par stref w ostatniej klatce
+    int getSimTier(int id) const { int b = bodyOf(id); return b >= 0 ? (int)lodTier[b] : (int)Tier_Full; }
+    size_t getTierCount(int tier) const { return tierCounts[tier]; } // ciała nieśpiące na poziomie przy ostatnim updateLod()
+    float getLodScale() const { return lodScale; }                  // mnożnik odległości z kontrolera budżetu
+    ContactSolver& getSolver() { return solver; }
+    const ContactSolver& getSolver() const { return solver; }
+
+    float fixedStep = 1.0f / 60.0f;
+    int maxSubSteps = 4; // nadmiar czasu ponad to przepada (brak spirali śmierci przy długich klatkach)
+    bool deterministic = false;
+    SimulationLod lod;
+
+private:
+    void rebuild(World& world);
+    void pull(World& world, int body);
+    void refreshChildBounds(World& world);
+    Aabb bounds(int body) const;
+    Obb shapeOf(int body) const;
+    ConvexShape convexOf(int body) const;
+    void setShape(int body, const float* matrix, const Vec3& halfExtents);
+    SatResult convexTest(int a, int b);    // GJK/EPA z rozgrzanym simpleksem
+    SatResult narrowphase(int a, int b);   // OBB/otoczka/AABB zależnie od flag pary
+    AabbTree& treeOf(int body) { return (flags[body] & Body_Trigger) ? triggerTree : tree; }
+    void updateProxy(int body);
+    float reach(int body, float dt) const; // zasięg kontaktów spekulatywnych
+    void collectStepBodies(float dt);      // nieśpiące ciała, na które przypada ten krok, + ich dt
+    void findCandidates();                 // broadphase
+    void findContacts();                   // narrowphase kandydatów
+    void sweep(int body, float dt);        // ruch ciała CCD z zatrzymaniem na pierwszym colliderze
+    void raycastPacket(const Ray* rays, RayHit* hits, int lanes, const RayFilter& filter) const;
+    void buildIslands();
+    void wake(int body);                   // budzi całą wyspę
+    void wakeOverlapping(const Aabb& box);
+    void updateIslands();
+    int findRoot(int body);
+    void markTriggerDirty(int body);
+    void updateTriggers();                 // pary stref dla ciał z triggerDirty
+    int addTriggerPair(int trigger, int other);
+    void removeTriggerPair(int pair);      // + zdarzenie Exit
+
+    struct Pair { int a, b; Vec3 normal; float separation; };
+    struct Candidate { int b, other; float reach; };
+    // Para stref w puli z wolnymi slotami (trigger == -1); ciała po indeksie, encje dla zdarzeń i przebudowy
+    struct TriggerPair { int trigger, other; int triggerId, otherId; uint32_t seen, enteredFrame; };
+
+    // SoA - indeks = ciało
+    std::vector<int> entity;
+    std::vector<float> px, py, pz;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> invMass;
+    std::vector<float> hx, hy, hz;       // połówki AABB otaczającego OBB (tylko collidery)
+    std::vector<Obb> shapes;             // osie i połówki OBB (otoczka: osie i skala); środek = px/py/pz
+    std::vector<const ConvexHull*> hulls; // nullptr = pudełko; trzyma ją MeshRenderer::hull
+    std::vector<float> gravityScale;     // 1 = grawitacja działa teraz (dynamiczne, nieśpiące, bez blokady Y)
+    std::vector<float> damping;          // mnożnik prędkości X/Z na krok
+    std::vector<float> sleepTimer;
+    std::vector<uint16_t> flags;
+    std::vector<uint8_t> awake;
+    std::vector<uint8_t> moved;
+    std::vector<uint32_t> tagFlags;      // do filtrów raycastów
+    std::vector<int> ownerId;            // collider dziecka: encja korzenia (bez kontaktu z własnym ciałem)
+    std::vector<int> solverSlot;         // -1 = poza krokiem (statyczne dla solvera)
+    std::vector<int> proxy;              // liść w drzewie AABB (-1 = bez collidera)
+    std::vector<int> islandNext;         // śpiąca wyspa = lista cykliczna ciał
+    std::vector<int> islandParent;       // union-find (tylko na czas kroku)
+    std::vector<int> islandHead;         // korzeń -> numer wyspy kroku
+    std::vector<int> stepIsland;         // k-te nieśpiące ciało -> numer wyspy kroku
+    std::vector<int> islandOrder;        // ciała posortowane po wyspie
+    std::vector<int> islandStart;
+    std::vector<float> islandMinTimer;   // per wyspa kroku
+    std::vector<int> islandFirst;
+    std::vector<uint8_t> lodTier;        // SimTier
+    std::vector<uint16_t> lodHold;       // kroki, przez które ciało nie zejdzie na rzadszy poziom
+    std::vector<float> lodTime;          // czas od ostatniego kroku ciała (do nadrobienia)
+    std::vector<float> stepDt;           // dt ciała w bieżącym kroku (0 = poza krokiem)
+    std::vector<uint8_t> triggerDirty;   // ciało ruszyło się od ostatniego updateTriggers()
+    std::vector<std::vector<int>> triggerLinks; // ciało -> jego pary stref
+
+    std::vector<Candidate> candidates;
+    std::vector<Pair> pairs;
+    std::vector<int> pairOrder;
+    ContactSolver solver;
+    SimplexCache simplexCache;
+
+    std::vector<int> dynamicBodies;
+    std::vector<int> awakeBodies;
+    std::vector<int> stepBodies;         // nieśpiące ciała bieżącego kroku
+    std::vector<int> childBodies;
+    std::vector<int> movedBodies;        // do writeBack()
+    std::vector<int> dirtyBodies;        // do updateTriggers()
+    std::vector<int> bodyIndex;          // id encji -> ciało (-1 = brak)
+
+    std::vector<TriggerPair> triggerPairs;
+    std::vector<int> freeTriggerPairs;
+    std::unordered_map<uint64_t, int> triggerPairIndex; // klucz (encja strefy, encja ciała) -> para
+    std::vector<TriggerEvent> triggerEvents;
+
+    AabbTree tree;
+    AabbTree triggerTree;
+    size_t triggerCount = 0;
+    uint32_t triggerStep = 0;
+    uint32_t triggerFrame = 0;
+    size_t triggerTests = 0;
+    uint64_t structureVersion = ~0ull;
+    size_t movedCount = 0;
+    float lastStepMs = 0.0f;
+    StepTimings timings;
+    float accumulator = 0.0f;
+    int frameSteps = 0;
+    size_t sweepHits = 0;
+    uint32_t lodStep = 0;
+    float lodScale = 1.0f;
+    float lodFrameMs = 0.0f;             // średnia krocząca czasu fizyki na klatkę
+    size_t tierCounts[SIM_TIERS] = {};
+};
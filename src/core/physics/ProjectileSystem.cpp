@@ -0,0 +1,99 @@
+#include "ProjectileSystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "../jobs/JobSystem.hpp"
+#include "../math/Simd.hpp"
+
+static const float GRAVITY = 9.81f;         // jak w PhysicsWorld
+static const size_t PROJECTILE_GRAIN = 2048; // pociski na zadanie (wielokrotność 4)
+static const float MIN_MOVE = 1e-12f;
+
+ProjectileSystem::ProjectileSystem(size_t capacity) : capacity(capacity) {
+    for (auto* a : {&px, &py, &pz, &vx, &vy, &vz, &gravity, &life}) a->resize(capacity);
+    owner.resize(capacity);
+    rays.resize(capacity);
+    rayHits.resize(capacity);
+}
+
+bool ProjectileSystem::spawn(const Vec3& origin, const Vec3& velocity, float lifetime, int shooter, float gravityScale) {
+    if (count == capacity) return false;
+    size_t i = count++;
+    px[i] = origin.x; py[i] = origin.y; pz[i] = origin.z;
+    vx[i] = velocity.x; vy[i] = velocity.y; vz[i] = velocity.z;
+    gravity[i] = gravityScale;
+    life[i] = lifetime;
+    owner[i] = shooter;
+    return true;
+}
+
+void ProjectileSystem::clear() {
+    count = 0;
+    hits.clear();
+}
+
+// Promień = stara pozycja, znormalizowany kierunek ruchu, długość odcinka
+void ProjectileSystem::integrate(size_t begin, size_t end, float dt) {
+    size_t i = begin;
+#ifdef DUCKY_SSE
+    const __m128 DT = _mm_set1_ps(dt), GDT = _mm_set1_ps(GRAVITY * dt), EPS = _mm_set1_ps(MIN_MOVE);
+    alignas(16) float ox[4], oy[4], oz[4], dx[4], dy[4], dz[4], len[4];
+    for (; i + 4 <= end; i += 4) {
+        const __m128 x = _mm_loadu_ps(&px[i]), y = _mm_loadu_ps(&py[i]), z = _mm_loadu_ps(&pz[i]);
+        const __m128 velX = _mm_loadu_ps(&vx[i]);
+        const __m128 velY = _mm_sub_ps(_mm_loadu_ps(&vy[i]), _mm_mul_ps(GDT, _mm_loadu_ps(&gravity[i])));
+        const __m128 velZ = _mm_loadu_ps(&vz[i]);
+        const __m128 mx = _mm_mul_ps(velX, DT), my = _mm_mul_ps(velY, DT), mz = _mm_mul_ps(velZ, DT);
+        const __m128 l = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my)), _mm_mul_ps(mz, mz)));
+        const __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), _mm_max_ps(l, EPS));
+        _mm_storeu_ps(&vy[i], velY);
+        _mm_storeu_ps(&px[i], _mm_add_ps(x, mx));
+        _mm_storeu_ps(&py[i], _mm_add_ps(y, my));
+        _mm_storeu_ps(&pz[i], _mm_add_ps(z, mz));
+        _mm_storeu_ps(&life[i], _mm_sub_ps(_mm_loadu_ps(&life[i]), DT));
+        _mm_store_ps(len, l);
+        _mm_store_ps(dx, _mm_mul_ps(mx, inv)); _mm_store_ps(dy, _mm_mul_ps(my, inv)); _mm_store_ps(dz, _mm_mul_ps(mz, inv));
+        _mm_store_ps(ox, x); _mm_store_ps(oy, y); _mm_store_ps(oz, z);
+        for (int k = 0; k < 4; ++k) rays[i + k] = Ray{ Vec3(ox[k], oy[k], oz[k]), Vec3(dx[k], dy[k], dz[k]), len[k] };
+    }
+#endif
+    for (; i < end; ++i) {
+        vy[i] -= GRAVITY * dt * gravity[i];
+        const float mx = vx[i] * dt, my = vy[i] * dt, mz = vz[i] * dt;
+        const float l = std::sqrt(mx * mx + my * my + mz * mz);
+        const float inv = 1.0f / std::max(l, MIN_MOVE);
+        rays[i] = Ray{ Vec3(px[i], py[i], pz[i]), Vec3(mx * inv, my * inv, mz * inv), l };
+        px[i] += mx; py[i] += my; pz[i] += mz;
+        life[i] -= dt;
+    }
+}
+
+void ProjectileSystem::update(float dt, const PhysicsWorld& physics, JobSystem& jobs, const RayFilter& filter) {
+    auto start = std::chrono::steady_clock::now();
+    hits.clear();
+    if (count == 0) { lastUpdateMs = 0.0f; return; }
+
+    // 1. Ruch po 4 naraz, 2. odcinki przez broadphase paczkami po 4
+    jobs.parallelFor(count, PROJECTILE_GRAIN, [&](size_t begin, size_t end) { integrate(begin, end, dt); });
+    physics.raycast(rays.data(), rayHits.data(), count, filter, jobs);
+
+    // 3. Trafienia -> zdarzenia; trafione i wygasłe wypadają, reszta zsuwa się w miejscu
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const RayHit& h = rayHits[i];
+        if (h.id != -1) {
+            const Ray& r = rays[i];
+            hits.push_back({ owner[i], h.id, r.origin + r.direction * h.distance, h.normal, Vec3(vx[i], vy[i], vz[i]) });
+            continue;
+        }
+        if (life[i] <= 0.0f) continue;
+        if (kept != i) {
+            px[kept] = px[i]; py[kept] = py[i]; pz[kept] = pz[i];
+            vx[kept] = vx[i]; vy[kept] = vy[i]; vz[kept] = vz[i];
+            gravity[kept] = gravity[i]; life[kept] = life[i]; owner[kept] = owner[i];
+        }
+        kept++;
+    }
+    count = kept;
+    lastUpdateMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "PhysicsWorld.hpp"
+#include "../math/Vec3.hpp"
+
+class JobSystem;
+
+// Trafienie pocisku w collider (zdarzenie z ostatniego update())
+struct ProjectileHit {
+    int owner;      // encja strzelca (-1 = brak)
+    int target;     // trafiona encja
+    Vec3 point;
+    Vec3 normal;
+    Vec3 velocity;  // prędkość pocisku w chwili trafienia
+};
+
+// --- POCISKI ---
+// Pula o stałej pojemności, rezerwowana raz, w SoA: pozycja, prędkość, skala grawitacji, pozostały czas życia
+// i strzelec. Pocisk to punkt bez encji, nazwy i ciała fizyki. Żywe pociski leżą ciasno na początku tablic,
+// więc update() liczy je po 4 (SSE) w kawałkach na workerach: grawitacja, nowa pozycja, czas życia.
+// Odcinek ruchu z tego kroku idzie jako promień do PhysicsWorld::raycast() (paczki po 4 przez to samo drzewo
+// AABB co ciała), więc szybki pocisk nie przeleci przez cienką ścianę. Trafione i wygasłe wypadają w jednym
+// przejściu zachowującym kolejność - wynik nie zależy od liczby workerów.
+// Lista trafień żyje do następnego update().
+class ProjectileSystem {
+public:
+    explicit ProjectileSystem(size_t capacity = 65536);
+
+    // false = pula pełna (pocisk przepada)
+    bool spawn(const Vec3& origin, const Vec3& velocity, float lifetime, int owner = -1, float gravityScale = 1.0f);
+    void update(float dt, const PhysicsWorld& physics, JobSystem& jobs, const RayFilter& filter = RayFilter());
+    void clear();
+
+    size_t getCount() const { return count; }
+    size_t getCapacity() const { return capacity; }
+    const std::vector<ProjectileHit>& getHits() const { return hits; }
+    float getLastUpdateMs() const { return lastUpdateMs; }
+
+    // Pozycje żywych pocisków (getCount() pierwszych) - wprost do buforów instancji
+    const float* getX() const { return px.data(); }
+    const float* getY() const { return py.data(); }
+    const float* getZ() const { return pz.data(); }
+
+private:
+    void integrate(size_t begin, size_t end, float dt); // ruch + promienie odcinków dla [begin, end)
+
+    size_t capacity;
+    size_t count = 0;
+    std::vector<float> px, py, pz;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> gravity;  // skala grawitacji
+    std::vector<float> life;     // s do wygaśnięcia
+    std::vector<int> owner;
+
+    std::vector<Ray> rays;       // odcinek ruchu z ostatniego kroku, indeks = pocisk
+    std::vector<RayHit> rayHits;
+    std::vector<ProjectileHit> hits;
+    float lastUpdateMs = 0.0f;
+};
@@ -0,0 +1,310 @@
+#include "MeshBvh.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const int SAH_BINS = 12;
+static const int LEAF_SIZE = 4; // = szerokość paczki trójkątów
+static const float BIG = 1e30f;
+
+namespace {
+
+// Węzeł drzewa binarnego z budowy (przed zwinięciem do 4 dzieci)
+struct BuildNode {
+    Aabb box;
+    int left = -1, right = -1; // left == -1: liść
+    int first = 0, count = 0;  // zakres w `order`
+};
+
+struct Builder {
+    const float* vertices;
+    size_t stride;
+    std::vector<Aabb> boxes;      // pudełko trójkąta
+    std::vector<Vec3> centroids;
+    std::vector<int> order;       // numery trójkątów, liście to ciągłe zakresy
+    std::vector<BuildNode> build;
+    MeshBvh& out;
+
+    Builder(const float* v, size_t s, MeshBvh& o) : vertices(v), stride(s), out(o) {}
+
+    Vec3 vertex(int triangle, int k) const {
+        const float* p = vertices + ((size_t)triangle * 3 + k) * stride;
+        return Vec3(p[0], p[1], p[2]);
+    }
+
+    static Aabb empty() { return { Vec3(BIG, BIG, BIG), Vec3(-BIG, -BIG, -BIG) }; }
+    static float axis(const Vec3& v, int a) { return a == 0 ? v.x : (a == 1 ? v.y : v.z); }
+
+    int node(int first, int count) {
+        BuildNode n;
+        n.first = first; n.count = count;
+        n.box = empty();
+        Aabb centroidBox = empty();
+        for (int i = first; i < first + count; ++i) {
+            n.box = Aabb::merge(n.box, boxes[order[i]]);
+            centroidBox = Aabb::merge(centroidBox, Aabb{ centroids[order[i]], centroids[order[i]] });
+        }
+        int index = (int)build.size();
+        build.push_back(n);
+        if (count <= LEAF_SIZE) return index;
+
+        // SAH w koszykach: dla każdej osi koszt = pole lewej * liczba + pole prawej * liczba
+        int bestAxis = -1, bestSplit = 0;
+        float bestCost = BIG;
+        for (int a = 0; a < 3; ++a) {
+            float lo = axis(centroidBox.min, a), extent = axis(centroidBox.max, a) - lo;
+            if (extent <= 1e-9f) continue;
+            Aabb binBox[SAH_BINS]; int binCount[SAH_BINS] = {};
+            for (int b = 0; b < SAH_BINS; ++b) binBox[b] = empty();
+            const float scale = SAH_BINS / extent;
+            for (int i = first; i < first + count; ++i) {
+                int b = std::min(SAH_BINS - 1, (int)((axis(centroids[order[i]], a) - lo) * scale));
+                binBox[b] = Aabb::merge(binBox[b], boxes[order[i]]);
+                binCount[b]++;
+            }
+            float rightArea[SAH_BINS]; int rightCount[SAH_BINS];
+            Aabb acc = empty(); int n = 0;
+            for (int b = SAH_BINS - 1; b > 0; --b) {
+                acc = Aabb::merge(acc, binBox[b]); n += binCount[b];
+                rightArea[b] = n ? acc.area() : 0.0f; rightCount[b] = n;
+            }
+            acc = empty(); n = 0;
+            for (int b = 0; b < SAH_BINS - 1; ++b) {
+                acc = Aabb::merge(acc, binBox[b]); n += binCount[b];
+                if (n == 0 || rightCount[b + 1] == 0) continue;
+                float cost = acc.area() * n + rightArea[b + 1] * rightCount[b + 1];
+                if (cost < bestCost) { bestCost = cost; bestAxis = a; bestSplit = b + 1; }
+            }
+        }
+
+        int mid;
+        if (bestAxis >= 0) {
+            float lo = axis(centroidBox.min, bestAxis), scale = SAH_BINS / (axis(centroidBox.max, bestAxis) - lo);
+            mid = (int)(std::partition(order.begin() + first, order.begin() + first + count, [&](int t) {
+                return std::min(SAH_BINS - 1, (int)((axis(centroids[t], bestAxis) - lo) * scale)) < bestSplit;
+            }) - order.begin());
+        } else {
+            mid = first + count / 2; // wszystkie środki w jednym punkcie - dzielimy po połowie
+        }
+        int left = node(first, mid - first);
+        int right = node(mid, first + count - mid);
+        build[index].left = left;
+        build[index].right = right;
+        return index;
+    }
+
+    int packet(const BuildNode& leaf) {
+        MeshBvh::TrianglePacket p = {};
+        for (int l = 0; l < LEAF_SIZE; ++l) {
+            p.triangle[l] = -1;
+            if (l >= leaf.count) continue;
+            int t = order[leaf.first + l];
+            Vec3 a = vertex(t, 0), e1 = vertex(t, 1) - a, e2 = vertex(t, 2) - a;
+            p.ax[l] = a.x; p.ay[l] = a.y; p.az[l] = a.z;
+            p.e1x[l] = e1.x; p.e1y[l] = e1.y; p.e1z[l] = e1.z;
+            p.e2x[l] = e2.x; p.e2y[l] = e2.y; p.e2z[l] = e2.z;
+            p.triangle[l] = t;
+        }
+        out.packets.push_back(p);
+        return (int)out.packets.size() - 1;
+    }
+
+    // Węzeł 4-dzietny: dzieci węzła binarnego, a dopóki jest miejsce - wewnętrzne dziecko o największym polu
+    // zastępujemy jego dwojgiem dzieci
+    int collapse(int b) {
+        int kids[4] = { build[b].left, build[b].right }, n = 2;
+        while (n < 4) {
+            int pick = -1; float area = -1.0f;
+            for (int k = 0; k < n; ++k)
+                if (build[kids[k]].left != -1 && build[kids[k]].box.area() > area) { area = build[kids[k]].box.area(); pick = k; }
+            if (pick < 0) break;
+            int split = kids[pick];
+            kids[pick] = build[split].left;
+            kids[n++] = build[split].right;
+        }
+        int index = (int)out.nodes.size();
+        out.nodes.emplace_back();
+        for (int k = 0; k < n; ++k) {
+            const BuildNode& c = build[kids[k]];
+            int child = c.left == -1 ? ~packet(c) : collapse(kids[k]);
+            MeshBvh::Node& node = out.nodes[index]; // collapse() mogło przenieść tablicę
+            node.minX[k] = c.box.min.x; node.minY[k] = c.box.min.y; node.minZ[k] = c.box.min.z;
+            node.maxX[k] = c.box.max.x; node.maxY[k] = c.box.max.y; node.maxZ[k] = c.box.max.z;
+            node.child[k] = child;
+        }
+        out.nodes[index].count = n;
+        return index;
+    }
+};
+
+} // namespace
+
+bool buildMeshBvh(const float* vertices, size_t count, size_t stride, MeshBvh& out) {
+    out = MeshBvh();
+    size_t triangles = count / 3;
+    if (triangles == 0) return false;
+    Builder b(vertices, stride, out);
+    b.boxes.resize(triangles);
+    b.centroids.resize(triangles);
+    b.order.resize(triangles);
+    for (size_t t = 0; t < triangles; ++t) {
+        Vec3 v0 = b.vertex((int)t, 0), v1 = b.vertex((int)t, 1), v2 = b.vertex((int)t, 2);
+        Aabb box = Aabb::merge(Aabb::merge(Aabb{ v0, v0 }, Aabb{ v1, v1 }), Aabb{ v2, v2 });
+        b.boxes[t] = box;
+        b.centroids[t] = (box.min + box.max) * 0.5f;
+        b.order[t] = (int)t;
+    }
+    b.build.reserve(triangles * 2 / LEAF_SIZE + 1);
+    int root = b.node(0, (int)triangles);
+    out.bounds = b.build[root].box;
+    out.triangleCount = triangles;
+
+    if (b.build[root].left == -1) { // cała siatka w jednym liściu
+        MeshBvh::Node node = {};
+        node.minX[0] = out.bounds.min.x; node.minY[0] = out.bounds.min.y; node.minZ[0] = out.bounds.min.z;
+        node.maxX[0] = out.bounds.max.x; node.maxY[0] = out.bounds.max.y; node.maxZ[0] = out.bounds.max.z;
+        node.child[0] = ~b.packet(b.build[root]);
+        node.count = 1;
+        out.nodes.push_back(node);
+    } else {
+        b.collapse(root);
+    }
+    return true;
+}
+
+// --- PRZEJŚCIE ---
+
+// Test 4 pudełek dziecka naraz; tNear trafionych do sortowania od najbliższego
+static int slab4(const MeshBvh::Node& n, const float o[3], const float inv[3], float maxT, float tNear[4]) {
+#ifdef DUCKY_SSE
+    const __m128 ox = _mm_set1_ps(o[0]), oy = _mm_set1_ps(o[1]), oz = _mm_set1_ps(o[2]);
+    const __m128 ix = _mm_set1_ps(inv[0]), iy = _mm_set1_ps(inv[1]), iz = _mm_set1_ps(inv[2]);
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(n.minX), ox), ix), t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(n.maxX), ox), ix);
+    __m128 lo = _mm_min_ps(t1, t2), hi = _mm_max_ps(t1, t2);
+    t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(n.minY), oy), iy); t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(n.maxY), oy), iy);
+    lo = _mm_max_ps(lo, _mm_min_ps(t1, t2)); hi = _mm_min_ps(hi, _mm_max_ps(t1, t2));
+    t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(n.minZ), oz), iz); t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(n.maxZ), oz), iz);
+    lo = _mm_max_ps(lo, _mm_min_ps(t1, t2)); hi = _mm_min_ps(hi, _mm_max_ps(t1, t2));
+    lo = _mm_max_ps(lo, _mm_setzero_ps());
+    __m128 hit = _mm_and_ps(_mm_cmple_ps(lo, hi), _mm_cmple_ps(lo, _mm_set1_ps(maxT)));
+    _mm_storeu_ps(tNear, lo);
+    return _mm_movemask_ps(hit) & ((1 << n.count) - 1);
+#else
+    const float* mins[3] = { n.minX, n.minY, n.minZ };
+    const float* maxs[3] = { n.maxX, n.maxY, n.maxZ };
+    int mask = 0;
+    for (int k = 0; k < n.count; ++k) {
+        float lo = 0.0f, hi = BIG;
+        for (int a = 0; a < 3; ++a) {
+            float t1 = (mins[a][k] - o[a]) * inv[a], t2 = (maxs[a][k] - o[a]) * inv[a];
+            lo = std::max(lo, std::min(t1, t2));
+            hi = std::min(hi, std::max(t1, t2));
+        }
+        tNear[k] = lo;
+        if (lo <= hi && lo <= maxT) mask |= 1 << k;
+    }
+    return mask;
+#endif
+}
+
+// Möller-Trumbore na 4 trójkątach; zwraca lanę najbliższego trafienia przed maxT (-1 = brak)
+static int intersect4(const MeshBvh::TrianglePacket& p, const float o[3], const float d[3], float maxT, float& t, float& u, float& v) {
+    int best = -1;
+#ifdef DUCKY_SSE
+    const __m128 dx = _mm_set1_ps(d[0]), dy = _mm_set1_ps(d[1]), dz = _mm_set1_ps(d[2]);
+    const __m128 e1x = _mm_load_ps(p.e1x), e1y = _mm_load_ps(p.e1y), e1z = _mm_load_ps(p.e1z);
+    const __m128 e2x = _mm_load_ps(p.e2x), e2y = _mm_load_ps(p.e2y), e2z = _mm_load_ps(p.e2z);
+    const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+    const __m128 absDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+    const __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), det);
+    const __m128 sx = _mm_sub_ps(_mm_set1_ps(o[0]), _mm_load_ps(p.ax));
+    const __m128 sy = _mm_sub_ps(_mm_set1_ps(o[1]), _mm_load_ps(p.ay));
+    const __m128 sz = _mm_sub_ps(_mm_set1_ps(o[2]), _mm_load_ps(p.az));
+    const __m128 uu = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv);
+    const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+    const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+    const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+    const __m128 vv = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv);
+    const __m128 tt = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 ok = _mm_cmpgt_ps(absDet, _mm_set1_ps(1e-20f));
+    ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmpge_ps(uu, zero), _mm_cmpge_ps(vv, zero)));
+    ok = _mm_and_ps(ok, _mm_cmple_ps(_mm_add_ps(uu, vv), _mm_set1_ps(1.0f)));
+    ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmpge_ps(tt, zero), _mm_cmplt_ps(tt, _mm_set1_ps(maxT))));
+    int mask = _mm_movemask_ps(ok);
+    if (!mask) return -1;
+    alignas(16) float ts[4], us[4], vs[4];
+    _mm_store_ps(ts, tt); _mm_store_ps(us, uu); _mm_store_ps(vs, vv);
+    for (int l = 0; l < 4; ++l)
+        if ((mask & (1 << l)) && ts[l] < maxT) { maxT = ts[l]; t = ts[l]; u = us[l]; v = vs[l]; best = l; }
+#else
+    for (int l = 0; l < 4; ++l) {
+        Vec3 e1(p.e1x[l], p.e1y[l], p.e1z[l]), e2(p.e2x[l], p.e2y[l], p.e2z[l]), dir(d[0], d[1], d[2]);
+        Vec3 pv = dir.cross(e2);
+        float det = e1.dot(pv);
+        if (std::fabs(det) <= 1e-20f) continue;
+        float inv = 1.0f / det;
+        Vec3 s(o[0] - p.ax[l], o[1] - p.ay[l], o[2] - p.az[l]);
+        float uu = s.dot(pv) * inv;
+        Vec3 q = s.cross(e1);
+        float vv = dir.dot(q) * inv, tt = e2.dot(q) * inv;
+        if (uu < 0.0f || vv < 0.0f || uu + vv > 1.0f || tt < 0.0f || tt >= maxT) continue;
+        maxT = tt; t = tt; u = uu; v = vv; best = l;
+    }
+#endif
+    return best;
+}
+
+bool MeshBvh::raycast(const Vec3& origin, const Vec3& direction, float maxDistance, MeshHit& hit) const {
+    if (nodes.empty()) return false;
+    auto inverse = [](float d) { return std::fabs(d) > 1e-12f ? 1.0f / d : (d < 0.0f ? -BIG : BIG); };
+    const float o[3] = { origin.x, origin.y, origin.z }, d[3] = { direction.x, direction.y, direction.z };
+    const float inv[3] = { inverse(d[0]), inverse(d[1]), inverse(d[2]) };
+    float best = maxDistance;
+    int bestPacket = -1, bestLane = -1;
+    float bestU = 0.0f, bestV = 0.0f;
+
+    int fixed[64]; int top = 0;
+    std::vector<int> overflow;
+    auto push = [&](int i) { if (top < 64) fixed[top++] = i; else overflow.push_back(i); };
+    push(0);
+    while (top > 0 || !overflow.empty()) {
+        int index;
+        if (!overflow.empty()) { index = overflow.back(); overflow.pop_back(); }
+        else index = fixed[--top];
+        const Node& n = nodes[index];
+        float tNear[4];
+        int mask = slab4(n, o, inv, best, tNear);
+        if (!mask) continue;
+
+        // Od najdalszego do najbliższego na stos - najbliższe dziecko wychodzi pierwsze i skraca `best`
+        int order[4], count = 0;
+        for (int k = 0; k < n.count; ++k) {
+            if (!(mask & (1 << k))) continue;
+            int j = count++;
+            while (j > 0 && tNear[order[j - 1]] < tNear[k]) { order[j] = order[j - 1]; --j; }
+            order[j] = k;
+        }
+        for (int i = 0; i < count; ++i) {
+            int child = n.child[order[i]];
+            if (child >= 0) { push(child); continue; }
+            float t, u, v;
+            int lane = intersect4(packets[~child], o, d, best, t, u, v);
+            if (lane >= 0) { best = t; bestPacket = ~child; bestLane = lane; bestU = u; bestV = v; }
+        }
+    }
+    if (bestPacket < 0) return false;
+
+    const TrianglePacket& p = packets[bestPacket];
+    Vec3 e1(p.e1x[bestLane], p.e1y[bestLane], p.e1z[bestLane]), e2(p.e2x[bestLane], p.e2y[bestLane], p.e2z[bestLane]);
+    Vec3 normal = e1.cross(e2).normalize();
+    if (normal.dot(direction) > 0.0f) normal = normal * -1.0f;
+    hit.distance = best;
+    hit.triangle = p.triangle[bestLane];
+    hit.normal = normal;
+    hit.u = bestU;
+    hit.v = bestV;
+    return true;
+}
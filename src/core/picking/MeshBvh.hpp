@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "../physics/AabbTree.hpp"
+#include "../math/Vec3.hpp"
+
+// Trafienie promienia w trójkąt siatki (przestrzeń modelu)
+struct MeshHit {
+    float distance = 0.0f; // parametr promienia: origin + direction * distance
+    int triangle = -1;     // numer trójkąta w danych wierzchołków (wierzchołki 3t .. 3t+2)
+    Vec3 normal;           // normalna ściany, zwrócona w stronę promienia
+    float u = 0.0f, v = 0.0f; // współrzędne barycentryczne względem wierzchołków 1 i 2
+};
+
+// --- BVH TRÓJKĄTÓW SIATKI (picking na CPU) ---
+// Budowane raz na plik modelu (i raz na prymityw), współdzielone przez wszystkie instancje - jak ConvexHull.
+// Budowa: drzewo binarne z podziałem SAH w 12 koszykach po środkach trójkątów, liście po <= 4 trójkąty,
+// potem zwinięte do węzłów 4-dzietnych. Dzieci węzła i trójkąty liścia leżą w SoA po 4, więc przejście
+// robi jeden test slab (SSE) na 4 pudełka i jeden Möller-Trumbore na 4 trójkąty naraz.
+// Trójkąty są dwustronne, promień nie musi być znormalizowany (distance jest w jego jednostkach).
+struct MeshBvh {
+    struct alignas(16) Node {
+        float minX[4], minY[4], minZ[4];
+        float maxX[4], maxY[4], maxZ[4];
+        int child[4]; // >= 0: węzeł, < 0: paczka trójkątów ~child
+        int count;    // ważne dzieci (na początku tablic)
+    };
+    struct alignas(16) TrianglePacket {
+        float ax[4], ay[4], az[4];    // pierwszy wierzchołek
+        float e1x[4], e1y[4], e1z[4]; // krawędź 0 -> 1
+        float e2x[4], e2y[4], e2z[4]; // krawędź 0 -> 2 (puste lany: zerowe krawędzie, nigdy nie trafiają)
+        int triangle[4];
+    };
+
+    std::vector<Node> nodes; // nodes[0] = korzeń
+    std::vector<TrianglePacket> packets;
+    Aabb bounds;
+    size_t triangleCount = 0;
+
+    bool raycast(const Vec3& origin, const Vec3& direction, float maxDistance, MeshHit& hit) const;
+};
+
+// `stride` w floatach (dane z decodeModel: 8), co trzy wierzchołki jeden trójkąt. false = brak trójkątów.
+bool buildMeshBvh(const float* vertices, size_t count, size_t stride, MeshBvh& out);
@@ -0,0 +1,105 @@
+#include "ScenePicker.hpp"
+#include <chrono>
+#include <cmath>
+#include "../ecs/World.hpp"
+#include "../math/MatrixTransform.hpp"
+
+// Sześcian jednostkowy (12 trójkątów) dla obiektów bez własnej siatki
+static std::shared_ptr<const MeshBvh> buildUnitCube() {
+    static const int faces[6][4][3] = {
+        { {-1,-1,-1}, {1,-1,-1}, {1,1,-1}, {-1,1,-1} }, { {-1,-1,1}, {1,-1,1}, {1,1,1}, {-1,1,1} },
+        { {-1,-1,-1}, {-1,1,-1}, {-1,1,1}, {-1,-1,1} }, { {1,-1,-1}, {1,1,-1}, {1,1,1}, {1,-1,1} },
+        { {-1,-1,-1}, {1,-1,-1}, {1,-1,1}, {-1,-1,1} }, { {-1,1,-1}, {1,1,-1}, {1,1,1}, {-1,1,1} }
+    };
+    static const int corners[6] = { 0, 1, 2, 0, 2, 3 };
+    std::vector<float> vertices;
+    for (const auto& f : faces)
+        for (int c : corners)
+            for (int a = 0; a < 3; ++a) vertices.push_back(f[c][a] * 0.5f);
+    auto bvh = std::make_shared<MeshBvh>();
+    buildMeshBvh(vertices.data(), vertices.size() / 3, 3, *bvh);
+    return bvh;
+}
+
+void ScenePicker::setMesh(MeshType type, std::shared_ptr<const MeshBvh> bvh) {
+    meshes[(int)type] = std::move(bvh);
+}
+
+const MeshBvh* ScenePicker::meshOf(MeshType type, const MeshBvh* modelBvh) const {
+    if (type == MeshType::Model && modelBvh) return modelBvh;
+    if (type != MeshType::Model && meshes[(int)type]) return meshes[(int)type].get();
+    return unitCube.get();
+}
+
+// Pudełko świata: środek przez macierz, połówki przez |macierz| (bez 8 narożników)
+Aabb ScenePicker::worldBox(const Entry& e) const {
+    const Aabb& local = e.bvh->bounds;
+    const float* m = e.world.data();
+    Vec3 c = (local.min + local.max) * 0.5f, h = (local.max - local.min) * 0.5f;
+    Vec3 center(m[0] * c.x + m[4] * c.y + m[8] * c.z + m[12], m[1] * c.x + m[5] * c.y + m[9] * c.z + m[13], m[2] * c.x + m[6] * c.y + m[10] * c.z + m[14]);
+    Vec3 half(std::fabs(m[0]) * h.x + std::fabs(m[4]) * h.y + std::fabs(m[8]) * h.z,
+              std::fabs(m[1]) * h.x + std::fabs(m[5]) * h.y + std::fabs(m[9]) * h.z,
+              std::fabs(m[2]) * h.x + std::fabs(m[6]) * h.y + std::fabs(m[10]) * h.z);
+    return { center - half, center + half };
+}
+
+void ScenePicker::sync(World& world) {
+    if (!unitCube) unitCube = buildUnitCube();
+    if (structureVersion != world.getStructureVersion()) {
+        tree.clear();
+        entries.clear();
+        std::fill(entryOf.begin(), entryOf.end(), -1);
+        world.each<Transform, MeshRenderer>([&](int id, const Transform&, const MeshRenderer& mesh) {
+            Entry e{ id, -1, meshOf(mesh.type, mesh.bvh.get()), world.getWorldMatrix(id) };
+            e.proxy = tree.insert(worldBox(e), (int)entries.size());
+            if ((size_t)id >= entryOf.size()) entryOf.resize(id + 1, -1);
+            entryOf[id] = (int)entries.size();
+            entries.push_back(e);
+        });
+        structureVersion = world.getStructureVersion();
+        return;
+    }
+    // Siatka mogła się zmienić bez zmiany struktury (cofnięcie edycji, podmiana modelu)
+    world.each<Transform, MeshRenderer>([&](int id, const Transform&, const MeshRenderer& mesh) {
+        Entry& e = entries[entryOf[id]];
+        e.bvh = meshOf(mesh.type, mesh.bvh.get());
+        e.world = world.getWorldMatrix(id);
+        tree.move(e.proxy, worldBox(e));
+    });
+}
+
+PickHit ScenePicker::pick(const Vec3& origin, const Vec3& direction, float maxDistance) const {
+    auto start = std::chrono::steady_clock::now();
+    PickHit result;
+    lastMeshTests = 0;
+
+    // Jedna aktywna lana paczki; tMax skraca się z każdym trafieniem, więc dalsze liście odpadają na pudełkach
+    auto inverse = [](float d) { return std::fabs(d) > 1e-12f ? 1.0f / d : (d < 0.0f ? -1e30f : 1e30f); };
+    RayPacket packet;
+    for (int l = 0; l < 4; ++l) {
+        packet.ox[l] = origin.x; packet.oy[l] = origin.y; packet.oz[l] = origin.z;
+        packet.ix[l] = inverse(direction.x); packet.iy[l] = inverse(direction.y); packet.iz[l] = inverse(direction.z);
+        packet.tMax[l] = l == 0 ? maxDistance : -1e30f;
+    }
+    tree.raycast(packet, [&](int index, int) {
+        const Entry& e = entries[index];
+        lastMeshTests++;
+        // Promień do przestrzeni modelu; kierunek bez normalizacji, więc odległość zostaje w metrach świata
+        Mat4 inv = MatrixTransform::inverseAffine(e.world);
+        const float* m = inv.data();
+        Vec3 o(m[0] * origin.x + m[4] * origin.y + m[8] * origin.z + m[12], m[1] * origin.x + m[5] * origin.y + m[9] * origin.z + m[13], m[2] * origin.x + m[6] * origin.y + m[10] * origin.z + m[14]);
+        Vec3 d(m[0] * direction.x + m[4] * direction.y + m[8] * direction.z, m[1] * direction.x + m[5] * direction.y + m[9] * direction.z, m[2] * direction.x + m[6] * direction.y + m[10] * direction.z);
+        MeshHit hit;
+        if (!e.bvh->raycast(o, d, packet.tMax[0], hit)) return;
+        packet.tMax[0] = hit.distance;
+        result.id = e.id;
+        result.distance = hit.distance;
+        result.triangle = hit.triangle;
+        // Normalna przez odwrotność transponowaną (skala niejednorodna)
+        const Vec3& n = hit.normal;
+        result.normal = Vec3(m[0] * n.x + m[1] * n.y + m[2] * n.z, m[4] * n.x + m[5] * n.y + m[6] * n.z, m[8] * n.x + m[9] * n.y + m[10] * n.z).normalize();
+    });
+    if (result.id != -1) result.point = origin + direction * result.distance;
+    lastPickMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
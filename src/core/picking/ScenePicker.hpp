@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "MeshBvh.hpp"
+#include "../math/Mat4.hpp"
+#include "../physics/AabbTree.hpp"
+#include "../sceneobject/SceneObject.hpp"
+
+class World;
+
+// Wynik pickingu w przestrzeni świata
+struct PickHit {
+    int id = -1;        // encja, -1 = pudło
+    float distance = 0.0f;
+    Vec3 point;
+    Vec3 normal;
+    int triangle = -1;  // trójkąt w siatce encji (MeshBvh)
+};
+
+// --- PICKING W EDYTORZE ---
+// Promień z kursora idzie najpierw przez drzewo AABB sceny (pudełka świata siatek, to samo AabbTree co
+// broadphase fizyki), a w trafionych liściach - w przestrzeni modelu - przez MeshBvh siatki. Wynik to
+// najbliższy trójkąt, nie najbliższy środek obiektu. Modele mają BVH z MeshRenderer::bvh, prymitywy
+// dostają wspólne z setMesh(); kształt bez BVH (np. model, którego nie udało się wczytać) jest sześcianem jednostkowym.
+// sync() przed pick(): po zmianie struktury świata drzewo jest budowane od nowa, w zwykłej klatce tylko
+// odświeżane (przesunięcie w obrębie marginesu liścia nie zmienia drzewa) - to jest tanie na tyle, że
+// najechanie kursorem można sprawdzać co klatkę.
+class ScenePicker {
+public:
+    void setMesh(MeshType type, std::shared_ptr<const MeshBvh> bvh);
+    void sync(World& world);
+    PickHit pick(const Vec3& origin, const Vec3& direction, float maxDistance = 1000.0f) const; // direction znormalizowany
+
+    size_t getObjectCount() const { return entries.size(); }
+    float getLastPickMs() const { return lastPickMs; }
+    size_t getLastMeshTests() const { return lastMeshTests; } // liście drzewa sceny sprawdzone dokładnie
+
+private:
+    struct Entry {
+        int id;
+        int proxy;
+        const MeshBvh* bvh; // własność: MeshRenderer albo `meshes` - ważne do następnego sync()
+        Mat4 world;
+    };
+
+    const MeshBvh* meshOf(MeshType type, const MeshBvh* modelBvh) const;
+    Aabb worldBox(const Entry& e) const;
+
+    AabbTree tree;
+    std::vector<Entry> entries;
+    std::vector<int> entryOf; // id -> indeks w entries (-1 = brak)
+    std::shared_ptr<const MeshBvh> meshes[6];  // po MeshType
+    std::shared_ptr<const MeshBvh> unitCube;
+    uint64_t structureVersion = ~0ull;
+    mutable float lastPickMs = 0.0f;
+    mutable size_t lastMeshTests = 0;
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// --- REFLEKSJA W CZASIE KOMPILACJI ---
+// Typ opisujemy specjalizacją Reflect<T> z krotką `fields` (constexpr).
+// Z jednego opisu generujemy: JSON, zapis binarny, diff dla Undo i widżety Inspektora.
+
+enum FieldFlags : unsigned int {
+    Field_None     = 0,
+    Field_Hidden   = 1 << 0, // nie pokazujemy w Inspektorze
+    Field_ReadOnly = 1 << 1, // Inspektor tylko wyświetla
+    Field_Runtime  = 1 << 2, // stan runtime (id GL itp.) - nie trafia do plików, ale trafia do Undo
+    Field_Degrees  = 1 << 3, // radiany w pamięci, stopnie w Inspektorze
+    Field_Slider   = 1 << 4  // SliderFloat(min, max) zamiast DragFloat
+};
+
+template<typename Class, typename T>
+struct Field {
+    using Owner = Class;
+    using Type = T;
+
+    const char* key;    // klucz w JSON
+    const char* label;  // etykieta w Inspektorze
+    T Class::* member;
+    unsigned int flags;
+    const char* group;  // nagłówek w Inspektorze (nullptr = bez grupy)
+    float speed, min, max;
+
+    constexpr bool has(unsigned int f) const { return (flags & f) != 0; }
+};
+
+template<typename Class, typename T>
+constexpr Field<Class, T> field(const char* key, const char* label, T Class::* member, unsigned int flags = Field_None,
+                                const char* group = nullptr, float speed = 0.1f, float min = 0.0f, float max = 0.0f) {
+    return Field<Class, T>{key, label, member, flags, group, speed, min, max};
+}
+
+template<typename T> struct Reflect; // brak specjalizacji = typ nieopisany
+
+template<typename T, typename = void> struct IsReflected : std::false_type {};
+template<typename T> struct IsReflected<T, std::void_t<decltype(Reflect<T>::fields)>> : std::true_type {};
+
+template<typename T>
+constexpr std::size_t fieldCount() { return std::tuple_size<std::decay_t<decltype(Reflect<T>::fields)>>::value; }
+
+// Wywołuje f(field) dla każdego pola po kolei
+template<typename T, typename F>
+void forEachField(F&& f) {
+    std::apply([&](const auto&... fs) { (f(fs), ...); }, Reflect<T>::fields);
+}
+
+// Jak wyżej, ale z indeksem pola: f(field, index)
+template<typename T, typename F, std::size_t... I>
+void forEachFieldIndexedImpl(F&& f, std::index_sequence<I...>) {
+    (f(std::get<I>(Reflect<T>::fields), I), ...);
+}
+template<typename T, typename F>
+void forEachFieldIndexed(F&& f) {
+    forEachFieldIndexedImpl<T>(f, std::make_index_sequence<fieldCount<T>()>{});
+}
+
+// Wywołuje f(field) dla pola o indeksie znanym dopiero w runtime. Zwraca false dla złego indeksu.
+template<typename T, typename F, std::size_t... I>
+bool visitFieldImpl(std::size_t index, F&& f, std::index_sequence<I...>) {
+    return ((I == index ? (f(std::get<I>(Reflect<T>::fields)), true) : false) || ...);
+}
+template<typename T, typename F>
+bool visitField(std::size_t index, F&& f) {
+    return visitFieldImpl<T>(index, f, std::make_index_sequence<fieldCount<T>()>{});
+}
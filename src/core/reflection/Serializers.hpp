@@ -0,0 +1,166 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Reflection.hpp"
+#include "../json.hpp"
+#include "../math/Vec3.hpp"
+
+// --- GENERYCZNE SERIALIZERY NA BAZIE Reflect<T> ---
+// `skip` = maska flag pól pomijanych (domyślnie stan runtime nie trafia do plików).
+
+// ==========================================
+// 1. JSON
+// ==========================================
+template<typename T> void writeJson(const T& obj, nlohmann::json& j, unsigned int skip = Field_Runtime);
+template<typename T> void readJson(const nlohmann::json& j, T& obj, unsigned int skip = Field_Runtime);
+
+template<typename V>
+void writeJsonValue(nlohmann::json& j, const V& v, unsigned int skip) {
+    if constexpr (IsReflected<V>::value) writeJson(v, j, skip);
+    else if constexpr (std::is_same_v<V, Vec3>) j = {v.x, v.y, v.z};
+    else if constexpr (std::is_enum_v<V>) j = static_cast<int>(v);
+    else j = v;
+}
+
+template<typename V>
+void readJsonValue(const nlohmann::json& j, V& v, unsigned int skip) {
+    if constexpr (IsReflected<V>::value) readJson(j, v, skip);
+    else if constexpr (std::is_same_v<V, Vec3>) { if (j.is_array() && j.size() >= 3) v = Vec3(j[0].get<float>(), j[1].get<float>(), j[2].get<float>()); }
+    else if constexpr (std::is_enum_v<V>) v = static_cast<V>(j.get<int>());
+    else v = j.get<V>();
+}
+
+template<typename T>
+void writeJson(const T& obj, nlohmann::json& j, unsigned int skip) {
+    forEachField<T>([&](const auto& f) {
+        if (f.has(skip)) return;
+        writeJsonValue(j[f.key], obj.*(f.member), skip);
+    });
+}
+
+template<typename T>
+void readJson(const nlohmann::json& j, T& obj, unsigned int skip) {
+    if (!j.is_object()) return;
+    forEachField<T>([&](const auto& f) {
+        if (f.has(skip)) return;
+        auto it = j.find(f.key);
+        if (it != j.end() && !it->is_null()) readJsonValue(*it, obj.*(f.member), skip);
+    });
+}
+
+// ==========================================
+// 2. BINARNY (kolejność pól z deskryptora, bez kluczy tekstowych)
+// ==========================================
+struct BinaryWriter {
+    std::vector<uint8_t> bytes;
+    void write(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        bytes.insert(bytes.end(), p, p + size);
+    }
+    template<typename P> void put(const P& value) { write(&value, sizeof(P)); }
+};
+
+struct BinaryReader {
+    const uint8_t* cur;
+    const uint8_t* end;
+    bool ok = true;
+    BinaryReader(const uint8_t* data, size_t size) : cur(data), end(data + size) {}
+    explicit BinaryReader(const std::vector<uint8_t>& v) : BinaryReader(v.data(), v.size()) {}
+    bool read(void* out, size_t size) {
+        if (!ok || (size_t)(end - cur) < size) { ok = false; return false; }
+        std::memcpy(out, cur, size); cur += size;
+        return true;
+    }
+    template<typename P> bool get(P& value) { return read(&value, sizeof(P)); }
+};
+
+template<typename T> void writeBinary(const T& obj, BinaryWriter& w, unsigned int skip = Field_Runtime);
+template<typename T> bool readBinary(BinaryReader& r, T& obj, unsigned int skip = Field_Runtime);
+
+template<typename V>
+void writeBinaryValue(BinaryWriter& w, const V& v, unsigned int skip) {
+    if constexpr (IsReflected<V>::value) writeBinary(v, w, skip);
+    else if constexpr (std::is_same_v<V, std::string>) { w.put((uint32_t)v.size()); w.write(v.data(), v.size()); }
+    else if constexpr (std::is_same_v<V, Vec3>) { w.put(v.x); w.put(v.y); w.put(v.z); }
+    else if constexpr (std::is_enum_v<V>) w.put((int32_t)v);
+    else { static_assert(std::is_arithmetic_v<V>, "Unsupported field type"); w.put(v); }
+}
+
+template<typename V>
+bool readBinaryValue(BinaryReader& r, V& v, unsigned int skip) {
+    if constexpr (IsReflected<V>::value) return readBinary(r, v, skip);
+    else if constexpr (std::is_same_v<V, std::string>) {
+        uint32_t len = 0;
+        if (!r.get(len) || (size_t)(r.end - r.cur) < len) { r.ok = false; return false; }
+        v.assign(reinterpret_cast<const char*>(r.cur), len); r.cur += len;
+        return true;
+    }
+    else if constexpr (std::is_same_v<V, Vec3>) return r.get(v.x) && r.get(v.y) && r.get(v.z);
+    else if constexpr (std::is_enum_v<V>) { int32_t e = 0; if (!r.get(e)) return false; v = static_cast<V>(e); return true; }
+    else return r.get(v);
+}
+
+template<typename T>
+void writeBinary(const T& obj, BinaryWriter& w, unsigned int skip) {
+    forEachField<T>([&](const auto& f) {
+        if (!f.has(skip)) writeBinaryValue(w, obj.*(f.member), skip);
+    });
+}
+
+template<typename T>
+bool readBinary(BinaryReader& r, T& obj, unsigned int skip) {
+    forEachField<T>([&](const auto& f) {
+        if (!f.has(skip) && r.ok) readBinaryValue(r, obj.*(f.member), skip);
+    });
+    return r.ok;
+}
+
+// ==========================================
+// 3. DIFF (Undo/Redo) - łatki na poziomie pól najwyższego rzędu
+// ==========================================
+struct FieldPatch {
+    uint16_t index;
+    std::vector<uint8_t> before, after;
+};
+
+template<typename T> bool fieldsEqual(const T& a, const T& b);
+
+template<typename V>
+bool valueEquals(const V& a, const V& b) {
+    if constexpr (IsReflected<V>::value) return fieldsEqual(a, b);
+    else if constexpr (std::is_same_v<V, Vec3>) return a.x == b.x && a.y == b.y && a.z == b.z;
+    else return a == b;
+}
+
+template<typename T>
+bool fieldsEqual(const T& a, const T& b) {
+    bool equal = true;
+    forEachField<T>([&](const auto& f) { if (equal) equal = valueEquals(a.*(f.member), b.*(f.member)); });
+    return equal;
+}
+
+// Wszystkie różniące się pola (łącznie ze stanem runtime, żeby Undo przywracało np. id tekstur)
+template<typename T>
+std::vector<FieldPatch> diffFields(const T& before, const T& after) {
+    std::vector<FieldPatch> patches;
+    forEachFieldIndexed<T>([&](const auto& f, size_t index) {
+        if (valueEquals(before.*(f.member), after.*(f.member))) return;
+        BinaryWriter wb, wa;
+        writeBinaryValue(wb, before.*(f.member), Field_None);
+        writeBinaryValue(wa, after.*(f.member), Field_None);
+        patches.push_back({(uint16_t)index, std::move(wb.bytes), std::move(wa.bytes)});
+    });
+    return patches;
+}
+
+template<typename T>
+bool applyPatch(T& obj, const FieldPatch& patch, bool useAfter) {
+    bool ok = false;
+    visitField<T>(patch.index, [&](const auto& f) {
+        BinaryReader r(useAfter ? patch.after : patch.before);
+        ok = readBinaryValue(r, obj.*(f.member), Field_None);
+    });
+    return ok;
+}
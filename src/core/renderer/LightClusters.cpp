@@ -0,0 +1,144 @@
+#include "LightClusters.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include "../jobs/JobSystem.hpp"
+#include "../math/Simd.hpp"
+
+// Pudełka klastrów w przestrzeni widoku (kamera patrzy w -z). Kafel ekranu [nx0, nx1] w NDC na głębokości d
+// ma x od nx0 * d / P0 do nx1 * d / P0 - pudełko obejmuje oba końce warstwy.
+void LightClusters::rebuildBounds(const Mat4& proj) {
+    const float* p = proj.data();
+    std::memcpy(projection, p, sizeof(projection));
+    const float zNear = p[14] / (p[10] - 1.0f);
+    zFar = p[14] / (p[10] + 1.0f);
+    const float nearSlice = std::max(SLICE_NEAR, zNear);
+    sliceScale = SLICES / std::log(zFar / nearSlice);
+    sliceBias = -std::log(nearSlice) * sliceScale;
+
+    boxMinX.resize(CLUSTER_COUNT); boxMinY.resize(CLUSTER_COUNT); boxMinZ.resize(CLUSTER_COUNT);
+    boxMaxX.resize(CLUSTER_COUNT); boxMaxY.resize(CLUSTER_COUNT); boxMaxZ.resize(CLUSTER_COUNT);
+    for (int z = 0; z < SLICES; ++z) {
+        float d0 = z == 0 ? 0.0f : std::exp((z - sliceBias) / sliceScale);
+        float d1 = std::exp((z + 1 - sliceBias) / sliceScale);
+        for (int y = 0; y < TILES_Y; ++y) {
+            float ny0 = -1.0f + 2.0f * y / TILES_Y, ny1 = -1.0f + 2.0f * (y + 1) / TILES_Y;
+            for (int x = 0; x < TILES_X; ++x) {
+                float nx0 = -1.0f + 2.0f * x / TILES_X, nx1 = -1.0f + 2.0f * (x + 1) / TILES_X;
+                int c = x + TILES_X * (y + TILES_Y * z);
+                boxMinX[c] = std::min(nx0 * d0, nx0 * d1) / p[0]; boxMaxX[c] = std::max(nx1 * d0, nx1 * d1) / p[0];
+                boxMinY[c] = std::min(ny0 * d0, ny0 * d1) / p[5]; boxMaxY[c] = std::max(ny1 * d0, ny1 * d1) / p[5];
+                boxMinZ[c] = -d1; boxMaxZ[c] = -d0;
+            }
+        }
+    }
+}
+
+int LightClusters::sliceOf(float depth) const {
+    if (depth <= 0.0f) return 0;
+    int s = (int)std::floor(std::log(depth) * sliceScale + sliceBias);
+    return std::min(std::max(s, 0), SLICES - 1);
+}
+
+// Jedna paczka warstw [sliceBegin, sliceEnd): każdy klaster należy do dokładnie jednej paczki
+size_t LightClusters::binSlices(int sliceBegin, int sliceEnd) {
+    size_t lost = 0;
+    for (const Binned& b : binned) {
+        int z0 = std::max(b.sliceLo, sliceBegin), z1 = std::min(b.sliceHi, sliceEnd - 1);
+        auto push = [&](int c) {
+            if (counts[c] < MAX_PER_CLUSTER) slots[(size_t)c * MAX_PER_CLUSTER + counts[c]++] = b.index;
+            else lost++;
+        };
+        for (int z = z0; z <= z1; ++z)
+            for (int y = b.tileYLo; y <= b.tileYHi; ++y) {
+                const int row = TILES_X * (y + TILES_Y * z);
+#ifdef DUCKY_SSE
+                // Odległość^2 środka od pudełka: max(min - c, 0, c - max) na oś, 4 klastry w wierszu naraz
+                const __m128 cx = _mm_set1_ps(b.x), cy = _mm_set1_ps(b.y), cz = _mm_set1_ps(b.z), r2 = _mm_set1_ps(b.radiusSq);
+                const __m128 zero = _mm_setzero_ps();
+                for (int x = b.tileXLo & ~3; x <= b.tileXHi; x += 4) {
+                    const int c = row + x;
+                    __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&boxMinX[c]), cx), _mm_sub_ps(cx, _mm_loadu_ps(&boxMaxX[c]))), zero);
+                    __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&boxMinY[c]), cy), _mm_sub_ps(cy, _mm_loadu_ps(&boxMaxY[c]))), zero);
+                    __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&boxMinZ[c]), cz), _mm_sub_ps(cz, _mm_loadu_ps(&boxMaxZ[c]))), zero);
+                    __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                    int mask = _mm_movemask_ps(_mm_cmple_ps(d2, r2));
+                    // Lany spoza zakresu kafli (wyrównanie do 4) - poza rzutem kuli, więc nie przecinają
+                    for (int k = 0; mask; ++k, mask >>= 1)
+                        if ((mask & 1) && x + k >= b.tileXLo && x + k <= b.tileXHi) push(c + k);
+                }
+#else
+                for (int x = b.tileXLo; x <= b.tileXHi; ++x) {
+                    const int c = row + x;
+                    float dx = std::max(std::max(boxMinX[c] - b.x, b.x - boxMaxX[c]), 0.0f);
+                    float dy = std::max(std::max(boxMinY[c] - b.y, b.y - boxMaxY[c]), 0.0f);
+                    float dz = std::max(std::max(boxMinZ[c] - b.z, b.z - boxMaxZ[c]), 0.0f);
+                    if (dx * dx + dy * dy + dz * dz <= b.radiusSq) push(c);
+                }
+#endif
+            }
+    }
+    return lost;
+}
+
+void LightClusters::build(const Vec3* centers, const float* radii, size_t count, const Mat4& view, const Mat4& proj, JobSystem* jobs) {
+    auto start = std::chrono::steady_clock::now();
+    if (boxMinX.empty() || std::memcmp(projection, proj.data(), sizeof(projection)) != 0) rebuildBounds(proj);
+    const float* v = view.data();
+    const float p0 = projection[0], p5 = projection[5];
+
+    // 1. Światła do widoku + zakres klastrów z rzutu pudełka kuli (x/d ma ekstrema w narożnikach)
+    binned.clear();
+    for (size_t i = 0; i < count && i < 65535; ++i) {
+        const Vec3& w = centers[i];
+        const float r = radii[i];
+        Binned b;
+        b.x = v[0] * w.x + v[4] * w.y + v[8] * w.z + v[12];
+        b.y = v[1] * w.x + v[5] * w.y + v[9] * w.z + v[13];
+        b.z = v[2] * w.x + v[6] * w.y + v[10] * w.z + v[14];
+        b.radiusSq = r * r;
+        float dMin = -b.z - r, dMax = -b.z + r;
+        if (dMax <= 0.0f || dMin >= zFar) continue;
+        b.sliceLo = sliceOf(dMin);
+        b.sliceHi = sliceOf(dMax);
+        b.tileXLo = 0; b.tileXHi = TILES_X - 1; b.tileYLo = 0; b.tileYHi = TILES_Y - 1;
+        if (dMin > 1e-3f) {
+            float nx[4] = { (b.x - r) / dMin, (b.x - r) / dMax, (b.x + r) / dMin, (b.x + r) / dMax };
+            float ny[4] = { (b.y - r) / dMin, (b.y - r) / dMax, (b.y + r) / dMin, (b.y + r) / dMax };
+            float x0 = *std::min_element(nx, nx + 4) * p0, x1 = *std::max_element(nx, nx + 4) * p0;
+            float y0 = *std::min_element(ny, ny + 4) * p5, y1 = *std::max_element(ny, ny + 4) * p5;
+            if (x1 < -1.0f || x0 > 1.0f || y1 < -1.0f || y0 > 1.0f) continue;
+            b.tileXLo = std::max(0, (int)std::floor((x0 * 0.5f + 0.5f) * TILES_X));
+            b.tileXHi = std::min(TILES_X - 1, (int)std::floor((x1 * 0.5f + 0.5f) * TILES_X));
+            b.tileYLo = std::max(0, (int)std::floor((y0 * 0.5f + 0.5f) * TILES_Y));
+            b.tileYHi = std::min(TILES_Y - 1, (int)std::floor((y1 * 0.5f + 0.5f) * TILES_Y));
+        }
+        b.index = (uint16_t)i;
+        binned.push_back(b);
+    }
+
+    // 2. Binowanie po warstwach (po dwie na zadanie)
+    counts.assign(CLUSTER_COUNT, 0);
+    slots.resize((size_t)CLUSTER_COUNT * MAX_PER_CLUSTER);
+    std::atomic<size_t> lost{0};
+    auto bin = [&](size_t begin, size_t end) { lost += binSlices((int)begin, (int)end); };
+    if (jobs) jobs->parallelFor(SLICES, 2, bin);
+    else bin(0, SLICES);
+
+    // 3. Listy klastrów jedna za drugą
+    grid.resize((size_t)CLUSTER_COUNT * 2);
+    indices.clear();
+    maxPerCluster = 0;
+    occupied = 0;
+    for (int c = 0; c < CLUSTER_COUNT; ++c) {
+        grid[c * 2] = (uint32_t)indices.size();
+        grid[c * 2 + 1] = counts[c];
+        indices.insert(indices.end(), slots.begin() + (size_t)c * MAX_PER_CLUSTER, slots.begin() + (size_t)c * MAX_PER_CLUSTER + counts[c]);
+        maxPerCluster = std::max(maxPerCluster, (size_t)counts[c]);
+        occupied += counts[c] > 0;
+    }
+    overflow = lost;
+    lastBuildMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
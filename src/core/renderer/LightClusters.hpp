@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../math/Mat4.hpp"
+#include "../math/Vec3.hpp"
+
+class JobSystem;
+
+// --- KLASTRY ŚWIATEŁ (clustered forward) ---
+// Ostrosłup kamery dzielony na TILES_X x TILES_Y kafli ekranu i SLICES warstw głębokości (logarytmicznie
+// od SLICE_NEAR do far kamery, bliżej - warstwa 0). Światło to kula w przestrzeni świata (zasięg Point albo
+// kula opisana na stożku Spot) i trafia do list wszystkich klastrów, które przecina; fragment przechodzi
+// tylko po liście swojego klastra, więc koszt zależy od świateł w pobliżu, nie od wszystkich w scenie.
+// Binowanie na CPU: pudełka klastrów w przestrzeni widoku (liczone od nowa tylko po zmianie projekcji)
+// leżą w SoA, test kula-pudełko SSE idzie na 4 sąsiednie klastry w wierszu naraz. Warstwy głębokości
+// są dzielone między workery - każdy pisze tylko do swoich klastrów, bez synchronizacji.
+class LightClusters {
+public:
+    static const int TILES_X = 16, TILES_Y = 9, SLICES = 24;
+    static const int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES; // klaster = x + TILES_X * (y + TILES_Y * z)
+    static const int MAX_PER_CLUSTER = 128;  // nadmiar jest gubiony (getOverflow)
+    static constexpr float SLICE_NEAR = 0.5f;
+
+    // Kule świateł w przestrzeni świata; indeksy na listach = pozycje w tych tablicach (count <= 65535)
+    void build(const Vec3* centers, const float* radii, size_t count, const Mat4& view, const Mat4& proj, JobSystem* jobs);
+
+    const std::vector<uint32_t>& getGrid() const { return grid; } // na klaster: początek w getIndices(), liczba
+    const std::vector<uint16_t>& getIndices() const { return indices; }
+    // Warstwa fragmentu na głębokości d (metry przed kamerą): floor(log(d) * sliceScale + sliceBias)
+    float getSliceScale() const { return sliceScale; }
+    float getSliceBias() const { return sliceBias; }
+
+    float getLastBuildMs() const { return lastBuildMs; }
+    size_t getMaxPerCluster() const { return maxPerCluster; }
+    size_t getOccupiedClusters() const { return occupied; }
+    size_t getOverflow() const { return overflow; }
+
+private:
+    // Światło po przejściu do widoku: środek, r^2 i zakres klastrów do sprawdzenia
+    struct Binned {
+        float x, y, z, radiusSq;
+        int sliceLo, sliceHi, tileXLo, tileXHi, tileYLo, tileYHi;
+        uint16_t index; // pozycja w tablicach build()
+    };
+
+    void rebuildBounds(const Mat4& proj);
+    int sliceOf(float depth) const;
+    size_t binSlices(int sliceBegin, int sliceEnd); // zwraca zgubione wpisy
+
+    float projection[16] = {};
+    float zFar = 0.0f, sliceScale = 0.0f, sliceBias = 0.0f;
+    std::vector<float> boxMinX, boxMinY, boxMinZ, boxMaxX, boxMaxY, boxMaxZ; // po klastrach
+    std::vector<Binned> binned;
+    std::vector<uint16_t> counts, slots; // slots: MAX_PER_CLUSTER na klaster
+    std::vector<uint32_t> grid;
+    std::vector<uint16_t> indices;
+    float lastBuildMs = 0.0f;
+    size_t maxPerCluster = 0, occupied = 0, overflow = 0;
+};
@@ -0,0 +1,35 @@
+// Dekodowanie modeli, budowa otoczek i BVH do pickingu - bez wywołań GL, więc działa na workerach SceneLoadera
+// i w narzędziach konsolowych (DuckyReplay) bez kontekstu okna.
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+#include "Renderer.hpp"
+#include "../physics/ConvexHull.hpp"
+#include "../picking/MeshBvh.hpp"
+#include <iostream>
+
+static const int HULL_MAX_VERTICES = 64; // budżet otoczki collidera modelu
+
+bool PrimitiveRenderer::decodeModel(const std::string& path, std::vector<float>& data) {
+    tinyobj::attrib_t attrib; std::vector<tinyobj::shape_t> shapes; std::vector<tinyobj::material_t> materials; std::string warn, err;
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str())) { std::cout << "Model Err: " << warn << err << std::endl; return false; }
+    for (const auto& shape : shapes) {
+        for (const auto& index : shape.mesh.indices) {
+            data.push_back(attrib.vertices[3 * index.vertex_index + 0]); data.push_back(attrib.vertices[3 * index.vertex_index + 1]); data.push_back(attrib.vertices[3 * index.vertex_index + 2]);
+            if (index.normal_index >= 0) { data.push_back(attrib.normals[3 * index.normal_index + 0]); data.push_back(attrib.normals[3 * index.normal_index + 1]); data.push_back(attrib.normals[3 * index.normal_index + 2]); } else { data.push_back(0); data.push_back(1); data.push_back(0); }
+            if (index.texcoord_index >= 0) { data.push_back(attrib.texcoords[2 * index.texcoord_index + 0]); data.push_back(attrib.texcoords[2 * index.texcoord_index + 1]); } else { data.push_back(0); data.push_back(0); }
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const ConvexHull> PrimitiveRenderer::buildHull(const std::vector<float>& data) {
+    auto hull = std::make_shared<ConvexHull>();
+    if (!buildConvexHull(data.data(), data.size() / 8, 8, HULL_MAX_VERTICES, *hull)) return nullptr;
+    return hull;
+}
+
+std::shared_ptr<const MeshBvh> PrimitiveRenderer::buildBvh(const std::vector<float>& data) {
+    auto bvh = std::make_shared<MeshBvh>();
+    if (!buildMeshBvh(data.data(), data.size() / 8, 8, *bvh)) return nullptr;
+    return bvh;
+}
@@ -1,8 +1,12 @@
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "tiny_obj_loader.h"
 #include "stb_image.h"
 #include "Renderer.hpp"
-#include <iostream>
+#include "../ecs/World.hpp"
+#include "../physics/ConvexHull.hpp"
+#include "../physics/ProjectileSystem.hpp"
+#include "../picking/MeshBvh.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <vector>
 
 // ==========================================
@@ -31,19 +35,19 @@ layout (location = 2) in vec2 aTexCoord;
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
-out vec4 FragPosLightSpace;
+out float ViewDepth; // odległość przed kamerą (warstwa klastra)
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
 
 void main() {
     FragPos = vec3(model * vec4(aPos, 1.0));
     Normal = mat3(transpose(inverse(model))) * aNormal;
     TexCoord = aTexCoord;
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    vec4 viewPos = view * vec4(FragPos, 1.0);
+    ViewDepth = -viewPos.z;
+    gl_Position = projection * viewPos;
 })";
 
 const char* fShader = R"(
@@ -53,40 +57,122 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
-in vec4 FragPosLightSpace;
+in float ViewDepth;
 
-uniform vec3 lightPos;
+uniform vec3 lightDirection; // w stronę Słońca, znormalizowany
 uniform vec3 viewPos;
 uniform vec3 objectColor;
 
 uniform sampler2D texture_diffuse;
 uniform sampler2D texture_specular;
-uniform sampler2D shadowMap;
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 cascadeMatrices[4];
+uniform float cascadeTexel[4]; // rozmiar teksela kaskady w metrach
+uniform int cascadeCount;
+
+// Światła Point / Spot w klastrach (PrimitiveRenderer::LIGHT_TEXELS, LightClusters 16 x 9 x 24, MAX_ATLAS_TILES)
+uniform samplerBuffer lightData;    // 8 tekseli na światło, układ jak PrimitiveRenderer::lightBuffer
+uniform usamplerBuffer clusterGrid; // na klaster: początek listy w lightIndices, liczba świateł
+uniform usamplerBuffer lightIndices;
+uniform vec4 clusterParams;         // skala i przesunięcie warstwy (log głębokości), rozmiar viewportu
+uniform vec4 atlasTiles[48];        // kafel w uv atlasu: x, y, bok
+uniform sampler2DShadow shadowAtlas;
 
 uniform bool useTexture;
 uniform bool useSpecularMap;
 uniform float materialShininess;
 uniform float materialSpecularStrength;
 
-float ShadowCalculation(vec4 fragPosLightSpace) {
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    projCoords = projCoords * 0.5 + 0.5;
-    if(projCoords.z > 1.0) return 0.0;
-    float currentDepth = projCoords.z;
-    vec3 normal = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-    float bias = max(0.005 * (1.0 - dot(normal, lightDir)), 0.0005);
-
-    float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-    for(int x = -1; x <= 1; ++x) {
-        for(int y = -1; y <= 1; ++y) {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-            shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
-        }
+// Pierwsza (najdokładniejsza) kaskada, w której fragment mieści się razem z filtrem. Kaskada odświeżana
+// rzadziej może już nie pokrywać wycinka kamery - wtedy bierzemy następną zamiast czytać spoza mapy.
+float ShadowCalculation(vec3 normal) {
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float slope = 1.0 - max(dot(normal, lightDirection), 0.0);
+    for(int i = 0; i < cascadeCount; ++i) {
+        // Przesunięcie wzdłuż normalnej o ~teksel kaskady zamiast biasu głębokości (ten zależałby od zakresu kaskady)
+        vec3 pos = FragPos + normal * cascadeTexel[i] * (1.0 + 1.5 * slope);
+        vec3 c = (cascadeMatrices[i] * vec4(pos, 1.0)).xyz * 0.5 + 0.5; // ortogonalna: w == 1
+        if(any(lessThan(c.xy, texel * 2.0)) || any(greaterThan(c.xy, 1.0 - texel * 2.0)) || c.z > 1.0) continue;
+        // Porównanie sprzętowe z filtrem liniowym = PCF 2x2 w jednym odczycie; 4 odczyty po pół teksela
+        // pokrywają ten sam obszar 3x3 co dawne 9 ręcznych porównań
+        float depth = c.z - 0.0002;
+        float lit = texture(shadowMap, vec4(c.xy + vec2(-0.5, -0.5) * texel, i, depth))
+                  + texture(shadowMap, vec4(c.xy + vec2( 0.5, -0.5) * texel, i, depth))
+                  + texture(shadowMap, vec4(c.xy + vec2(-0.5,  0.5) * texel, i, depth))
+                  + texture(shadowMap, vec4(c.xy + vec2( 0.5,  0.5) * texel, i, depth));
+        return 1.0 - lit * 0.25;
+    }
+    return 0.0;
+}
+
+// Ściany cienia Point w kolejności +X -X +Y -Y +Z -Z, te same osie co lookAt w drawLocalShadows()
+const vec3 faceForward[6] = vec3[6](vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1));
+const vec3 faceUp[6] = vec3[6](vec3(0, -1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1), vec3(0, -1, 0), vec3(0, -1, 0));
+
+float LocalShadow(int i, vec4 posRange, bool spot, vec3 normal, float dist) {
+    vec4 info = texelFetch(lightData, i * 8 + 3); // pierwszy kafel (-1 = bez cienia), near, tan połowy kąta
+    int tile = int(info.x);
+    if(tile < 0) return 0.0;
+    float atlasSize = float(textureSize(shadowAtlas, 0).x);
+    float range = posRange.w, near = info.y;
+    vec4 rect = atlasTiles[tile];
+    // Offset wzdłuż normalnej o ~1.5 teksela kafla na tej odległości
+    vec3 pos = FragPos + normal * (3.0 * dist * info.z / (rect.z * atlasSize));
+    vec3 d = pos - posRange.xyz;
+    vec3 c;
+    if(spot) {
+        mat4 m = mat4(texelFetch(lightData, i * 8 + 4), texelFetch(lightData, i * 8 + 5), texelFetch(lightData, i * 8 + 6), texelFetch(lightData, i * 8 + 7));
+        vec4 p = m * vec4(pos, 1.0);
+        c = p.xyz / p.w * 0.5 + 0.5;
+        if(any(lessThan(c, vec3(0.0))) || any(greaterThan(c, vec3(1.0)))) return 0.0;
+    } else {
+        vec3 a = abs(d);
+        int face = (a.x >= a.y && a.x >= a.z) ? (d.x > 0.0 ? 0 : 1) : (a.y >= a.z ? (d.y > 0.0 ? 2 : 3) : (d.z > 0.0 ? 4 : 5));
+        rect = atlasTiles[tile + face];
+        vec3 f = faceForward[face];
+        vec3 s = normalize(cross(f, faceUp[face]));
+        vec3 u = cross(s, f);
+        float fd = dot(f, d);
+        c = vec3(dot(s, d) / fd, dot(u, d) / fd, (range + near) / (range - near) - 2.0 * range * near / ((range - near) * fd)) * 0.5 + 0.5;
+        if(c.z > 1.0) return 0.0;
+    }
+    // Pół teksela od krawędzi kafla, żeby filtr nie sięgał do sąsiada
+    float margin = 0.5 / (rect.z * atlasSize);
+    vec2 uv = rect.xy + clamp(c.xy, vec2(margin), vec2(1.0 - margin)) * rect.z;
+    return 1.0 - texture(shadowAtlas, vec3(uv, c.z));
+}
+
+vec3 LocalLight(int i, vec3 norm, vec3 viewDir, vec3 specMapColor) {
+    vec4 posRange = texelFetch(lightData, i * 8);
+    vec3 toLight = posRange.xyz - FragPos;
+    float dist = length(toLight);
+    float range = posRange.w;
+    if(dist >= range) return vec3(0.0);
+    vec3 L = toLight / dist;
+    float falloff = 1.0 - (dist * dist) / (range * range);
+    float att = falloff * falloff;
+    vec4 colorType = texelFetch(lightData, i * 8 + 1);
+    bool spot = colorType.w > 1.5;
+    if(spot) {
+        vec4 dirCos = texelFetch(lightData, i * 8 + 2);
+        float cutoff = dirCos.w; // miękka krawędź na ostatnich 10% stożka
+        att *= smoothstep(cutoff, mix(cutoff, 1.0, 0.1), dot(-L, dirCos.xyz));
     }
-    shadow /= 9.0;
-    return shadow;
+    if(att <= 0.0) return vec3(0.0);
+    float diff = max(dot(norm, L), 0.0);
+    float spec = materialSpecularStrength * pow(max(dot(viewDir, reflect(-L, norm)), 0.0), materialShininess);
+    float shadow = LocalShadow(i, posRange, spot, norm, dist);
+    return colorType.rgb * att * (1.0 - shadow) * (diff + spec * specMapColor);
+}
+
+// Światła z listy klastra fragmentu: kafel ekranu z gl_FragCoord (viewport od (0, 0)), warstwa z log głębokości
+vec3 ClusteredLights(vec3 norm, vec3 viewDir, vec3 specMapColor) {
+    ivec2 tile = min(ivec2(gl_FragCoord.xy / clusterParams.zw * vec2(16.0, 9.0)), ivec2(15, 8));
+    int slice = clamp(int(floor(log(max(ViewDepth, 1e-4)) * clusterParams.x + clusterParams.y)), 0, 23);
+    uvec2 cluster = texelFetch(clusterGrid, tile.x + 16 * (tile.y + 9 * slice)).xy;
+    vec3 local = vec3(0.0);
+    for(uint k = 0u; k < cluster.y; ++k) local += LocalLight(int(texelFetch(lightIndices, int(cluster.x + k)).r), norm, viewDir, specMapColor);
+    return local;
 }
 
 void main() {
@@ -95,7 +181,7 @@ void main() {
     vec3 ambient = ambientStrength * lightColor;
 
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = lightDirection;
     float diff = max(dot(norm, lightDir), 0.0);
     vec3 diffuse = diff * lightColor;
 
@@ -106,13 +192,34 @@ void main() {
     if(useSpecularMap) specMapColor = texture(texture_specular, TexCoord).rgb;
     vec3 specular = materialSpecularStrength * spec * lightColor * specMapColor;
 
-    float shadow = ShadowCalculation(FragPosLightSpace);
-    vec3 lighting = (ambient + (1.0 - shadow) * (diffuse + specular)) * objectColor;
+    float shadow = ShadowCalculation(norm);
+    vec3 local = ClusteredLights(norm, viewDir, specMapColor);
+    vec3 lighting = (ambient + (1.0 - shadow) * (diffuse + specular) + local) * objectColor;
 
     if(useTexture) FragColor = texture(texture_diffuse, TexCoord) * vec4(lighting, 1.0);
     else FragColor = vec4(lighting, 1.0);
 })";
 
+// --- Projectile Shader (instancje: pozycja z trzech strumieni SoA) ---
+const char* projectileVShader = R"(
+#version 410 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 3) in float aX;
+layout (location = 4) in float aY;
+layout (location = 5) in float aZ;
+uniform mat4 view;
+uniform mat4 projection;
+uniform float size;
+out vec3 Normal;
+void main() {
+    Normal = aNormal;
+    gl_Position = projection * view * vec4(aPos * size + vec3(aX, aY, aZ), 1.0);
+})";
+const char* projectileFShader = R"(#version 410 core
+out vec4 FragColor; in vec3 Normal;
+void main() { float l = 0.6 + 0.4 * max(dot(normalize(Normal), vec3(0.3, 0.9, 0.3)), 0.0); FragColor = vec4(vec3(1.0, 0.75, 0.2) * l, 1.0); })";
+
 // --- Grid & Skybox Shaders ---
 const char* gridVShader = R"(#version 410 core
 layout (location = 0) in vec3 aPos; uniform mat4 view; uniform mat4 projection;
@@ -132,6 +239,69 @@ void main() { FragColor = texture(skybox, TexCoords); })";
 // 2. IMPLEMENTACJA KLASY RENDERER
 // ==========================================
 
+// --- SIATKI PROCEDURALNE (Sfera, Walec) - format wierzchołka: pos(3) norm(3) uv(2) ---
+static const float PRIM_PI = 3.1415926535f;
+
+static void addVert(std::vector<float>& v, float x, float y, float z, float nx, float ny, float nz, float u, float tex_v) {
+    v.push_back(x); v.push_back(y); v.push_back(z);    // Pos
+    v.push_back(nx); v.push_back(ny); v.push_back(nz); // Norm
+    v.push_back(u); v.push_back(tex_v);                // UV
+}
+
+static void buildSphere(std::vector<float>& data, int sectors, int stacks) {
+    float radius = 0.5f;
+    auto getPoint = [&](int i, int j, float* p) {
+        float stackAngle = PRIM_PI / 2 - (float)i / stacks * PRIM_PI;
+        float sectorAngle = (float)j / sectors * 2 * PRIM_PI;
+        float xy = radius * cosf(stackAngle);
+        float z = xy * cosf(sectorAngle);
+        float x = xy * sinf(sectorAngle);
+        float y = radius * sinf(stackAngle);
+        p[0] = x; p[1] = y; p[2] = z; p[3] = x/radius; p[4] = y/radius; p[5] = z/radius; p[6] = (float)j / sectors; p[7] = (float)i / stacks;
+    };
+    auto add = [&](const float* p) { addVert(data, p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]); };
+
+    float p1[8], p2[8], p3[8], p4[8];
+    for(int i = 0; i < stacks; ++i) {
+        for(int j = 0; j < sectors; ++j) {
+            getPoint(i, j, p1);         // Top Left
+            getPoint(i + 1, j, p2);     // Bottom Left
+            getPoint(i, j + 1, p3);     // Top Right
+            getPoint(i + 1, j + 1, p4); // Bottom Right
+            if (i != 0) { add(p1); add(p2); add(p3); }
+            if (i != (stacks - 1)) { add(p3); add(p2); add(p4); }
+        }
+    }
+}
+
+static void buildCylinder(std::vector<float>& data, int sectors) {
+    float radius = 0.5f;
+    float halfH = 0.5f;
+    for(int i = 0; i < sectors; ++i) {
+        float angle1 = (float)i / sectors * 2.0f * PRIM_PI;
+        float angle2 = (float)(i + 1) / sectors * 2.0f * PRIM_PI;
+        float x1 = cosf(angle1) * radius; float z1 = sinf(angle1) * radius;
+        float x2 = cosf(angle2) * radius; float z2 = sinf(angle2) * radius;
+        float u1 = (float)i / sectors; float u2 = (float)(i + 1) / sectors;
+
+        // Ściana boczna
+        addVert(data, x1, halfH, z1, x1/radius, 0, z1/radius, u1, 1.0f);
+        addVert(data, x1, -halfH, z1, x1/radius, 0, z1/radius, u1, 0.0f);
+        addVert(data, x2, halfH, z2, x2/radius, 0, z2/radius, u2, 1.0f);
+        addVert(data, x2, halfH, z2, x2/radius, 0, z2/radius, u2, 1.0f);
+        addVert(data, x1, -halfH, z1, x1/radius, 0, z1/radius, u1, 0.0f);
+        addVert(data, x2, -halfH, z2, x2/radius, 0, z2/radius, u2, 0.0f);
+
+        // Denka
+        addVert(data, 0, halfH, 0, 0, 1, 0, 0.5f, 0.5f);
+        addVert(data, x1, halfH, z1, 0, 1, 0, (x1/radius+1)*0.5f, (z1/radius+1)*0.5f);
+        addVert(data, x2, halfH, z2, 0, 1, 0, (x2/radius+1)*0.5f, (z2/radius+1)*0.5f);
+        addVert(data, 0, -halfH, 0, 0, -1, 0, 0.5f, 0.5f);
+        addVert(data, x2, -halfH, z2, 0, -1, 0, (x2/radius+1)*0.5f, (z2/radius+1)*0.5f);
+        addVert(data, x1, -halfH, z1, 0, -1, 0, (x1/radius+1)*0.5f, (z1/radius+1)*0.5f);
+    }
+}
+
 PrimitiveRenderer::PrimitiveRenderer() {
     // 1. Shadery Phong
     unsigned int v = glCreateShader(GL_VERTEX_SHADER); glShaderSource(v, 1, &vShader, NULL); glCompileShader(v);
@@ -166,104 +336,619 @@ PrimitiveRenderer::PrimitiveRenderer() {
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
+    cubeBvh = buildBvh(cubeVertices);
+
+    // 3b. Sfera i Walec - jedna siatka na kształt, współdzielona przez wszystkie obiekty
+    std::vector<float> sphereData, cylinderData;
+    buildSphere(sphereData, 32, 24);
+    buildCylinder(cylinderData, 32);
+    sphereVao = uploadMesh(sphereData); sphereVertexCount = (int)(sphereData.size() / 8);
+    cylinderVao = uploadMesh(cylinderData); cylinderVertexCount = (int)(cylinderData.size() / 8);
+    sphereBvh = buildBvh(sphereData);
+    cylinderBvh = buildBvh(cylinderData);
 
     // 4. Inicjalizacja komponentów (TU BYŁ BŁĄD - brakowało definicji na dole)
     initGrid();
     initSkybox();
     initShadowMap();
+    initLightBuffers();
+    initProjectiles();
 }
 
 void PrimitiveRenderer::initShadowMap() {
-    glGenFramebuffers(1, &shadowMapFBO);
+    // Kaskady: porównanie sprzętowe (GL_COMPARE_REF_TO_TEXTURE) + filtr liniowy, poza mapą = oświetlone
     glGenTextures(1, &shadowMap);
-    glBindTexture(GL_TEXTURE_2D, shadowMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMap);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, SHADOW_WIDTH, SHADOW_HEIGHT, CASCADE_COUNT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
     float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    glBindFramebuffer(GL_FRAMEBUFFER, shadowMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowMap, 0);
-    glDrawBuffer(GL_NONE); glReadBuffer(GL_NONE); glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+    // Warstwa statyczna: ten sam format co shadowMap (kopiowana do niej glBlitFramebuffer), nie jest próbkowana
+    glGenTextures(1, &staticShadowMap);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, staticShadowMap);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, SHADOW_WIDTH, SHADOW_HEIGHT, CASCADE_COUNT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // FBO na warstwę; dalekie kaskady domyślnie co 2 i co 4 klatki
+    const int intervals[CASCADE_COUNT] = { 1, 1, 2, 4 };
+    for (int i = 0; i < CASCADE_COUNT; ++i) {
+        ShadowCascade& c = cascades[i];
+        c.interval = intervals[i];
+        glGenFramebuffers(1, &c.fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, c.fbo);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowMap, 0, i);
+        glDrawBuffer(GL_NONE); glReadBuffer(GL_NONE);
+        glGenFramebuffers(1, &c.staticFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, c.staticFbo);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticShadowMap, 0, i);
+        glDrawBuffer(GL_NONE); glReadBuffer(GL_NONE);
+    }
+
+    // Atlas świateł Point / Spot: głębokość perspektywiczna, porównanie sprzętowe jak w kaskadach
+    glGenTextures(1, &atlasMap);
+    glBindTexture(GL_TEXTURE_2D, atlasMap);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, ATLAS_SIZE, ATLAS_SIZE, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glGenFramebuffers(1, &atlasFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, atlasFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, atlasMap, 0);
+    glDrawBuffer(GL_NONE); glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void PrimitiveRenderer::renderSceneGeometry(const std::vector<SceneObject>& objects, unsigned int shader) {
-    for (const auto& obj : objects) {
-        if(obj.name == "Sun" && shader == depthShader) continue;
+void PrimitiveRenderer::initLightBuffers() {
+    struct { unsigned int* buffer; unsigned int* texture; GLenum format; } views[] = {
+        { &lightDataBuffer, &lightDataTexture, GL_RGBA32F },
+        { &clusterGridBuffer, &clusterGridTexture, GL_RG32UI },
+        { &lightIndexBuffer, &lightIndexTexture, GL_R16UI },
+    };
+    for (auto& v : views) {
+        glGenBuffers(1, v.buffer);
+        glBindBuffer(GL_TEXTURE_BUFFER, *v.buffer);
+        glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+        glGenTextures(1, v.texture);
+        glBindTexture(GL_TEXTURE_BUFFER, *v.texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, v.format, *v.buffer);
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
 
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, obj.transform.getModelMatrix().data());
+// Co klatkę nowy magazyn (orphaning) zamiast nadpisywania - sterownik nie czeka, aż GPU skończy poprzednią klatkę
+void PrimitiveRenderer::uploadLights() {
+    auto upload = [](unsigned int buffer, const void* data, size_t bytes) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, std::max(bytes, (size_t)16), NULL, GL_STREAM_DRAW);
+        if (bytes > 0) glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+    };
+    upload(lightDataBuffer, lightBuffer.data(), lightBuffer.size() * sizeof(float));
+    upload(clusterGridBuffer, clusters.getGrid().data(), clusters.getGrid().size() * sizeof(uint32_t));
+    upload(lightIndexBuffer, clusters.getIndices().data(), clusters.getIndices().size() * sizeof(uint16_t));
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
 
-        if (shader == shaderProgram) {
-            glUniform1f(glGetUniformLocation(shader, "materialShininess"), obj.material.shininess);
-            glUniform1f(glGetUniformLocation(shader, "materialSpecularStrength"), obj.material.specularStrength);
+void PrimitiveRenderer::drawMesh(MeshType type, unsigned int meshVao, int vertexCount) {
+    switch (type) {
+        case MeshType::Cube:     glBindVertexArray(vao[3]); glDrawArrays(GL_TRIANGLES, 0, 36); break;
+        case MeshType::Sphere:   glBindVertexArray(sphereVao); glDrawArrays(GL_TRIANGLES, 0, sphereVertexCount); break;
+        case MeshType::Cylinder: glBindVertexArray(cylinderVao); glDrawArrays(GL_TRIANGLES, 0, cylinderVertexCount); break;
+        case MeshType::Model:    if (meshVao) { glBindVertexArray(meshVao); glDrawArrays(GL_TRIANGLES, 0, vertexCount); } break;
+        default: break;
+    }
+}
 
-            glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, obj.textureId > 0 ? obj.textureId : 0);
-            glUniform1i(glGetUniformLocation(shader, "texture_diffuse"), 0);
-            glUniform1i(glGetUniformLocation(shader, "useTexture"), obj.textureId > 0);
+// --- CACHE CIENI ---
 
-            glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, obj.material.specularMapId > 0 ? obj.material.specularMapId : 0);
-            glUniform1i(glGetUniformLocation(shader, "texture_specular"), 1);
-            glUniform1i(glGetUniformLocation(shader, "useSpecularMap"), obj.material.specularMapId > 0);
+// Płaszczyzny ostrosłupa z macierzy projekcja * widok (wnętrze: n · p + d >= 0)
+static void frustumPlanes(const Mat4& viewProj, float planes[6][4]) {
+    const float* m = viewProj.data();
+    for (int i = 0; i < 6; ++i) {
+        int row = i / 2;
+        float sign = (i % 2) ? -1.0f : 1.0f;
+        for (int k = 0; k < 4; ++k) planes[i][k] = m[k * 4 + 3] + sign * m[k * 4 + row];
+    }
+}
 
-            if(obj.id != -1) // Hack na selectedId wewnątrz pętli pomocniczej (można poprawić)
-               glUniform3f(glGetUniformLocation(shader, "objectColor"), 1.0f, 1.0f, 1.0f);
-        }
+static bool boxInFrustum(const float planes[6][4], const Vec3& lo, const Vec3& hi) {
+    for (int i = 0; i < 6; ++i) {
+        const float* p = planes[i];
+        // Narożnik najdalej w stronę normalnej - jeśli on jest na zewnątrz, całe pudełko też
+        float x = p[0] >= 0.0f ? hi.x : lo.x, y = p[1] >= 0.0f ? hi.y : lo.y, z = p[2] >= 0.0f ? hi.z : lo.z;
+        if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.0f) return false;
+    }
+    return true;
+}
+
+// Po zmianie struktury świata: podział na statyczne (bez PhysicsBody) i dynamiczne
+void PrimitiveRenderer::collectCasters(World& world) {
+    staticCasters.clear();
+    dynamicCasters.clear();
+    world.each<Transform, MeshRenderer, Tag>([&](int id, const Transform&, const MeshRenderer&, const Tag&) {
+        ShadowCaster c = {};
+        c.id = id;
+        c.vao = ~0u; // wymusza pierwsze odświeżenie
+        (world.has<PhysicsBody>(id) ? dynamicCasters : staticCasters).push_back(c);
+    });
+}
 
-        if(obj.type == MeshType::Cube) { glBindVertexArray(vao[3]); glDrawArrays(GL_TRIANGLES, 0, 36); }
-        else if(obj.type == MeshType::Model) { glBindVertexArray(obj.vao); glDrawArrays(GL_TRIANGLES, 0, obj.vertexCount); }
+// Porównanie z ostatnio narysowanym stanem: macierz świata, siatka, flaga cienia
+bool PrimitiveRenderer::refreshCasters(World& world, std::vector<ShadowCaster>& casters) {
+    bool changed = false;
+    for (ShadowCaster& c : casters) {
+        const MeshRenderer& mesh = *world.get<MeshRenderer>(c.id);
+        const Mat4& m = world.getWorldMatrix(c.id);
+        bool casts = !(world.get<Tag>(c.id)->flags & Tag_NoShadow);
+        if (c.casts == casts && c.type == mesh.type && c.vao == mesh.vao && c.vertexCount == mesh.vertexCount &&
+            std::memcmp(c.world.data(), m.data(), sizeof(float) * 16) == 0) continue;
+        changed = true;
+        if (c.vao != ~0u) changedBoxes.push_back({ c.boxMin, c.boxMax }); // stary cień też trzeba zmazać
+        c.world = m; c.type = mesh.type; c.vao = mesh.vao; c.vertexCount = mesh.vertexCount; c.casts = casts;
+        // Pudełko siatki w przestrzeni modelu (prymitywy mieszczą się w sześcianie jednostkowym) -> świat
+        Vec3 lo(-0.5f, -0.5f, -0.5f), hi(0.5f, 0.5f, 0.5f);
+        if (mesh.type == MeshType::Model && mesh.bvh) { lo = mesh.bvh->bounds.min; hi = mesh.bvh->bounds.max; }
+        const float* w = m.data();
+        Vec3 ctr = (lo + hi) * 0.5f, h = (hi - lo) * 0.5f;
+        Vec3 center(w[0] * ctr.x + w[4] * ctr.y + w[8] * ctr.z + w[12], w[1] * ctr.x + w[5] * ctr.y + w[9] * ctr.z + w[13], w[2] * ctr.x + w[6] * ctr.y + w[10] * ctr.z + w[14]);
+        Vec3 half(std::fabs(w[0]) * h.x + std::fabs(w[4]) * h.y + std::fabs(w[8]) * h.z,
+                  std::fabs(w[1]) * h.x + std::fabs(w[5]) * h.y + std::fabs(w[9]) * h.z,
+                  std::fabs(w[2]) * h.x + std::fabs(w[6]) * h.y + std::fabs(w[10]) * h.z);
+        c.boxMin = center - half;
+        c.boxMax = center + half;
+        changedBoxes.push_back({ c.boxMin, c.boxMax });
     }
+    return changed;
 }
 
-void PrimitiveRenderer::drawShadows(const std::vector<SceneObject>& objects, const Vec3& lightPos) {
-    glUseProgram(depthShader);
-    float near_plane = 1.0f, far_plane = 30.0f;
-    Mat4 lightProj = MatrixTransform::perspective(90.0f * 0.01745f, 1.0f, near_plane, far_plane);
-    Mat4 lightView = MatrixTransform::lookAt(lightPos, Vec3(0,0,0), Vec3(0,1,0));
-    lightSpaceMatrix = lightProj * lightView;
-    glUniformMatrix4fv(glGetUniformLocation(depthShader, "lightSpaceMatrix"), 1, GL_FALSE, lightSpaceMatrix.data());
+void PrimitiveRenderer::renderCasters(const std::vector<ShadowCaster>& casters, const float planes[6][4], int skipId) {
+    GLint modelLoc = glGetUniformLocation(depthShader, "model");
+    for (const ShadowCaster& c : casters) {
+        if (!c.casts || c.id == skipId) continue;
+        if (!boxInFrustum(planes, c.boxMin, c.boxMax)) { shadowStats.culled++; continue; }
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, c.world.data());
+        drawMesh(c.type, c.vao, c.vertexCount);
+        shadowStats.drawn++;
+    }
+}
+
+// Kierunek w stronę Słońca: jego pozycja względem środka świata (jak dawny lookAt(lightPos, 0))
+static Vec3 sunDirection(const Vec3& lightPos) {
+    return lightPos.length() > 1e-4f ? lightPos.normalize() : Vec3(0.0f, 1.0f, 0.0f);
+}
+
+// Podział ostrosłupa kamery: mieszanka logarytmicznego i równego (lambda 0.75), do SHADOW_DISTANCE.
+// Kula opisana na wycinku ma środek na osi kamery, w równej odległości od narożników bliskich i dalekich.
+// Głębokość kaskady sięga aż do najbliższego Słońcu punktu sceny, żeby obiekty poza kamerą też rzucały cień;
+// zakres jest zaokrąglany do 8 m, inaczej każdy ruch (kamery, obiektu) zmieniałby macierz i wymuszał
+// przerysowanie warstwy statycznej.
+void PrimitiveRenderer::fitCascades(const Mat4& view, const Mat4& proj, const Vec3& sceneMin, const Vec3& sceneMax, Mat4* out, float* texelWorld) const {
+    const float* p = proj.data();
+    const float zNear = p[14] / (p[10] - 1.0f), zFar = p[14] / (p[10] + 1.0f);
+    const float diagonal = std::sqrt(1.0f / (p[0] * p[0]) + 1.0f / (p[5] * p[5])); // tan półprzekątnej ostrosłupa
+    const float range = std::min(zFar, SHADOW_DISTANCE);
+    Mat4 cameraWorld = MatrixTransform::inverseAffine(view);
+    const float* cw = cameraWorld.data();
+
+    Vec3 up = std::fabs(lightDirection.y) > 0.99f ? Vec3(0, 0, 1) : Vec3(0, 1, 0);
+    Mat4 lightView = MatrixTransform::lookAt(Vec3(0, 0, 0), lightDirection * -1.0f, up);
+    const float* lv = lightView.data();
+    auto toLight = [&](const Vec3& v) { return Vec3(lv[0] * v.x + lv[4] * v.y + lv[8] * v.z, lv[1] * v.x + lv[5] * v.y + lv[9] * v.z, lv[2] * v.x + lv[6] * v.y + lv[10] * v.z); };
+
+    // W przestrzeni światła patrzymy w -z: najbliżej Słońca = największe z
+    float sceneTop = -1e30f;
+    for (int k = 0; k < 8; ++k)
+        sceneTop = std::max(sceneTop, toLight(Vec3((k & 1) ? sceneMax.x : sceneMin.x, (k & 2) ? sceneMax.y : sceneMin.y, (k & 4) ? sceneMax.z : sceneMin.z)).z);
+    const float step = 8.0f;
+
+    float splitNear = zNear;
+    for (int i = 0; i < CASCADE_COUNT; ++i) {
+        float t = (float)(i + 1) / CASCADE_COUNT;
+        float splitFar = 0.75f * zNear * std::pow(range / zNear, t) + 0.25f * (zNear + (range - zNear) * t);
+        float a = splitNear * diagonal, b = splitFar * diagonal;
+        float depth = std::min((splitFar * splitFar + b * b - splitNear * splitNear - a * a) / (2.0f * (splitFar - splitNear)), splitFar);
+        float radius = std::sqrt((splitFar - depth) * (splitFar - depth) + b * b);
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+        Vec3 center(cw[12] - cw[8] * depth, cw[13] - cw[9] * depth, cw[14] - cw[10] * depth);
+
+        // Środek przyciągnięty do siatki tekseli - obraz kaskady przesuwa się o całe teksele
+        float texel = 2.0f * radius / SHADOW_WIDTH;
+        Vec3 c = toLight(center);
+        c.x = std::floor(c.x / texel) * texel;
+        c.y = std::floor(c.y / texel) * texel;
+        float zTop = std::ceil(std::max(sceneTop, c.z + radius) / step) * step;
+        float zBottom = std::floor((c.z - radius) / step) * step;
+        out[i] = MatrixTransform::orthographic(c.x - radius, c.x + radius, c.y - radius, c.y + radius, -zTop, -zBottom) * lightView;
+        texelWorld[i] = texel;
+        splitNear = splitFar;
+    }
+}
+
+void PrimitiveRenderer::drawShadows(World& world, const Vec3& lightPos, const Mat4& view, const Mat4& proj) {
+    shadowStats = ShadowStats();
+    changedBoxes.clear();
+    bool rebuilt = casterStructureVersion != world.getStructureVersion();
+    if (rebuilt) { collectCasters(world); casterStructureVersion = world.getStructureVersion(); }
+    bool staticChanged = refreshCasters(world, staticCasters) || rebuilt;
+    bool dynamicChanged = refreshCasters(world, dynamicCasters);
+    shadowStats.staticCasters = staticCasters.size();
+    shadowStats.dynamicCasters = dynamicCasters.size();
+
+    Vec3 direction = sunDirection(lightPos);
+    if (direction.x != lightDirection.x || direction.y != lightDirection.y || direction.z != lightDirection.z) {
+        lightDirection = direction;
+        for (ShadowCascade& c : cascades) c.valid = false;
+    }
 
+    // Pudełko sceny: wszystkie siatki, także te bez cienia (też są odbiorcami)
+    Vec3 sceneMin(1e30f, 1e30f, 1e30f), sceneMax(-1e30f, -1e30f, -1e30f);
+    for (const std::vector<ShadowCaster>* list : { &staticCasters, &dynamicCasters })
+        for (const ShadowCaster& c : *list) {
+            sceneMin = Vec3(std::min(sceneMin.x, c.boxMin.x), std::min(sceneMin.y, c.boxMin.y), std::min(sceneMin.z, c.boxMin.z));
+            sceneMax = Vec3(std::max(sceneMax.x, c.boxMax.x), std::max(sceneMax.y, c.boxMax.y), std::max(sceneMax.z, c.boxMax.z));
+        }
+    if (sceneMin.x > sceneMax.x) sceneMin = sceneMax = Vec3(0, 0, 0);
+
+    Mat4 fitted[CASCADE_COUNT];
+    float texel[CASCADE_COUNT];
+    fitCascades(view, proj, sceneMin, sceneMax, fitted, texel);
+
+    glUseProgram(depthShader);
+    GLint lightSpaceLoc = glGetUniformLocation(depthShader, "lightSpaceMatrix");
     glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-    glBindFramebuffer(GL_FRAMEBUFFER, shadowMapFBO);
-    glClear(GL_DEPTH_BUFFER_BIT);
     glCullFace(GL_FRONT);
-    renderSceneGeometry(objects, depthShader);
+    for (int i = 0; i < CASCADE_COUNT; ++i) {
+        ShadowCascade& c = cascades[i];
+        c.staticDirty |= staticChanged;
+        c.dynamicDirty |= dynamicChanged;
+        // Przesunięcie o i rozkłada kaskady z tym samym okresem na różne klatki
+        if (c.valid && (shadowFrame + i) % (uint64_t)c.interval != 0) { shadowStats.deferred++; continue; }
+        if (!c.valid || std::memcmp(c.lightSpace.data(), fitted[i].data(), sizeof(float) * 16) != 0) {
+            c.lightSpace = fitted[i];
+            c.texelWorld = texel[i];
+            c.staticDirty = true;
+        }
+        c.valid = true;
+        if (!c.staticDirty && !c.dynamicDirty) continue;
+
+        float planes[6][4];
+        frustumPlanes(c.lightSpace, planes);
+        glUniformMatrix4fv(lightSpaceLoc, 1, GL_FALSE, c.lightSpace.data());
+        if (c.staticDirty) {
+            glBindFramebuffer(GL_FRAMEBUFFER, c.staticFbo);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            renderCasters(staticCasters, planes);
+            shadowStats.staticRedrawn++;
+        }
+        // Warstwa statyczna jako punkt startu, dynamiczne dopisują się testem głębokości
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, c.staticFbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, c.fbo);
+        glBlitFramebuffer(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT, 0, 0, SHADOW_WIDTH, SHADOW_HEIGHT, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, c.fbo);
+        renderCasters(dynamicCasters, planes);
+        c.staticDirty = c.dynamicDirty = false;
+        shadowStats.updated++;
+    }
+    drawLocalShadows(world, rebuilt);
     glCullFace(GL_BACK);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    shadowFrame++;
+}
+
+// --- ATLAS CIENI ŚWIATEŁ ---
+
+static bool sphereInFrustum(const float planes[6][4], const Vec3& c, float radius) {
+    for (int i = 0; i < 6; ++i) {
+        const float* p = planes[i];
+        float len = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+        if (p[0] * c.x + p[1] * c.y + p[2] * c.z + p[3] < -radius * len) return false;
+    }
+    return true;
+}
+
+static bool boxTouchesSphere(const Vec3& lo, const Vec3& hi, const Vec3& c, float radius) {
+    float dx = std::max(lo.x - c.x, std::max(0.0f, c.x - hi.x));
+    float dy = std::max(lo.y - c.y, std::max(0.0f, c.y - hi.y));
+    float dz = std::max(lo.z - c.z, std::max(0.0f, c.z - hi.z));
+    return dx * dx + dy * dy + dz * dz <= radius * radius;
+}
+
+void PrimitiveRenderer::releaseTiles(LocalShadow& light) {
+    for (AtlasTile& t : light.tiles) { atlas.release(t); t = AtlasTile(); }
+    light.tileSize = 0;
+    light.rendered = false;
+}
+
+// Point bierze 6 kafli naraz albo żadnego
+bool PrimitiveRenderer::allocateTiles(LocalShadow& light, int size) {
+    int count = light.type == LightType::Point ? 6 : 1;
+    for (int f = 0; f < count; ++f) {
+        light.tiles[f] = atlas.allocate(size);
+        if (light.tiles[f].size == 0) { releaseTiles(light); return false; }
+    }
+    light.tileSize = size;
+    light.rendered = false;
+    light.dirty = true;
+    return true;
+}
+
+// Kula obejmująca zasięg światła: Point - cały zasięg, Spot - wycinek kuli (stożek + czasza) o połowie kąta angle.
+// Wąski stożek: środek na osi w R / (2 cos), szeroki: środek w R cos, promień R sin (zawiera wierzchołek i brzeg czaszy).
+static void lightBounds(LightType type, const Vec3& position, const Vec3& direction, float range, float angle, Vec3& center, float& radius) {
+    center = position;
+    radius = range;
+    if (type != LightType::Spot || angle >= 1.5707963f) return;
+    if (angle <= 0.7853982f) {
+        radius = range / (2.0f * std::cos(angle));
+        center = position + direction * radius;
+    } else {
+        center = position + direction * (range * std::cos(angle));
+        radius = range * std::sin(angle);
+    }
+}
+
+void PrimitiveRenderer::prepareLights(World& world, const Mat4& view, const Mat4& proj, JobSystem& jobs) {
+    lightStats = LightStats();
+    float planes[6][4];
+    frustumPlanes(proj * view, planes);
+    const Mat4 cameraWorld = MatrixTransform::inverseAffine(view);
+    const Vec3 eye(cameraWorld.data()[12], cameraWorld.data()[13], cameraWorld.data()[14]);
+    const float focal = proj.data()[5]; // 1 / tan(fov / 2)
+
+    // 1. Widoczne Point / Spot z pokryciem ekranu
+    frameLights.clear();
+    world.each<Light>([&](int id, Light& light) {
+        if ((light.type != LightType::Point && light.type != LightType::Spot) || light.range <= 0.0f) return;
+        const float* w = world.getWorldMatrix(id).data();
+        FrameLight fl;
+        fl.id = id;
+        fl.type = light.type;
+        fl.position = Vec3(w[12], w[13], w[14]);
+        fl.direction = Vec3(-w[4], -w[5], -w[6]).normalize();
+        fl.color = light.color * light.intensity;
+        fl.range = light.range;
+        fl.angle = light.type == LightType::Spot ? light.spotAngle : 0.0f;
+        Vec3 center;
+        float radius;
+        lightBounds(fl.type, fl.position, fl.direction, fl.range, fl.angle, center, radius);
+        if (!sphereInFrustum(planes, center, radius)) return;
+        // Pokrycie ekranu: promień kuli rzutowany na wysokość widoku (1 = cały ekran)
+        float dist = (center - eye).length();
+        fl.coverage = dist <= radius ? 1.0f : std::min(1.0f, radius * focal / std::sqrt(dist * dist - radius * radius));
+        fl.priority = light.castShadows ? std::max(light.shadowPriority, 0.0f) : 0.0f;
+        fl.score = fl.coverage * std::max(fl.priority, 0.01f);
+        frameLights.push_back(fl);
+    });
+    std::sort(frameLights.begin(), frameLights.end(), [](const FrameLight& a, const FrameLight& b) { return a.score > b.score; });
+    if ((int)frameLights.size() > MAX_FRAME_LIGHTS) frameLights.resize(MAX_FRAME_LIGHTS);
+
+    // 2. Bufor świateł dla shadera; cienie (teksel 3 i macierz) dopisuje drawLocalShadows()
+    lightBuffer.assign(frameLights.size() * LIGHT_TEXELS * 4, 0.0f);
+    lightCenters.resize(frameLights.size());
+    lightRadii.resize(frameLights.size());
+    for (size_t i = 0; i < frameLights.size(); ++i) {
+        const FrameLight& fl = frameLights[i];
+        float* t = lightBuffer.data() + i * LIGHT_TEXELS * 4;
+        t[0] = fl.position.x; t[1] = fl.position.y; t[2] = fl.position.z; t[3] = fl.range;
+        t[4] = fl.color.x; t[5] = fl.color.y; t[6] = fl.color.z; t[7] = fl.type == LightType::Point ? 1.0f : 2.0f;
+        t[8] = fl.direction.x; t[9] = fl.direction.y; t[10] = fl.direction.z; t[11] = std::cos(fl.angle);
+        t[12] = -1.0f; t[13] = LOCAL_SHADOW_NEAR; t[14] = fl.type == LightType::Point ? 1.0f : std::tan(fl.angle);
+        lightBounds(fl.type, fl.position, fl.direction, fl.range, fl.angle, lightCenters[i], lightRadii[i]);
+    }
+
+    // 3. Listy klastrów (warstwy głębokości na workerach)
+    clusters.build(lightCenters.data(), lightRadii.data(), frameLights.size(), view, proj, &jobs);
+    lightStats.visible = (int)frameLights.size();
+    lightStats.clusterMs = clusters.getLastBuildMs();
+    lightStats.maxPerCluster = clusters.getMaxPerCluster();
+    lightStats.occupiedClusters = clusters.getOccupiedClusters();
+    lightStats.dropped = clusters.getOverflow();
+}
+
+// Cienie dla najważniejszych świateł z prepareLights(): przydział kafli i przerysowanie zmienionych w limicie tileBudget
+void PrimitiveRenderer::drawLocalShadows(World& world, bool rebuilt) {
+    // 1. Kandydaci: pierwsze MAX_SHADOWED_LIGHTS z priorytetem cienia (frameLights są już posortowane)
+    struct Candidate { int id; float score; int size; size_t slot; }; // slot: pozycja w frameLights / lightBuffer
+    std::vector<Candidate> visible;
+    for (auto& entry : localShadows) entry.second.active = false;
+    for (size_t i = 0; i < frameLights.size() && (int)visible.size() < MAX_SHADOWED_LIGHTS; ++i) {
+        const FrameLight& fl = frameLights[i];
+        if (fl.priority <= 0.0f) continue;
+        LocalShadow& ls = localShadows[fl.id];
+        if (ls.type != fl.type || ls.range != fl.range || ls.angle != fl.angle ||
+            ls.position.x != fl.position.x || ls.position.y != fl.position.y || ls.position.z != fl.position.z ||
+            ls.direction.x != fl.direction.x || ls.direction.y != fl.direction.y || ls.direction.z != fl.direction.z) {
+            if (ls.type != fl.type) releaseTiles(ls);
+            ls.type = fl.type; ls.position = fl.position; ls.direction = fl.direction; ls.range = fl.range; ls.angle = fl.angle;
+            ls.dirty = true;
+        }
+        ls.active = true;
+        ls.score = fl.score;
+
+        // Bok kafla: potęga 2 od pokrycia * priorytet; zmniejszanie dopiero o dwa stopnie (bez skakania na granicy)
+        int maxTile = fl.type == LightType::Point ? ATLAS_MAX_TILE / 2 : ATLAS_MAX_TILE;
+        float wanted = fl.coverage * fl.priority * ATLAS_MAX_TILE;
+        int size = ATLAS_MIN_TILE;
+        while (size < wanted && size < maxTile) size *= 2;
+        if (ls.tileSize > size && ls.tileSize <= size * 2) size = ls.tileSize;
+        visible.push_back({ fl.id, ls.score, size, i });
+    }
+    // Usunięte ze świata albo bez cienia oddają kafle od razu
+    for (auto it = localShadows.begin(); it != localShadows.end();) {
+        const Light* light = world.get<Light>(it->first);
+        if (!light || !light->castShadows || light->shadowPriority <= 0.0f) { releaseTiles(it->second); it = localShadows.erase(it); }
+        else ++it;
+    }
+
+    // 2. Kafle: najpierw oddają te, które zmieniają bok; brak miejsca = wyrzucamy nieaktywne, potem najsłabsze aktywne
+    for (Candidate& c : visible) {
+        LocalShadow& ls = localShadows[c.id];
+        if (ls.tileSize != c.size) releaseTiles(ls);
+    }
+    std::vector<int> tileTable; // kafle widoczne dla shadera w tej klatce, Point po 6 kolejnych
+    for (size_t i = 0; i < visible.size(); ++i) {
+        LocalShadow& ls = localShadows[visible[i].id];
+        for (int size = visible[i].size; ls.tileSize == 0 && size >= ATLAS_MIN_TILE; size /= 2) {
+            while (!allocateTiles(ls, size)) {
+                LocalShadow* victim = nullptr;
+                for (auto& entry : localShadows)
+                    if (entry.second.tileSize > 0 && !entry.second.active && (!victim || entry.second.score < victim->score)) victim = &entry.second;
+                for (size_t j = visible.size(); !victim && j-- > i + 1;)
+                    if (localShadows[visible[j].id].tileSize > 0) victim = &localShadows[visible[j].id];
+                if (!victim) break;
+                releaseTiles(*victim);
+            }
+        }
+    }
+
+    // Przesunięty albo zmieniony caster w zasięgu (także stare miejsce - cień musi zniknąć) = przerysować
+    for (auto& entry : localShadows) {
+        LocalShadow& ls = entry.second;
+        if (ls.tileSize == 0 || ls.dirty) continue;
+        if (rebuilt) { ls.dirty = true; continue; }
+        for (const auto& box : changedBoxes)
+            if (boxTouchesSphere(box.first, box.second, ls.position, ls.range)) { ls.dirty = true; break; }
+    }
+
+    // 3. Rysowanie: najpierw światła bez żadnej zawartości, potem wg ważności, do limitu kafli
+    std::vector<int> order;
+    for (const Candidate& c : visible) {
+        const LocalShadow& ls = localShadows[c.id];
+        if (ls.tileSize > 0 && ls.dirty) order.push_back(c.id);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return !localShadows[a].rendered && localShadows[b].rendered; });
+    glBindFramebuffer(GL_FRAMEBUFFER, atlasFBO);
+    glEnable(GL_SCISSOR_TEST);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(1.5f, 4.0f);
+    GLint lightSpaceLoc = glGetUniformLocation(depthShader, "lightSpaceMatrix");
+    static const Vec3 faceForward[6] = { Vec3(1, 0, 0), Vec3(-1, 0, 0), Vec3(0, 1, 0), Vec3(0, -1, 0), Vec3(0, 0, 1), Vec3(0, 0, -1) };
+    static const Vec3 faceUp[6] = { Vec3(0, -1, 0), Vec3(0, -1, 0), Vec3(0, 0, 1), Vec3(0, 0, -1), Vec3(0, -1, 0), Vec3(0, -1, 0) };
+    int budget = tileBudget;
+    for (int id : order) {
+        LocalShadow& ls = localShadows[id];
+        int count = ls.type == LightType::Point ? 6 : 1;
+        // Pierwsze rysowanie zawsze (inaczej nowe światło nie miałoby cienia), reszta w limicie
+        if (ls.rendered && budget < count) { shadowStats.lightsWaiting++; continue; }
+        budget -= count;
+        for (int f = 0; f < count; ++f) {
+            if (ls.type == LightType::Point) {
+                ls.matrices[f] = MatrixTransform::perspective(90.0f, 1.0f, LOCAL_SHADOW_NEAR, ls.range) *
+                                 MatrixTransform::lookAt(ls.position, ls.position + faceForward[f], faceUp[f]);
+            } else {
+                Vec3 up = std::fabs(ls.direction.y) > 0.99f ? Vec3(0, 0, 1) : Vec3(0, 1, 0);
+                ls.matrices[f] = MatrixTransform::perspective(2.0f * ls.angle * 57.2957795f, 1.0f, LOCAL_SHADOW_NEAR, ls.range) *
+                                 MatrixTransform::lookAt(ls.position, ls.position + ls.direction, up);
+            }
+            const AtlasTile& t = ls.tiles[f];
+            glViewport(t.x, t.y, t.size, t.size);
+            glScissor(t.x, t.y, t.size, t.size);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            float lightPlanes[6][4];
+            frustumPlanes(ls.matrices[f], lightPlanes);
+            glUniformMatrix4fv(lightSpaceLoc, 1, GL_FALSE, ls.matrices[f].data());
+            // Własna siatka światła (ikona) nie zasłania go
+            renderCasters(staticCasters, lightPlanes, id);
+            renderCasters(dynamicCasters, lightPlanes, id);
+            shadowStats.tilesRendered++;
+        }
+        ls.rendered = true;
+        ls.dirty = false;
+    }
+    glPolygonOffset(0.0f, 0.0f);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_SCISSOR_TEST);
+
+    // 4. Kafle z zawartością: tabela dla shadera, pierwszy kafel i macierz Spot w tekselach światła
+    localTileCount = 0;
+    for (const Candidate& c : visible) {
+        const LocalShadow& ls = localShadows[c.id];
+        int count = ls.type == LightType::Point ? 6 : 1;
+        if (ls.tileSize == 0 || !ls.rendered || localTileCount + count > MAX_ATLAS_TILES) continue;
+        float* texels = lightBuffer.data() + c.slot * LIGHT_TEXELS * 4;
+        texels[12] = (float)localTileCount;
+        for (int f = 0; f < count; ++f) {
+            float* tile = atlasTiles + localTileCount++ * 4;
+            tile[0] = (float)ls.tiles[f].x / ATLAS_SIZE; tile[1] = (float)ls.tiles[f].y / ATLAS_SIZE;
+            tile[2] = (float)ls.tiles[f].size / ATLAS_SIZE; tile[3] = 0.0f;
+        }
+        if (ls.type == LightType::Spot) std::memcpy(texels + 16, ls.matrices[0].data(), sizeof(float) * 16);
+        shadowStats.shadowedLights++;
+    }
+    shadowStats.localLights = (int)visible.size();
+    shadowStats.atlasUsed = (float)atlas.getUsedArea() / ((float)ATLAS_SIZE * ATLAS_SIZE);
 }
 
-void PrimitiveRenderer::draw(const std::vector<SceneObject>& objects, const Mat4& view, const Mat4& proj, const Vec3& cameraPos, const Vec3& lightPos, int selectedId) {
+void PrimitiveRenderer::draw(World& world, const Mat4& view, const Mat4& proj, const Vec3& cameraPos, const Vec3& lightPos, int selectedId, int hoveredId) {
     glUseProgram(shaderProgram);
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, view.data());
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, proj.data());
-    glUniform3f(glGetUniformLocation(shaderProgram, "lightPos"), lightPos.x, lightPos.y, lightPos.z);
+    Vec3 lightDir = sunDirection(lightPos);
+    glUniform3f(glGetUniformLocation(shaderProgram, "lightDirection"), lightDir.x, lightDir.y, lightDir.z);
     glUniform3f(glGetUniformLocation(shaderProgram, "viewPos"), cameraPos.x, cameraPos.y, cameraPos.z);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "lightSpaceMatrix"), 1, GL_FALSE, lightSpaceMatrix.data());
 
-    glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, shadowMap);
+    // Kaskady z ostatniego rysowania (nie z tej klatki - rzadziej odświeżane mają starą macierz i starą zawartość)
+    float matrices[CASCADE_COUNT * 16], texels[CASCADE_COUNT];
+    int validCascades = 0;
+    while (validCascades < CASCADE_COUNT && cascades[validCascades].valid) {
+        std::memcpy(matrices + validCascades * 16, cascades[validCascades].lightSpace.data(), sizeof(float) * 16);
+        texels[validCascades] = cascades[validCascades].texelWorld;
+        validCascades++;
+    }
+    if (validCascades > 0) {
+        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "cascadeMatrices"), validCascades, GL_FALSE, matrices);
+        glUniform1fv(glGetUniformLocation(shaderProgram, "cascadeTexel"), validCascades, texels);
+    }
+    glUniform1i(glGetUniformLocation(shaderProgram, "cascadeCount"), validCascades);
+
+    glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMap);
     glUniform1i(glGetUniformLocation(shaderProgram, "shadowMap"), 2);
 
-    for (const auto& obj : objects) {
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, obj.transform.getModelMatrix().data());
+    // Światła Point / Spot z prepareLights() (z cieniami z drawShadows()) i listy klastrów
+    uploadLights();
+    glActiveTexture(GL_TEXTURE4); glBindTexture(GL_TEXTURE_BUFFER, lightDataTexture);
+    glUniform1i(glGetUniformLocation(shaderProgram, "lightData"), 4);
+    glActiveTexture(GL_TEXTURE5); glBindTexture(GL_TEXTURE_BUFFER, clusterGridTexture);
+    glUniform1i(glGetUniformLocation(shaderProgram, "clusterGrid"), 5);
+    glActiveTexture(GL_TEXTURE6); glBindTexture(GL_TEXTURE_BUFFER, lightIndexTexture);
+    glUniform1i(glGetUniformLocation(shaderProgram, "lightIndices"), 6);
+    GLint viewportRect[4];
+    glGetIntegerv(GL_VIEWPORT, viewportRect);
+    glUniform4f(glGetUniformLocation(shaderProgram, "clusterParams"), clusters.getSliceScale(), clusters.getSliceBias(), (float)viewportRect[2], (float)viewportRect[3]);
+    if (localTileCount > 0) glUniform4fv(glGetUniformLocation(shaderProgram, "atlasTiles"), localTileCount, atlasTiles);
+    glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, atlasMap);
+    glUniform1i(glGetUniformLocation(shaderProgram, "shadowAtlas"), 3);
+
+    world.each<Transform, MeshRenderer, Material>([&](int id, const Transform&, const MeshRenderer& mesh, const Material& material) {
+        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, world.getWorldMatrix(id).data());
 
-        glUniform1f(glGetUniformLocation(shaderProgram, "materialShininess"), obj.material.shininess);
-        glUniform1f(glGetUniformLocation(shaderProgram, "materialSpecularStrength"), obj.material.specularStrength);
+        glUniform1f(glGetUniformLocation(shaderProgram, "materialShininess"), material.shininess);
+        glUniform1f(glGetUniformLocation(shaderProgram, "materialSpecularStrength"), material.specularStrength);
 
-        glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, obj.textureId > 0 ? obj.textureId : 0);
+        glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, mesh.textureId > 0 ? mesh.textureId : 0);
         glUniform1i(glGetUniformLocation(shaderProgram, "texture_diffuse"), 0);
-        glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), obj.textureId > 0);
+        glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), mesh.textureId > 0);
 
-        glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, obj.material.specularMapId > 0 ? obj.material.specularMapId : 0);
+        glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, material.specularMapId > 0 ? material.specularMapId : 0);
         glUniform1i(glGetUniformLocation(shaderProgram, "texture_specular"), 1);
-        glUniform1i(glGetUniformLocation(shaderProgram, "useSpecularMap"), obj.material.specularMapId > 0);
+        glUniform1i(glGetUniformLocation(shaderProgram, "useSpecularMap"), material.specularMapId > 0);
 
-        if(obj.id == selectedId) glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 1.0f, 0.8f, 0.2f);
+        if(id == selectedId) glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 1.0f, 0.8f, 0.2f);
+        else if(id == hoveredId) glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 0.75f, 0.9f, 1.2f);
         else glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 1.0f, 1.0f, 1.0f);
 
-        if(obj.type == MeshType::Cube) { glBindVertexArray(vao[3]); glDrawArrays(GL_TRIANGLES, 0, 36); }
-        else if(obj.type == MeshType::Model) { glBindVertexArray(obj.vao); glDrawArrays(GL_TRIANGLES, 0, obj.vertexCount); }
-    }
+        drawMesh(mesh);
+    });
 }
 
 // =========================================================
@@ -286,6 +971,47 @@ void PrimitiveRenderer::initSkybox() {
     skyboxTextureID = loadCubemap(faces);
 }
 
+// Geometria sześcianu z vbo[3]; bufory instancji dostają rozmiar puli przy pierwszym rysowaniu
+void PrimitiveRenderer::initProjectiles() {
+    unsigned int v = glCreateShader(GL_VERTEX_SHADER); glShaderSource(v, 1, &projectileVShader, NULL); glCompileShader(v);
+    unsigned int f = glCreateShader(GL_FRAGMENT_SHADER); glShaderSource(f, 1, &projectileFShader, NULL); glCompileShader(f);
+    projectileShader = glCreateProgram(); glAttachShader(projectileShader, v); glAttachShader(projectileShader, f); glLinkProgram(projectileShader);
+    glDeleteShader(v); glDeleteShader(f);
+
+    glGenVertexArrays(1, &projectileVao); glGenBuffers(3, projectileVbo);
+    glBindVertexArray(projectileVao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo[3]);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
+    for (int k = 0; k < 3; ++k) {
+        glBindBuffer(GL_ARRAY_BUFFER, projectileVbo[k]);
+        glVertexAttribPointer(3 + k, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)0);
+        glEnableVertexAttribArray(3 + k);
+        glVertexAttribDivisor(3 + k, 1);
+    }
+    glBindVertexArray(0);
+}
+
+// Bufor jest osierocany co klatkę (glBufferData z nullptr), więc sterownik nie czeka na poprzednią klatkę
+void PrimitiveRenderer::drawProjectiles(const ProjectileSystem& projectiles, const Mat4& view, const Mat4& proj) {
+    const size_t count = projectiles.getCount();
+    if (count == 0) return;
+    if (projectileBufferSize < projectiles.getCapacity()) projectileBufferSize = projectiles.getCapacity();
+    const float* streams[3] = { projectiles.getX(), projectiles.getY(), projectiles.getZ() };
+    for (int k = 0; k < 3; ++k) {
+        glBindBuffer(GL_ARRAY_BUFFER, projectileVbo[k]);
+        glBufferData(GL_ARRAY_BUFFER, projectileBufferSize * sizeof(float), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(float), streams[k]);
+    }
+    glUseProgram(projectileShader);
+    glUniformMatrix4fv(glGetUniformLocation(projectileShader, "view"), 1, GL_FALSE, view.data());
+    glUniformMatrix4fv(glGetUniformLocation(projectileShader, "projection"), 1, GL_FALSE, proj.data());
+    glUniform1f(glGetUniformLocation(projectileShader, "size"), 0.08f);
+    glBindVertexArray(projectileVao);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei)count);
+    glBindVertexArray(0);
+}
+
 void PrimitiveRenderer::drawGrid(const Mat4& v, const Mat4& p) {
     glUseProgram(gridShader);
     glUniformMatrix4fv(glGetUniformLocation(gridShader,"view"),1,0,v.data());
@@ -307,8 +1033,21 @@ void PrimitiveRenderer::drawSkybox(const Mat4& v, const Mat4& p) {
 }
 
 unsigned int PrimitiveRenderer::loadTexture(const std::string& path) {
-    unsigned int t; glGenTextures(1,&t); int w,h,nr; unsigned char* d=stbi_load(path.c_str(),&w,&h,&nr,0);
-    if(d){GLenum f=(nr==4)?GL_RGBA:GL_RGB;glBindTexture(GL_TEXTURE_2D,t);glTexImage2D(GL_TEXTURE_2D,0,f,w,h,0,f,GL_UNSIGNED_BYTE,d);glGenerateMipmap(GL_TEXTURE_2D);stbi_image_free(d);}
+    ImageData img; decodeImage(path, img);
+    return uploadTexture(img);
+}
+
+bool PrimitiveRenderer::decodeImage(const std::string& path, ImageData& out) {
+    int w,h,nr; unsigned char* d=stbi_load(path.c_str(),&w,&h,&nr,0);
+    if(!d) return false;
+    out.width=w; out.height=h; out.channels=nr; out.pixels.assign(d, d + (size_t)w*h*nr);
+    stbi_image_free(d);
+    return true;
+}
+
+unsigned int PrimitiveRenderer::uploadTexture(const ImageData& img) {
+    unsigned int t; glGenTextures(1,&t);
+    if(!img.pixels.empty()){GLenum f=(img.channels==4)?GL_RGBA:GL_RGB;glBindTexture(GL_TEXTURE_2D,t);glTexImage2D(GL_TEXTURE_2D,0,f,img.width,img.height,0,f,GL_UNSIGNED_BYTE,img.pixels.data());glGenerateMipmap(GL_TEXTURE_2D);}
     return t;
 }
 
@@ -320,22 +1059,45 @@ unsigned int PrimitiveRenderer::loadCubemap(std::vector<std::string> faces) {
     return t;
 }
 
-SceneObject PrimitiveRenderer::loadModel(const std::string& path) {
+SceneObject PrimitiveRenderer::loadModel(const std::string& path, bool withHull) {
     SceneObject newObj; newObj.name = "Model"; newObj.type = MeshType::Model; newObj.transform.scale = Vec3(1,1,1); newObj.modelPath = path;
-    tinyobj::attrib_t attrib; std::vector<tinyobj::shape_t> shapes; std::vector<tinyobj::material_t> materials; std::string warn, err;
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str())) { std::cout << "Model Err: " << warn << err << std::endl; return newObj; }
     std::vector<float> data;
-    for (const auto& shape : shapes) {
-        for (const auto& index : shape.mesh.indices) {
-            data.push_back(attrib.vertices[3 * index.vertex_index + 0]); data.push_back(attrib.vertices[3 * index.vertex_index + 1]); data.push_back(attrib.vertices[3 * index.vertex_index + 2]);
-            if (index.normal_index >= 0) { data.push_back(attrib.normals[3 * index.normal_index + 0]); data.push_back(attrib.normals[3 * index.normal_index + 1]); data.push_back(attrib.normals[3 * index.normal_index + 2]); } else { data.push_back(0); data.push_back(1); data.push_back(0); }
-            if (index.texcoord_index >= 0) { data.push_back(attrib.texcoords[2 * index.texcoord_index + 0]); data.push_back(attrib.texcoords[2 * index.texcoord_index + 1]); } else { data.push_back(0); data.push_back(0); }
-        }
+    if (!decodeModel(path, data)) return newObj;
+    newObj.vertexCount = data.size() / 8; newObj.vao = uploadMesh(data);
+    auto cached = modelBvhs.find(path);
+    newObj.bvh = cached != modelBvhs.end() ? cached->second : cacheBvh(path, buildBvh(data));
+    if (withHull) {
+        auto it = modelHulls.find(path);
+        newObj.hull = it != modelHulls.end() ? it->second : cacheHull(path, buildHull(data));
     }
-    newObj.vertexCount = data.size() / 8; glGenVertexArrays(1, &newObj.vao); unsigned int vbo; glGenBuffers(1, &vbo);
-    glBindVertexArray(newObj.vao); glBindBuffer(GL_ARRAY_BUFFER, vbo); glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0); glEnableVertexAttribArray(0); glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1); glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
     return newObj;
 }
 
+std::shared_ptr<const ConvexHull> PrimitiveRenderer::cacheHull(const std::string& path, std::shared_ptr<const ConvexHull> hull) {
+    if (!hull) return nullptr;
+    return modelHulls.emplace(path, std::move(hull)).first->second;
+}
+
+std::shared_ptr<const MeshBvh> PrimitiveRenderer::cacheBvh(const std::string& path, std::shared_ptr<const MeshBvh> bvh) {
+    if (!bvh) return nullptr;
+    return modelBvhs.emplace(path, std::move(bvh)).first->second;
+}
+
+std::shared_ptr<const MeshBvh> PrimitiveRenderer::getPrimitiveBvh(MeshType type) const {
+    switch (type) {
+        case MeshType::Cube:     return cubeBvh;
+        case MeshType::Sphere:   return sphereBvh;
+        case MeshType::Cylinder: return cylinderBvh;
+        default: return nullptr;
+    }
+}
+
+unsigned int PrimitiveRenderer::uploadMesh(const std::vector<float>& data, unsigned int* outVbo) {
+    unsigned int vao, vbo; glGenVertexArrays(1, &vao); glGenBuffers(1, &vbo);
+    glBindVertexArray(vao); glBindBuffer(GL_ARRAY_BUFFER, vbo); glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0); glEnableVertexAttribArray(0); glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1); glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
+    if (outVbo) *outVbo = vbo;
+    return vao;
+}
+
 PrimitiveRenderer::~PrimitiveRenderer() {}
\ No newline at end of file
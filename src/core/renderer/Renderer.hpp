@@ -1,44 +1,206 @@
 #pragma once
 #include <glad/glad.h>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <string>
+#include "LightClusters.hpp"
+#include "ShadowAtlas.hpp"
 #include "../sceneobject/SceneObject.hpp"
+#include "../ecs/Components.hpp"
 #include "../math/Mat4.hpp"
 #include "../math/Vec3.hpp"
 
+class World;
+class ProjectileSystem;
+class JobSystem;
+
+// Zdekodowany obraz w pamięci CPU (przed wysłaniem na GPU)
+struct ImageData {
+    int width = 0, height = 0, channels = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// Statystyki ostatniego drawShadows() (okno Profiler)
+struct ShadowStats {
+    int updated = 0;        // kaskady narysowane w tej klatce (0 = wszystkie z poprzednich klatek)
+    int staticRedrawn = 0;  // w tym z warstwą statyczną od nowa (kaskada przesunęła się albo statyczny obiekt się zmienił)
+    int deferred = 0;       // kaskady, na które nie przypadała ta klatka (rzadsze odświeżanie dalekich)
+    size_t staticCasters = 0, dynamicCasters = 0;
+    size_t drawn = 0, culled = 0; // w tej klatce, kaskady (obie warstwy) i kafle atlasu (culled = poza ostrosłupem)
+    // Atlas świateł Point / Spot
+    int localLights = 0, shadowedLights = 0; // kandydaci do cienia (najważniejsze z prepareLights) / z kaflami w atlasie
+    int tilesRendered = 0, lightsWaiting = 0; // kafle narysowane w tej klatce / światła nieaktualne przez limit kafli
+    float atlasUsed = 0.0f;                   // zajęta część atlasu (0..1)
+};
+
+// Statystyki ostatniego prepareLights() (okno Profiler)
+struct LightStats {
+    int visible = 0;          // Point / Spot w ostrosłupie kamery (po limicie MAX_FRAME_LIGHTS)
+    float clusterMs = 0.0f;   // binowanie do klastrów
+    size_t maxPerCluster = 0, occupiedClusters = 0, dropped = 0; // dropped: ponad LightClusters::MAX_PER_CLUSTER
+};
+
 class PrimitiveRenderer {
 public:
     PrimitiveRenderer();
     ~PrimitiveRenderer();
 
-    // Rysowanie cieni (Pass 1)
-    void drawShadows(const std::vector<SceneObject>& objects, const Vec3& lightPos);
+    // Światła Point / Spot (Pass 0): odrzucenie poza ostrosłupem, ranking i przydział do klastrów (workery).
+    // Wywoływać przed drawShadows() - cienie dostają najważniejsze światła z tej listy.
+    void prepareLights(World& world, const Mat4& view, const Mat4& proj, JobSystem& jobs);
+    const LightStats& getLightStats() const { return lightStats; }
+
+    // Rysowanie cieni (Pass 1): kaskady Słońca dopasowane do ostrosłupa kamery (view/proj z Pass 2).
+    // W każdej kaskadzie statyczne z cache, dynamiczne na wierzchu, bez zmian = bez rysowania.
+    // lightPos to pozycja Słońca - liczy się tylko kierunek od środka świata (światło kierunkowe).
+    void drawShadows(World& world, const Vec3& lightPos, const Mat4& view, const Mat4& proj);
+    const ShadowStats& getShadowStats() const { return shadowStats; }
+    // Co ile klatek odświeżać kaskadę (1 = co klatkę); dalekie mogą czekać, shader bierze wtedy bliższą albo starą
+    void setCascadeInterval(int cascade, int frames) { if (cascade >= 0 && cascade < CASCADE_COUNT) cascades[cascade].interval = frames > 1 ? frames : 1; }
+    int getCascadeInterval(int cascade) const { return cascades[cascade].interval; }
+    // Ile kafli atlasu (ściana Point = kafel) wolno przerysować w jednej klatce; reszta czeka ze starą zawartością
+    void setShadowTileBudget(int tiles) { tileBudget = tiles > 1 ? tiles : 1; }
+    int getShadowTileBudget() const { return tileBudget; }
 
     // Główne rysowanie (Pass 2)
-    void draw(const std::vector<SceneObject>& objects, const Mat4& view, const Mat4& proj, const Vec3& cameraPos, const Vec3& lightPos, int selectedId = -1);
+    void draw(World& world, const Mat4& view, const Mat4& proj, const Vec3& cameraPos, const Vec3& lightPos, int selectedId = -1, int hoveredId = -1);
+
+    // Pociski: jedna instancja sześcianu na pocisk, pozycje prosto z SoA puli (bez macierzy per obiekt)
+    void drawProjectiles(const ProjectileSystem& projectiles, const Mat4& view, const Mat4& proj);
 
     void drawGrid(const Mat4& view, const Mat4& proj);
     void drawSkybox(const Mat4& view, const Mat4& proj);
 
     unsigned int loadTexture(const std::string& path);
     unsigned int loadCubemap(std::vector<std::string> faces);
-    SceneObject loadModel(const std::string& path);
+    // withHull: dołącza otoczkę wypukłą do kolizji (liczona raz na plik, potem z cache)
+    SceneObject loadModel(const std::string& path, bool withHull = true);
 
-    // Getter do FBO cieni (potrzebne w main.cpp)
-    unsigned int getShadowMapFBO() const { return shadowMapFBO; }
-    unsigned int getShadowWidth() const { return SHADOW_WIDTH; }
+    // --- Ładowanie dwuetapowe: dekodowanie (dowolny wątek) + upload (tylko wątek GL) ---
+    static bool decodeModel(const std::string& path, std::vector<float>& outVertices);
+    static bool decodeImage(const std::string& path, ImageData& outImage);
+    unsigned int uploadMesh(const std::vector<float>& vertices, unsigned int* outVbo = nullptr); // outVbo: do zwolnienia razem z VAO
+    unsigned int uploadTexture(const ImageData& image);
+    static std::shared_ptr<const ConvexHull> buildHull(const std::vector<float>& vertices); // dowolny wątek
+    static std::shared_ptr<const MeshBvh> buildBvh(const std::vector<float>& vertices);     // dowolny wątek
+    // Zapamiętuje otoczkę pliku; jeśli już jest w cache, zwraca tamtą (instancje dzielą jedną)
+    std::shared_ptr<const ConvexHull> cacheHull(const std::string& path, std::shared_ptr<const ConvexHull> hull);
+    std::shared_ptr<const MeshBvh> cacheBvh(const std::string& path, std::shared_ptr<const MeshBvh> bvh); // jak cacheHull
+    // BVH wspólnej siatki prymitywu (Cube / Sphere / Cylinder), nullptr dla pozostałych typów
+    std::shared_ptr<const MeshBvh> getPrimitiveBvh(MeshType type) const;
+
+    static const int CASCADE_COUNT = 4;
+    static const int MAX_FRAME_LIGHTS = 1024;   // Point / Spot oświetlające jedną klatkę (najważniejsze na ekranie)
+    static const int MAX_SHADOWED_LIGHTS = 16;  // z nich z cieniem w atlasie
+    static const int MAX_ATLAS_TILES = 48;      // kafle widoczne dla shadera w jednej klatce
+    unsigned int getShadowWidth() const { return SHADOW_WIDTH; }   // jednej kaskady
     unsigned int getShadowHeight() const { return SHADOW_HEIGHT; }
 
 private:
     unsigned int vao[4], vbo[4];
+    unsigned int sphereVao = 0, cylinderVao = 0; // wspólne siatki MeshType::Sphere / Cylinder
+    int sphereVertexCount = 0, cylinderVertexCount = 0;
+    std::shared_ptr<const MeshBvh> cubeBvh, sphereBvh, cylinderBvh; // picking prymitywów (te same trójkąty co VAO)
     unsigned int shaderProgram; // Główny shader (Phong + Shadows)
 
-    // --- SHADOW MAPPING ---
-    unsigned int shadowMapFBO;
-    unsigned int shadowMap;     // Tekstura głębokości
+    // --- SHADOW MAPPING (kaskady Słońca) ---
+    // Jedna tablica tekstur głębokości, warstwa na kaskadę; próbkowana z porównaniem sprzętowym (sampler2DArrayShadow).
+    // Kaskada to rzut ortogonalny na kulę opisaną na wycinku ostrosłupa kamery - promień nie zależy od obrotu
+    // kamery, a środek jest przyciągany do siatki tekseli, więc przy ruchu kamery krawędzie cieni nie migoczą.
+    struct ShadowCascade {
+        Mat4 lightSpace;            // z ostatniego rysowania (shader używa tej samej, także gdy kaskada czeka)
+        float texelWorld = 0.0f;    // rozmiar teksela w metrach (offset wzdłuż normalnej w shaderze)
+        int interval = 1;
+        bool valid = false;
+        bool staticDirty = true, dynamicDirty = true; // zmiany z klatek, w których kaskada czekała
+        unsigned int fbo = 0, staticFbo = 0;          // warstwa w shadowMap / staticShadowMap
+    };
+    unsigned int shadowMap;     // GL_TEXTURE_2D_ARRAY, CASCADE_COUNT warstw
     unsigned int depthShader;   // Prosty shader do renderowania z pktu widzenia słońca
-    const unsigned int SHADOW_WIDTH = 2048, SHADOW_HEIGHT = 2048; // Rozdzielczość cienia
-    Mat4 lightSpaceMatrix;      // Macierz widoku słońca
+    const unsigned int SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024; // Rozdzielczość jednej kaskady
+    const float SHADOW_DISTANCE = 100.0f; // dalej od kamery bez cieni (i nie dalej niż far kamery)
+    ShadowCascade cascades[CASCADE_COUNT];
+    Vec3 lightDirection = Vec3(0.0f, 1.0f, 0.0f); // w stronę Słońca
+    uint64_t shadowFrame = 0;
+
+    void fitCascades(const Mat4& view, const Mat4& proj, const Vec3& sceneMin, const Vec3& sceneMax, Mat4* out, float* texelWorld) const;
+
+    // --- CIENIE ŚWIATEŁ POINT / SPOT (atlas) ---
+    // Każde światło z cieniem ma kafle w jednym atlasie głębokości: Spot jeden (rzut perspektywiczny stożka),
+    // Point sześć (ściany sześcianu po 90 stopni). Bok kafla wynika z pokrycia ekranu przez zasięg światła
+    // i Light::shadowPriority. Kafle zostają między klatkami; przerysowanie tylko, gdy światło się zmieniło
+    // albo zmienił się caster w jego zasięgu, i najwyżej tileBudget kafli na klatkę.
+    struct LocalShadow {
+        LightType type = LightType::Point;
+        Vec3 position, direction;
+        float range = 0.0f, angle = 0.0f;
+        int tileSize = 0;        // 0 = brak kafli
+        AtlasTile tiles[6];      // Point: ściany +X -X +Y -Y +Z -Z, Spot: tiles[0]
+        Mat4 matrices[6];
+        float score = 0.0f;      // pokrycie ekranu * priorytet z ostatniej klatki, w której było widoczne
+        bool active = false;     // oświetla tę klatkę; nieaktywne trzymają kafle, dopóki nie zabraknie miejsca
+        bool rendered = false;   // kafle mają zawartość (może sprzed kilku klatek)
+        bool dirty = true;
+    };
+    static const int ATLAS_SIZE = 4096, ATLAS_MIN_TILE = 128, ATLAS_MAX_TILE = 1024;
+    const float LOCAL_SHADOW_NEAR = 0.05f; // near rzutów kafli (shader dostaje go w tekselu 3 światła)
+    ShadowAtlas atlas{ ATLAS_SIZE, ATLAS_MIN_TILE };
+    unsigned int atlasFBO = 0, atlasMap = 0; // sampler2DShadow jak kaskady
+    std::unordered_map<int, LocalShadow> localShadows; // id światła -> kafle
+    std::vector<std::pair<Vec3, Vec3>> changedBoxes;   // stare i nowe AABB casterów zmienionych w tej klatce
+    int tileBudget = 12;
+
+    float atlasTiles[MAX_ATLAS_TILES * 4];      // kafel w uv atlasu: x, y, bok (uniform dla draw())
+    int localTileCount = 0;
+
+    void drawLocalShadows(World& world, bool rebuilt);
+    bool allocateTiles(LocalShadow& light, int size);
+    void releaseTiles(LocalShadow& light);
+
+    // --- ŚWIATŁA W KLASTRACH (clustered forward) ---
+    // Wszystkie widoczne Point / Spot idą do shadera przez bufory tekstur (GL 4.1 nie ma SSBO): lightData po
+    // LIGHT_TEXELS tekseli RGBA32F na światło, clusterGrid (początek, liczba) na klaster i lightIndices z listami.
+    // Fragment liczy swój klaster z gl_FragCoord i głębokości, więc przechodzi tylko po światłach w pobliżu.
+    struct FrameLight {
+        int id;
+        LightType type;
+        Vec3 position, direction, color; // color * intensywność
+        float range, angle;
+        float priority;                  // Light::shadowPriority, 0 = bez cienia
+        float coverage, score;           // pokrycie ekranu, pokrycie * priorytet (kolejność na liście)
+    };
+    // Teksele światła: 0 pozycja, zasięg | 1 kolor, typ (1 Point, 2 Spot) | 2 kierunek, cos połowy kąta |
+    // 3 pierwszy kafel (-1 = bez cienia), near, tan połowy kąta | 4-7 Spot: świat -> kafel (kolumny)
+    static const int LIGHT_TEXELS = 8;
+    std::vector<FrameLight> frameLights; // widoczne w tej klatce, od najważniejszego
+    std::vector<float> lightBuffer;      // frameLights.size() * LIGHT_TEXELS * 4
+    std::vector<Vec3> lightCenters;      // kule świateł dla LightClusters (Spot: kula opisana na stożku)
+    std::vector<float> lightRadii;
+    LightClusters clusters;
+    LightStats lightStats;
+    unsigned int lightDataBuffer = 0, lightDataTexture = 0;
+    unsigned int clusterGridBuffer = 0, clusterGridTexture = 0;
+    unsigned int lightIndexBuffer = 0, lightIndexTexture = 0;
+
+    void initLightBuffers();
+    void uploadLights();
+
+    // Cache cieni: obiekty bez PhysicsBody rysowane raz do osobnej mapy (warstwa statyczna), kopiowanej co zmianę
+    // do shadowMap, na którą idą obiekty z PhysicsBody. Stan z ostatniego rysowania porównujemy co klatkę.
+    struct ShadowCaster {
+        int id;
+        Mat4 world;
+        Vec3 boxMin, boxMax; // AABB świata (do odrzucania poza ostrosłupem światła)
+        MeshType type;
+        unsigned int vao;
+        int vertexCount;
+        bool casts;          // bez Tag_NoShadow
+    };
+    unsigned int staticShadowMap = 0;
+    std::vector<ShadowCaster> staticCasters, dynamicCasters;
+    uint64_t casterStructureVersion = ~0ull;
+    ShadowStats shadowStats;
 
     // Grid
     unsigned int gridVao, gridVbo, gridShader;
@@ -48,10 +210,22 @@ private:
     unsigned int skyboxVAO, skyboxVBO, skyboxShader;
     unsigned int skyboxTextureID;
 
+    // Pociski: VAO z sześcianem + 3 strumienie instancji (x, y, z) z dzielnikiem 1
+    unsigned int projectileVao = 0, projectileShader = 0;
+    unsigned int projectileVbo[3] = {};
+    size_t projectileBufferSize = 0; // pojemność buforów instancji (pociski)
+
+    std::unordered_map<std::string, std::shared_ptr<const ConvexHull>> modelHulls; // ścieżka -> otoczka
+    std::unordered_map<std::string, std::shared_ptr<const MeshBvh>> modelBvhs;     // ścieżka -> BVH trójkątów
+
     void initGrid();
+    void initProjectiles();
     void initSkybox();
     void initShadowMap(); // Inicjalizacja buforów cieni
 
-    // Pomocnicza funkcja do rysowania geometrii (żeby nie dublować pętli for)
-    void renderSceneGeometry(const std::vector<SceneObject>& objects, unsigned int shader);
+    void collectCasters(World& world);
+    bool refreshCasters(World& world, std::vector<ShadowCaster>& casters); // true = coś się zmieniło
+    void renderCasters(const std::vector<ShadowCaster>& casters, const float planes[6][4], int skipId = -1);
+    void drawMesh(const MeshRenderer& mesh) { drawMesh(mesh.type, mesh.vao, mesh.vertexCount); }
+    void drawMesh(MeshType type, unsigned int meshVao, int vertexCount);
 };
\ No newline at end of file
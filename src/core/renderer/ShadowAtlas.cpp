@@ -0,0 +1,57 @@
+#include "ShadowAtlas.hpp"
+
+ShadowAtlas::ShadowAtlas(int size, int minTile) : atlasSize(size), minTile(minTile) {
+    clear();
+}
+
+void ShadowAtlas::clear() {
+    freeTiles.assign(levelOf(minTile) + 1, {});
+    freeTiles[0].push_back({ 0, 0, atlasSize });
+    usedArea = 0;
+}
+
+int ShadowAtlas::levelOf(int size) const {
+    int level = 0;
+    for (int s = atlasSize; s > size; s /= 2) level++;
+    return level;
+}
+
+AtlasTile ShadowAtlas::allocate(int size) {
+    if (size < minTile || size > atlasSize) return {};
+    const int level = levelOf(size);
+    // Najmniejszy wolny kafel >= size, potem dzielenie na czwórki aż do żądanego boku
+    int from = level;
+    while (from >= 0 && freeTiles[from].empty()) from--;
+    if (from < 0) return {};
+    AtlasTile tile = freeTiles[from].back();
+    freeTiles[from].pop_back();
+    for (int l = from; l < level; ++l) {
+        int half = tile.size / 2;
+        freeTiles[l + 1].push_back({ tile.x + half, tile.y, half });
+        freeTiles[l + 1].push_back({ tile.x, tile.y + half, half });
+        freeTiles[l + 1].push_back({ tile.x + half, tile.y + half, half });
+        tile.size = half;
+    }
+    usedArea += (size_t)tile.size * tile.size;
+    return tile;
+}
+
+void ShadowAtlas::release(const AtlasTile& released) {
+    if (released.size == 0) return;
+    usedArea -= (size_t)released.size * released.size;
+    AtlasTile tile = released;
+    // Łączenie z rodzeństwem: jeśli pozostałe trzy ćwiartki rodzica są wolne, wolny staje się rodzic
+    for (int level = levelOf(tile.size); level > 0; --level) {
+        int parent = tile.size * 2;
+        int px = tile.x - tile.x % parent, py = tile.y - tile.y % parent;
+        std::vector<AtlasTile>& list = freeTiles[level];
+        int found = 0;
+        for (const AtlasTile& t : list)
+            if (t.x - t.x % parent == px && t.y - t.y % parent == py) found++;
+        if (found < 3) break;
+        for (size_t i = list.size(); i-- > 0;)
+            if (list[i].x - list[i].x % parent == px && list[i].y - list[i].y % parent == py) { list[i] = list.back(); list.pop_back(); }
+        tile = { px, py, parent };
+    }
+    freeTiles[levelOf(tile.size)].push_back(tile);
+}
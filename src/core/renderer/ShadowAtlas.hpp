@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Kafel atlasu w tekselach (lewy dolny róg + bok)
+struct AtlasTile {
+    int x = 0, y = 0, size = 0; // size == 0: brak kafla
+};
+
+// --- ATLAS CIENI (przydział kafli) ---
+// Kwadratowy atlas dzielony jak buddy allocator: kafel o boku 2^k powstaje z podziału większego na 4,
+// a zwolniona czwórka łączy się z powrotem w rodzica. Kafel zostaje na swoim miejscu, dopóki światło
+// go nie odda - dzięki temu głębokość narysowana w poprzednich klatkach pozostaje ważna.
+// Sam przydział (CPU); teksturę i rysowanie trzyma PrimitiveRenderer.
+class ShadowAtlas {
+public:
+    ShadowAtlas(int size, int minTile);
+
+    AtlasTile allocate(int size); // size: potęga 2 z [minTile, size atlasu]; wynik size == 0 = brak miejsca
+    void release(const AtlasTile& tile);
+    void clear();
+
+    int getSize() const { return atlasSize; }
+    int getMinTile() const { return minTile; }
+    size_t getUsedArea() const { return usedArea; } // w tekselach
+
+private:
+    int levelOf(int size) const; // 0 = cały atlas
+
+    int atlasSize, minTile;
+    std::vector<std::vector<AtlasTile>> freeTiles; // po poziomie
+    size_t usedArea = 0;
+};
@@ -0,0 +1,38 @@
+#include "InputCapture.hpp"
+#include <fstream>
+
+static const int CAPTURE_VERSION = 2; // 2: LOD symulacji
+
+bool InputCapture::save(const std::string& path) const {
+    nlohmann::json j;
+    j["version"] = CAPTURE_VERSION;
+    j["fixedStep"] = fixedStep;
+    j["lod"] = { {"enabled", lod.enabled}, {"nearDistance", lod.nearDistance}, {"farDistance", lod.farDistance} };
+    j["scene"] = scene;
+    j["input"] = input;
+    j["stateHash"] = stateHash;
+    std::ofstream out(path);
+    if (!out) return false;
+    out << j.dump();
+    return (bool)out;
+}
+
+bool InputCapture::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+    nlohmann::json j = nlohmann::json::parse(in, nullptr, false);
+    if (j.is_discarded() || j.value("version", 0) != CAPTURE_VERSION) return false;
+    if (!j.contains("scene") || !j.contains("input") || !j.contains("stateHash")) return false;
+    fixedStep = j.value("fixedStep", 1.0f / 60.0f);
+    lod = SimulationLod();
+    if (j.contains("lod")) {
+        const nlohmann::json& l = j["lod"];
+        lod.enabled = l.value("enabled", false);
+        lod.nearDistance = l.value("nearDistance", lod.nearDistance);
+        lod.farDistance = l.value("farDistance", lod.farDistance);
+    }
+    scene = j["scene"];
+    input = j["input"].get<std::vector<uint32_t>>();
+    stateHash = j["stateHash"].get<std::vector<uint64_t>>();
+    return input.size() == stateHash.size();
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../json.hpp"
+#include "../physics/PhysicsWorld.hpp"
+
+// --- NAGRANIE SESJI PLAY ---
+// Scena z chwili startu (serializeSceneObject) + bity InputBits i PhysicsWorld::stateHash() po każdej klatce.
+// Nagrywana sesja idzie w trybie deterministycznym (jeden krok fixedStep na klatkę), więc DuckyReplay
+// odtwarza ją bez okna i porównuje skróty klatka po klatce. Edycje w inspektorze w trakcie gry nie są nagrywane.
+// Ustawienia LOD symulacji idą z nagraniem - poziomy ciał zmieniają wynik kroku (budżet jest wtedy wyłączony).
+struct InputCapture {
+    float fixedStep = 1.0f / 60.0f;
+    SimulationLod lod;
+    nlohmann::json scene = nlohmann::json::array();
+    std::vector<uint32_t> input;
+    std::vector<uint64_t> stateHash;
+
+    void begin(const nlohmann::json& snapshot, float step, const SimulationLod& simulationLod) {
+        scene = snapshot; fixedStep = step; lod = simulationLod; input.clear(); stateHash.clear();
+    }
+    void record(uint32_t bits, uint64_t hash) { input.push_back(bits); stateHash.push_back(hash); }
+    size_t getFrameCount() const { return input.size(); }
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
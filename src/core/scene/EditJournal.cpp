@@ -0,0 +1,280 @@
+#include "EditJournal.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+static void syncFile(FILE* f) { fflush(f); _commit(_fileno(f)); }
+#else
+#include <unistd.h>
+static void syncFile(FILE* f) { fflush(f); fsync(fileno(f)); }
+#endif
+
+namespace fs = std::filesystem;
+
+static const char SNAPSHOT_MAGIC[4] = {'D','K','S','N'};
+static const char JOURNAL_MAGIC[4]  = {'D','K','J','R'};
+static const uint32_t JOURNAL_VERSION = 6; // 2: tagi i światła, 3: rodzic w SceneObject, 4: CCD, 5: trigger, 6: cienie świateł
+static const int COMPACT_AFTER_OPS = 2000;
+static const size_t COMPACT_AFTER_BYTES = 4 * 1024 * 1024;
+static const uint32_t MAX_FRAME_BYTES = 256 * 1024 * 1024; // większa długość = uszkodzony wpis
+
+// FNV-1a - wykrywa urwane/uszkodzone wpisy na końcu dziennika
+static uint32_t checksum(const uint8_t* data, size_t size) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; ++i) { h ^= data[i]; h *= 16777619u; }
+    return h;
+}
+
+static void writeFrame(FILE* f, const std::vector<uint8_t>& payload) {
+    uint32_t len = (uint32_t)payload.size(), crc = checksum(payload.data(), payload.size());
+    fwrite(&len, 4, 1, f); fwrite(&crc, 4, 1, f); fwrite(payload.data(), 1, payload.size(), f);
+}
+
+// Długość nie jest objęta sumą kontrolną - przed alokacją sprawdzamy ją z limitem i resztą pliku,
+// uszkodzona długość to urwany koniec dziennika jak zła suma (a nie bad_alloc przy starcie)
+static bool readFrame(std::ifstream& in, std::vector<uint8_t>& payload) {
+    uint32_t len = 0, crc = 0;
+    if (!in.read((char*)&len, 4) || !in.read((char*)&crc, 4)) return false;
+    if (len > MAX_FRAME_BYTES) return false;
+    const std::streampos pos = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff left = in.tellg() - pos;
+    in.seekg(pos);
+    if (left < 0 || (uint64_t)left < len) return false;
+    payload.resize(len);
+    if (len && !in.read((char*)payload.data(), len)) return false;
+    return checksum(payload.data(), payload.size()) == crc;
+}
+
+// ==========================================
+// REPLIKA
+// ==========================================
+bool EditJournal::Replica::apply(const uint8_t* data, size_t size) {
+    BinaryReader r(data, size);
+    uint8_t op = 0;
+    if (!r.get(op)) return false;
+    switch ((JournalOp)op) {
+        case JournalOp::Upsert: {
+            SceneObject o;
+            if (!readBinary(r, o)) return false;
+            auto it = order.find(o.id);
+            if (it != order.end()) objects[it->second] = o;
+            else { order[o.id] = nextOrder; objects[nextOrder++] = o; }
+            return true;
+        }
+        case JournalOp::Remove: {
+            int32_t id = 0;
+            if (!r.get(id)) return false;
+            auto it = order.find(id);
+            if (it != order.end()) { objects.erase(it->second); order.erase(it); }
+            return true;
+        }
+        case JournalOp::Clear:
+            objects.clear(); order.clear();
+            return true;
+        case JournalOp::Patch: {
+            int32_t id = 0; FieldPatch p{};
+            uint32_t len = 0;
+            if (!r.get(id) || !r.get(p.index) || !r.get(len) || (size_t)(r.end - r.cur) < len) return false;
+            p.after.assign(r.cur, r.cur + len);
+            auto it = order.find(id);
+            if (it != order.end()) applyPatch(objects[it->second], p, true);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ==========================================
+// WĄTEK UI - tylko serializacja i kolejka
+// ==========================================
+EditJournal::~EditJournal() { stop(); }
+
+void EditJournal::push(std::vector<uint8_t>&& record) {
+    if (!running) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(std::move(record));
+}
+
+void EditJournal::recordUpsert(const SceneObject& o) {
+    if (!running) return;
+    BinaryWriter w; w.put((uint8_t)JournalOp::Upsert); writeBinary(o, w);
+    push(std::move(w.bytes));
+}
+
+void EditJournal::recordRemove(int id) {
+    if (!running) return;
+    BinaryWriter w; w.put((uint8_t)JournalOp::Remove); w.put((int32_t)id);
+    push(std::move(w.bytes));
+}
+
+void EditJournal::recordReset(const std::vector<SceneObject>& objects) {
+    if (!running) return;
+    BinaryWriter w; w.put((uint8_t)JournalOp::Clear);
+    push(std::move(w.bytes));
+    for (const auto& o : objects) recordUpsert(o);
+}
+
+void EditJournal::recordDelta(const SceneDelta& delta, bool forward) {
+    if (!running) return;
+    if (forward) for (const auto& r : delta.removed) recordRemove(r.second.id);
+    else for (const auto& a : delta.added) recordRemove(a.id);
+    for (const auto& m : delta.modified) {
+        for (const auto& p : m.patches) {
+            const std::vector<uint8_t>& bytes = forward ? p.after : p.before;
+            BinaryWriter w; w.put((uint8_t)JournalOp::Patch); w.put((int32_t)m.id); w.put(p.index); w.put((uint32_t)bytes.size()); w.write(bytes.data(), bytes.size());
+            push(std::move(w.bytes));
+        }
+    }
+    if (forward) for (const auto& a : delta.added) recordUpsert(a);
+    else for (const auto& r : delta.removed) recordUpsert(r.second);
+}
+
+void EditJournal::requestSnapshot() {
+    if (!running) return;
+    { std::lock_guard<std::mutex> lock(mutex); snapshotRequested = true; }
+    cv.notify_all();
+}
+
+void EditJournal::start(const std::string& dir) {
+    if (running) return;
+    directory = dir;
+    std::error_code ec; fs::create_directories(directory, ec);
+    { std::lock_guard<std::mutex> lock(mutex); stopping = false; snapshotRequested = false; queue.clear(); }
+    running = true;
+    worker = std::thread(&EditJournal::threadMain, this);
+}
+
+void EditJournal::stop() {
+    if (!running) return;
+    { std::lock_guard<std::mutex> lock(mutex); stopping = true; }
+    cv.notify_all();
+    if (worker.joinable()) worker.join();
+    running = false;
+}
+
+// ==========================================
+// WĄTEK DZIENNIKA
+// ==========================================
+void EditJournal::threadMain() {
+    // Startujemy od tego, co zostało na dysku, i od razu kompaktujemy do świeżego snapshotu
+    replica = Replica();
+    loadSnapshot((fs::path(directory) / "scene.snapshot").string(), replica);
+    replayJournal((fs::path(directory) / "scene.journal").string(), replica);
+    std::error_code ec; fs::remove(fs::path(directory) / "clean", ec);
+    compact();
+
+    std::vector<std::vector<uint8_t>> batch;
+    for (;;) {
+        bool stop, snapshot;
+        {
+            // Paczkowanie: budzimy się co 250ms (lub od razu przy stop/snapshot) -> jeden fsync na paczkę
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait_for(lock, std::chrono::milliseconds(250), [&] { return stopping || snapshotRequested; });
+            batch.swap(queue);
+            stop = stopping;
+            snapshot = snapshotRequested;
+            snapshotRequested = false;
+        }
+        writeBatch(batch);
+        if (snapshot || opsSinceSnapshot >= COMPACT_AFTER_OPS || journalBytes >= COMPACT_AFTER_BYTES) compact();
+        if (stop) break;
+    }
+
+    compact();
+    if (journalFile) { fclose(journalFile); journalFile = nullptr; }
+    std::ofstream(fs::path(directory) / "clean") << "1";
+}
+
+void EditJournal::writeBatch(std::vector<std::vector<uint8_t>>& batch) {
+    if (batch.empty()) return;
+    for (const auto& rec : batch) {
+        if (journalFile) writeFrame(journalFile, rec);
+        replica.apply(rec.data(), rec.size());
+        journalBytes += 8 + rec.size();
+        opsSinceSnapshot++;
+    }
+    if (journalFile) syncFile(journalFile);
+    batch.clear();
+}
+
+void EditJournal::openJournal() {
+    if (journalFile) fclose(journalFile);
+    journalFile = fopen((fs::path(directory) / "scene.journal").string().c_str(), "wb");
+    if (!journalFile) { std::cout << "ERROR::JOURNAL:: Cannot open journal in " << directory << std::endl; return; }
+    fwrite(JOURNAL_MAGIC, 1, 4, journalFile); fwrite(&JOURNAL_VERSION, 4, 1, journalFile);
+    syncFile(journalFile);
+    journalBytes = 8;
+}
+
+// Snapshot zapisujemy obok i podmieniamy rename'em - stary snapshot + dziennik są ważne aż do końca
+void EditJournal::compact() {
+    fs::path finalPath = fs::path(directory) / "scene.snapshot";
+    fs::path tmpPath = fs::path(directory) / "scene.snapshot.tmp";
+    FILE* f = fopen(tmpPath.string().c_str(), "wb");
+    if (!f) { std::cout << "ERROR::JOURNAL:: Cannot write snapshot in " << directory << std::endl; return; }
+    uint32_t count = (uint32_t)replica.objects.size();
+    fwrite(SNAPSHOT_MAGIC, 1, 4, f); fwrite(&JOURNAL_VERSION, 4, 1, f); fwrite(&count, 4, 1, f);
+    for (const auto& entry : replica.objects) {
+        BinaryWriter w; writeBinary(entry.second, w);
+        writeFrame(f, w.bytes);
+    }
+    syncFile(f);
+    fclose(f);
+    std::error_code ec; fs::rename(tmpPath, finalPath, ec);
+    if (ec) { std::cout << "ERROR::JOURNAL:: " << ec.message() << std::endl; return; }
+
+    // Wpisy dziennika są idempotentne, więc crash między rename a obcięciem dziennika niczego nie psuje
+    openJournal();
+    opsSinceSnapshot = 0;
+}
+
+bool EditJournal::loadSnapshot(const std::string& path, Replica& replica) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    char magic[4]; uint32_t version = 0, count = 0;
+    if (!in.read(magic, 4) || memcmp(magic, SNAPSHOT_MAGIC, 4) != 0) return false;
+    if (!in.read((char*)&version, 4) || version != JOURNAL_VERSION || !in.read((char*)&count, 4)) return false;
+    std::vector<uint8_t> payload;
+    for (uint32_t i = 0; i < count && readFrame(in, payload); ++i) {
+        BinaryReader r(payload);
+        SceneObject o;
+        if (!readBinary(r, o)) break;
+        replica.order[o.id] = replica.nextOrder;
+        replica.objects[replica.nextOrder++] = o;
+    }
+    return true;
+}
+
+void EditJournal::replayJournal(const std::string& path, Replica& replica) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return;
+    char magic[4]; uint32_t version = 0;
+    if (!in.read(magic, 4) || memcmp(magic, JOURNAL_MAGIC, 4) != 0) return;
+    if (!in.read((char*)&version, 4) || version != JOURNAL_VERSION) return;
+    // Zatrzymujemy się na pierwszym urwanym wpisie (crash w trakcie zapisu)
+    std::vector<uint8_t> payload;
+    while (readFrame(in, payload)) {
+        if (!replica.apply(payload.data(), payload.size())) break;
+    }
+}
+
+bool EditJournal::hasRecoverableData(const std::string& dir) {
+    fs::path d(dir);
+    std::error_code ec;
+    bool hasData = fs::exists(d / "scene.snapshot", ec) || fs::exists(d / "scene.journal", ec);
+    return hasData && !fs::exists(d / "clean", ec);
+}
+
+bool EditJournal::recover(const std::string& dir, std::vector<SceneObject>& out) {
+    Replica r;
+    bool ok = loadSnapshot((fs::path(dir) / "scene.snapshot").string(), r);
+    replayJournal((fs::path(dir) / "scene.journal").string(), r);
+    out.clear();
+    for (const auto& entry : r.objects) out.push_back(entry.second);
+    return ok || !out.empty();
+}
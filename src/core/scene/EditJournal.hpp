@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../sceneobject/SceneSerializer.hpp"
+
+// Rodzaje wpisów w dzienniku edycji
+enum class JournalOp : uint8_t { Upsert = 1, Remove = 2, Clear = 3, Patch = 4 };
+
+// --- DZIENNIK EDYCJI (AUTOSAVE ODPORNY NA CRASH) ---
+// Wątek UI tylko serializuje zmianę (koszt ~ rozmiar edycji) i wrzuca ją do kolejki.
+// Wątek w tle dopisuje wpisy do scene.journal (fsync raz na paczkę), trzyma własną replikę sceny
+// i co jakiś czas kompaktuje ją do scene.snapshot. Odzysk = snapshot + odtworzenie dziennika.
+class EditJournal {
+public:
+    EditJournal() = default;
+    ~EditJournal();
+
+    void start(const std::string& directory);
+    void stop(); // czyste zamknięcie: flush + snapshot + znacznik "clean"
+    bool isRunning() const { return running; }
+
+    void recordUpsert(const SceneObject& o);
+    void recordRemove(int id);
+    void recordReset(const std::vector<SceneObject>& objects); // nowa / wczytana scena
+    void recordDelta(const SceneDelta& delta, bool forward);   // zmiany z Undo/Redo
+    void requestSnapshot();
+
+    // Odzysk po crashu (brak znacznika "clean" przy istniejących plikach)
+    static bool hasRecoverableData(const std::string& directory);
+    static bool recover(const std::string& directory, std::vector<SceneObject>& out);
+
+    size_t getJournalBytes() const { return journalBytes; }
+    int getOpsSinceSnapshot() const { return opsSinceSnapshot; }
+
+private:
+    // Replika sceny - tylko wątek dziennika. Klucz = kolejność dodania (zachowuje porządek obiektów).
+    struct Replica {
+        std::map<uint64_t, SceneObject> objects;
+        std::unordered_map<int, uint64_t> order;
+        uint64_t nextOrder = 0;
+        bool apply(const uint8_t* data, size_t size);
+    };
+
+    void push(std::vector<uint8_t>&& record);
+    void threadMain();
+    void openJournal();
+    void writeBatch(std::vector<std::vector<uint8_t>>& batch);
+    void compact();
+
+    static bool loadSnapshot(const std::string& path, Replica& replica);
+    static void replayJournal(const std::string& path, Replica& replica);
+
+    std::string directory;
+    std::thread worker;
+    std::atomic<bool> running{false};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::vector<uint8_t>> queue;
+    bool stopping = false;
+    bool snapshotRequested = false;
+
+    // Stan wątku dziennika
+    Replica replica;
+    FILE* journalFile = nullptr;
+    std::atomic<size_t> journalBytes{0};
+    std::atomic<int> opsSinceSnapshot{0};
+};
@@ -0,0 +1,214 @@
+#include "SceneLoader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+using json = nlohmann::json;
+
+SceneLoader::~SceneLoader() {
+    cancelRequested = true;
+    join();
+}
+
+void SceneLoader::join() {
+    jobs.wait(loadCounter);
+}
+
+void SceneLoader::begin(const std::string& scenePath) {
+    reset(scenePath);
+    hasPreparsed = false;
+    jobs.run([this]() { run(); }, &loadCounter);
+}
+
+void SceneLoader::begin(std::vector<SceneObject> objects, const std::string& label) {
+    reset(label);
+    hasPreparsed = true;
+    pendingObjects = std::move(objects);
+    jobs.run([this]() { run(); }, &loadCounter);
+}
+
+void SceneLoader::reset(const std::string& label) {
+    cancelRequested = true;
+    join();
+    if (stage == LoadStage::Uploading) releaseUploaded();
+
+    path = label;
+    pendingObjects.clear();
+    assets.clear();
+    assetIndex.clear();
+    uploadCursor = 0;
+    decodedCount = 0;
+    totalAssets = 0;
+    { std::lock_guard<std::mutex> lock(errorMutex); error.clear(); }
+    cancelRequested = false;
+    stage = LoadStage::Parsing;
+}
+
+void SceneLoader::cancel() {
+    if (isBusy()) cancelRequested = true;
+}
+
+void SceneLoader::fail(const std::string& message) {
+    { std::lock_guard<std::mutex> lock(errorMutex); error = message; }
+    stage = LoadStage::Failed;
+}
+
+std::string SceneLoader::getError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return error;
+}
+
+// --- WĄTEK W TLE: Parse -> Resolve -> Decode ---
+void SceneLoader::run() {
+    // 1. PARSE
+    std::vector<SceneObject> objects;
+    if (hasPreparsed) objects.swap(pendingObjects);
+    else {
+        json j;
+        {
+            std::ifstream f(path);
+            if (!f.is_open()) { fail("Cannot open " + path); return; }
+            try { f >> j; } catch (...) { fail("Invalid scene file"); return; }
+        }
+        if (!j.contains("objects")) { fail("Scene has no objects"); return; }
+        try {
+            for (const auto& el : j["objects"]) {
+                if (cancelRequested) { stage = LoadStage::Cancelled; return; }
+                objects.push_back(parseSceneObject(el));
+            }
+        } catch (...) { fail("Corrupted object entry"); return; }
+    }
+
+    // 2. RESOLVE - każdy plik dekodujemy tylko raz, nawet jeśli używa go wiele obiektów
+    stage = LoadStage::Resolving;
+    auto addAsset = [&](const std::string& p, bool isModel) -> PendingAsset* {
+        if (p.empty()) return nullptr;
+        std::string key = (isModel ? "m:" : "t:") + p;
+        auto inserted = assetIndex.emplace(key, assets.size());
+        if (!inserted.second) return &assets[inserted.first->second];
+        PendingAsset a; a.path = p; a.isModel = isModel;
+        assets.push_back(std::move(a));
+        return &assets.back();
+    };
+    for (const auto& o : objects) {
+        if (o.type == MeshType::Model)
+            if (PendingAsset* a = addAsset(o.modelPath, true)) a->needsHull |= o.hasCollider;
+        addAsset(o.texturePath, false);
+        addAsset(o.material.specularMapPath, false);
+    }
+    totalAssets = (int)assets.size();
+
+    // 3. DECODE - równolegle, po jednym zasobie na zadanie (wolne workery podkradają resztę)
+    stage = LoadStage::Decoding;
+    jobs.parallelFor(assets.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end && !cancelRequested; ++i) {
+            PendingAsset& a = assets[i];
+            a.decoded = a.isModel ? PrimitiveRenderer::decodeModel(a.path, a.vertices) : PrimitiveRenderer::decodeImage(a.path, a.image);
+            if (a.decoded && a.needsHull) a.hull = PrimitiveRenderer::buildHull(a.vertices);
+            if (a.decoded && a.isModel) a.bvh = PrimitiveRenderer::buildBvh(a.vertices);
+            decodedCount++;
+        }
+    });
+
+    if (cancelRequested) { stage = LoadStage::Cancelled; return; }
+    pendingObjects = std::move(objects);
+    stage = LoadStage::Uploading;
+}
+
+// --- WĄTEK GL: upload w ramach budżetu, potem podpięcie zasobów pod obiekty ---
+LoadStage SceneLoader::pump(PrimitiveRenderer& renderer, float budgetMs) {
+    LoadStage s = stage;
+    if (s == LoadStage::Failed || s == LoadStage::Cancelled) {
+        join();
+        stage = LoadStage::Idle;
+        return s;
+    }
+    if (s != LoadStage::Uploading) return s;
+
+    if (cancelRequested) {
+        join();
+        releaseUploaded();
+        stage = LoadStage::Idle;
+        return LoadStage::Cancelled;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    while (uploadCursor < assets.size()) {
+        PendingAsset& a = assets[uploadCursor];
+        if (a.isModel) {
+            if (a.decoded && !a.vertices.empty()) { a.glId = renderer.uploadMesh(a.vertices, &a.vbo); a.vertexCount = (int)(a.vertices.size() / 8); }
+            if (a.hull) a.hull = renderer.cacheHull(a.path, a.hull);
+            if (a.bvh) a.bvh = renderer.cacheBvh(a.path, a.bvh);
+            std::vector<float>().swap(a.vertices);
+        } else {
+            a.glId = renderer.uploadTexture(a.image);
+            std::vector<unsigned char>().swap(a.image.pixels);
+        }
+        ++uploadCursor;
+        float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsedMs >= budgetMs && uploadCursor < assets.size()) return LoadStage::Uploading;
+    }
+
+    join();
+    auto find = [&](const std::string& p, bool isModel) -> const PendingAsset* {
+        if (p.empty()) return nullptr;
+        auto it = assetIndex.find((isModel ? "m:" : "t:") + p);
+        return it != assetIndex.end() ? &assets[it->second] : nullptr;
+    };
+    for (auto& o : pendingObjects) {
+        if (o.type == MeshType::Model) if (const PendingAsset* a = find(o.modelPath, true)) { o.vao = a->glId; o.vertexCount = a->vertexCount; o.hull = a->hull; o.bvh = a->bvh; }
+        if (const PendingAsset* a = find(o.texturePath, false)) o.textureId = a->glId;
+        if (const PendingAsset* a = find(o.material.specularMapPath, false)) o.material.specularMapId = a->glId;
+    }
+    stage = LoadStage::Done;
+    return LoadStage::Done;
+}
+
+std::vector<SceneObject> SceneLoader::takeScene() {
+    std::vector<SceneObject> result;
+    if (stage != LoadStage::Done) return result;
+    result.swap(pendingObjects);
+    assets.clear();
+    assetIndex.clear();
+    stage = LoadStage::Idle;
+    return result;
+}
+
+void SceneLoader::releaseUploaded() {
+    for (size_t i = 0; i < uploadCursor && i < assets.size(); ++i) {
+        if (!assets[i].glId) continue;
+        if (assets[i].isModel) { glDeleteVertexArrays(1, &assets[i].glId); glDeleteBuffers(1, &assets[i].vbo); }
+        else glDeleteTextures(1, &assets[i].glId);
+    }
+    uploadCursor = 0;
+}
+
+bool SceneLoader::isBusy() const {
+    LoadStage s = stage;
+    return s == LoadStage::Parsing || s == LoadStage::Resolving || s == LoadStage::Decoding || s == LoadStage::Uploading;
+}
+
+float SceneLoader::getProgress() const {
+    float total = (float)std::max(1, totalAssets.load());
+    switch (stage.load()) {
+        case LoadStage::Parsing:   return 0.05f;
+        case LoadStage::Resolving: return 0.1f;
+        case LoadStage::Decoding:  return 0.1f + 0.6f * decodedCount / total;
+        case LoadStage::Uploading: return 0.7f + 0.3f * uploadCursor / total;
+        case LoadStage::Done:      return 1.0f;
+        default:                   return 0.0f;
+    }
+}
+
+const char* SceneLoader::getStageName() const {
+    switch (stage.load()) {
+        case LoadStage::Parsing:   return "Parsing scene...";
+        case LoadStage::Resolving: return "Resolving assets...";
+        case LoadStage::Decoding:  return "Decoding assets...";
+        case LoadStage::Uploading: return "Uploading to GPU...";
+        case LoadStage::Done:      return "Done";
+        case LoadStage::Failed:    return "Failed";
+        case LoadStage::Cancelled: return "Cancelled";
+        default:                   return "Idle";
+    }
+}
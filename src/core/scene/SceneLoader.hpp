@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../json.hpp"
+#include "../sceneobject/SceneSerializer.hpp"
+#include "../renderer/Renderer.hpp"
+#include "../jobs/JobSystem.hpp"
+
+// Etapy wczytywania sceny w tle
+enum class LoadStage { Idle, Parsing, Resolving, Decoding, Uploading, Done, Failed, Cancelled };
+
+// --- ASYNCHRONICZNE WCZYTYWANIE SCENY ---
+// Parse -> Resolve (unikalne zasoby) -> Decode (równolegle, na workerach JobSystem; także otoczki colliderów)
+// -> Upload (wątek GL, z budżetem na klatkę).
+// Gotowa scena jest podmieniana w całości dopiero po zakończeniu uploadu.
+class SceneLoader {
+public:
+    explicit SceneLoader(JobSystem& jobs) : jobs(jobs) {}
+    ~SceneLoader();
+
+    // Startuje wczytywanie (przerywa poprzednie, jeśli trwa)
+    void begin(const std::string& path);
+    // Jak wyżej, ale dla gotowych obiektów (np. odzyskanych z autosave) - pomija etap Parse
+    void begin(std::vector<SceneObject> objects, const std::string& label);
+    void cancel();
+
+    // Wywoływane co klatkę z wątku GL. Zwraca Done, gdy scena jest gotowa do podmiany,
+    // a Failed/Cancelled jednorazowo, gdy wczytywanie się zakończyło bez wyniku.
+    LoadStage pump(PrimitiveRenderer& renderer, float budgetMs);
+    std::vector<SceneObject> takeScene();
+
+    bool isBusy() const;
+    float getProgress() const;
+    const char* getStageName() const;
+    LoadStage getStage() const { return stage.load(); }
+    const std::string& getPath() const { return path; }
+    std::string getError() const;
+
+private:
+    struct PendingAsset {
+        std::string path;
+        bool isModel = false;
+        bool needsHull = false; // model używany przez obiekt z colliderem
+        bool decoded = false;
+        std::vector<float> vertices;
+        std::shared_ptr<const ConvexHull> hull;
+        std::shared_ptr<const MeshBvh> bvh; // picking - dla każdego modelu
+        ImageData image;
+        unsigned int glId = 0;
+        unsigned int vbo = 0;   // model: bufor wierzchołków pod glId (VAO)
+        int vertexCount = 0;
+    };
+
+    void reset(const std::string& label);
+    void run();
+    void join();
+    void releaseUploaded();
+    void fail(const std::string& message);
+
+    JobSystem& jobs;
+    JobCounter loadCounter;
+    std::atomic<LoadStage> stage{LoadStage::Idle};
+    std::atomic<bool> cancelRequested{false};
+    std::atomic<int> decodedCount{0};
+    std::atomic<int> totalAssets{0};
+
+    std::string path;
+    bool hasPreparsed = false;
+    std::vector<SceneObject> pendingObjects;
+    std::vector<PendingAsset> assets;
+    std::unordered_map<std::string, size_t> assetIndex;
+    size_t uploadCursor = 0;
+
+    mutable std::mutex errorMutex;
+    std::string error;
+};
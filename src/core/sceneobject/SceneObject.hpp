@@ -1,10 +1,35 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
 #include "../math/Vec3.hpp"
 #include "../math/Mat4.hpp"
 #include "../math/MatrixTransform.hpp"
 
-enum class MeshType { Cube, Triangle, Model, Pyramid };
+enum class MeshType { Cube, Triangle, Model, Pyramid, Sphere, Cylinder };
+
+struct ConvexHull;
+struct MeshBvh;
+
+// Role obiektu (bitmaska) - zachowanie zależy od flag, nie od nazwy
+enum TagFlags : uint32_t {
+    Tag_None     = 0,
+    Tag_Player   = 1u << 0, // sterowany przez gracza
+    Tag_NoShadow = 1u << 1, // nie rzuca cienia (np. ikona Słońca)
+};
+
+enum class LightType { None, Directional, Point, Spot };
+
+struct Light {
+    LightType type = LightType::None;
+    Vec3 color;
+    float intensity = 1.0f;
+    float range = 10.0f;
+    float spotAngle = 0.5236f; // połowa kąta stożka (rad), Spot świeci wzdłuż lokalnego -Y
+    bool castShadows = true;      // Point / Spot: kafle w atlasie cieni
+    float shadowPriority = 1.0f;  // mnożnik rozdzielczości kafla (razem z pokryciem ekranu)
+    Light() : color(1,1,1) {}
+};
 
 struct Transform {
     Vec3 position, rotation, scale;
@@ -34,10 +59,12 @@ struct SceneObject {
 
     // FIZYKA & ROZGRYWKA
     bool hasCollider = true;
+    bool isTrigger = false; // collider jako strefa (PhysicsWorld::getTriggerEvents)
     bool useGravity = false;
     bool canShoot = false; // <--- NOWOŚĆ: Czy może strzelać?
 
     bool lockX = false, lockY = false, lockZ = false;
+    bool continuous = false; // ciągła detekcja kolizji (szybkie pociski)
     Vec3 velocity;
 
     unsigned int textureId = 0;
@@ -46,6 +73,12 @@ struct SceneObject {
     unsigned int vao = 0;
     int vertexCount = 0;
     std::string modelPath;
+    std::shared_ptr<const ConvexHull> hull; // otoczka z loadModel (jak vao - nie jest zapisywana)
+    std::shared_ptr<const MeshBvh> bvh;     // BVH trójkątów do pickingu (jak hull)
+
+    uint32_t tags = Tag_None;
+    Light light;
+    int parent = -1; // id rodzica (-1 = korzeń); transform jest względem rodzica
 
     SceneObject() : id(0), name("Object"), type(MeshType::Cube), velocity(0,0,0) {}
 };
\ No newline at end of file
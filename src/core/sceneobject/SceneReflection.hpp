@@ -0,0 +1,62 @@
+#pragma once
+#include "SceneObject.hpp"
+#include "../reflection/Reflection.hpp"
+
+// --- OPISY PÓL (jedno źródło prawdy dla JSON, binarki, Undo i Inspektora) ---
+// Klucze JSON zgodne ze starym formatem .ducky.
+
+template<> struct Reflect<Transform> {
+    static constexpr auto fields = std::make_tuple(
+        field("pos",   "Pos",   &Transform::position, Field_None,    nullptr, 0.1f),
+        field("rot",   "Rot",   &Transform::rotation, Field_Degrees, nullptr, 0.5f),
+        field("scale", "Scale", &Transform::scale,    Field_None,    nullptr, 0.05f)
+    );
+};
+
+template<> struct Reflect<Material> {
+    static constexpr auto fields = std::make_tuple(
+        field("shininess",        "Shininess",     &Material::shininess,        Field_Slider, nullptr, 1.0f, 1.0f, 256.0f),
+        field("specularStrength", "Spec Strength", &Material::specularStrength, Field_Slider, nullptr, 0.01f, 0.0f, 2.0f),
+        field("specularMapPath",  "Specular Map",  &Material::specularMapPath,  Field_Hidden),
+        field("specularMapId",    "Specular Id",   &Material::specularMapId,    Field_Runtime | Field_Hidden)
+    );
+};
+
+template<> struct Reflect<Light> {
+    static constexpr auto fields = std::make_tuple(
+        field("type",      "Type",      &Light::type,      Field_Hidden),
+        field("color",     "Color",     &Light::color,     Field_None,   nullptr, 0.01f),
+        field("intensity", "Intensity", &Light::intensity, Field_Slider, nullptr, 0.05f, 0.0f, 10.0f),
+        field("range",     "Range",     &Light::range,     Field_None,   nullptr, 0.1f),
+        field("spotAngle", "Spot Angle",&Light::spotAngle, Field_Slider, nullptr, 0.01f, 0.05f, 1.5f),
+        field("castShadows",    "Shadows",         &Light::castShadows),
+        field("shadowPriority", "Shadow Priority", &Light::shadowPriority, Field_Slider, nullptr, 0.05f, 0.0f, 4.0f)
+    );
+};
+
+template<> struct Reflect<SceneObject> {
+    static constexpr auto fields = std::make_tuple(
+        field("id",          "ID",        &SceneObject::id,          Field_Hidden),
+        field("name",        "Name",      &SceneObject::name),
+        field("type",        "Type",      &SceneObject::type,        Field_Hidden),
+        field("transform",   "Transform", &SceneObject::transform),
+        field("hasCollider", "Collider",  &SceneObject::hasCollider, Field_None, "Physics"),
+        field("isTrigger",   "Trigger",   &SceneObject::isTrigger,   Field_None, "Physics"),
+        field("useGravity",  "Gravity",   &SceneObject::useGravity,  Field_None, "Physics"),
+        field("canShoot",    "Shoot",     &SceneObject::canShoot,    Field_None, "Physics"),
+        field("lockX",       "Lock X",    &SceneObject::lockX,       Field_None, "Physics"),
+        field("lockY",       "Lock Y",    &SceneObject::lockY,       Field_None, "Physics"),
+        field("lockZ",       "Lock Z",    &SceneObject::lockZ,       Field_None, "Physics"),
+        field("continuous",  "CCD",       &SceneObject::continuous,  Field_None, "Physics"),
+        field("velocity",    "Velocity",  &SceneObject::velocity,    Field_None, "Physics"),
+        field("texturePath", "Texture",   &SceneObject::texturePath, Field_Hidden),
+        field("modelPath",   "Model",     &SceneObject::modelPath,   Field_Hidden),
+        field("material",    "Material",  &SceneObject::material),
+        field("textureId",   "Texture Id",&SceneObject::textureId,   Field_Runtime | Field_Hidden),
+        field("vao",         "VAO",       &SceneObject::vao,         Field_Runtime | Field_Hidden),
+        field("vertexCount", "Vertices",  &SceneObject::vertexCount, Field_Runtime | Field_Hidden),
+        field("tags",        "Tags",      &SceneObject::tags,        Field_Hidden),
+        field("light",       "Light",     &SceneObject::light,       Field_Hidden),
+        field("parent",      "Parent",    &SceneObject::parent,      Field_Hidden)
+    );
+};
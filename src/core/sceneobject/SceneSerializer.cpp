@@ -0,0 +1,76 @@
+#include "SceneSerializer.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+using json = nlohmann::json;
+
+json serializeSceneObject(const SceneObject& o) {
+    json j;
+    writeJson(o, j);
+    return j;
+}
+
+// Pliki sprzed ról: zachowanie wynikało z nazwy obiektu - przepisujemy je raz, przy wczytaniu
+static void applyLegacyRoles(SceneObject& o) {
+    if (o.name == "Player") o.tags |= Tag_Player;
+    if (o.name == "Sun") { o.tags |= Tag_NoShadow; o.light.type = LightType::Directional; }
+    else if (o.name == "PointLight") o.light.type = LightType::Point;
+    else if (o.name == "SpotLight") o.light.type = LightType::Spot;
+    if (o.type == MeshType::Model && o.modelPath.empty()) {
+        if (o.name.find("Sphere") != std::string::npos) o.type = MeshType::Sphere;
+        else if (o.name.find("Cylinder") != std::string::npos) o.type = MeshType::Cylinder;
+    }
+}
+
+SceneObject parseSceneObject(const json& e) {
+    SceneObject o;
+    readJson(e, o);
+    // Stary format zapisywał blokady osi jako tablicę
+    if (e.contains("locks") && e["locks"].is_array() && e["locks"].size() >= 3) { o.lockX = e["locks"][0]; o.lockY = e["locks"][1]; o.lockZ = e["locks"][2]; }
+    if (!e.contains("tags")) applyLegacyRoles(o);
+    return o;
+}
+
+SceneDelta computeSceneDelta(const std::vector<SceneObject>& before, const std::vector<SceneObject>& after) {
+    SceneDelta delta;
+    std::unordered_map<int, size_t> afterIndex;
+    for (size_t i = 0; i < after.size(); ++i) afterIndex[after[i].id] = i;
+
+    std::unordered_set<int> beforeIds;
+    for (size_t i = 0; i < before.size(); ++i) {
+        beforeIds.insert(before[i].id);
+        auto it = afterIndex.find(before[i].id);
+        if (it == afterIndex.end()) { delta.removed.emplace_back(i, before[i]); continue; }
+        std::vector<FieldPatch> patches = diffFields(before[i], after[it->second]);
+        if (!patches.empty()) delta.modified.push_back({before[i].id, std::move(patches)});
+    }
+    for (const auto& o : after) if (!beforeIds.count(o.id)) delta.added.push_back(o);
+    return delta;
+}
+
+static void removeByIds(std::vector<SceneObject>& objects, const std::unordered_set<int>& ids) {
+    if (ids.empty()) return;
+    objects.erase(std::remove_if(objects.begin(), objects.end(), [&](const SceneObject& o) { return ids.count(o.id) > 0; }), objects.end());
+}
+
+void applySceneDelta(std::vector<SceneObject>& objects, const SceneDelta& delta, bool forward) {
+    std::unordered_set<int> toRemove;
+    if (forward) for (const auto& r : delta.removed) toRemove.insert(r.second.id);
+    else for (const auto& a : delta.added) toRemove.insert(a.id);
+    removeByIds(objects, toRemove);
+
+    std::unordered_map<int, size_t> index;
+    for (size_t i = 0; i < objects.size(); ++i) index[objects[i].id] = i;
+    for (const auto& m : delta.modified) {
+        auto it = index.find(m.id);
+        if (it == index.end()) continue;
+        for (const auto& p : m.patches) applyPatch(objects[it->second], p, forward);
+    }
+
+    if (forward) {
+        for (const auto& a : delta.added) objects.push_back(a);
+    } else {
+        for (const auto& r : delta.removed) objects.insert(objects.begin() + std::min(r.first, objects.size()), r.second);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <utility>
+#include <vector>
+#include "SceneObject.hpp"
+#include "SceneReflection.hpp"
+#include "../reflection/Serializers.hpp"
+#include "../json.hpp"
+
+// --- SERIALIZACJA OBIEKTÓW SCENY (generowana z SceneReflection.hpp) ---
+nlohmann::json serializeSceneObject(const SceneObject& o);
+// Odczyt pól z JSON-a (bez ładowania zasobów - bezpieczne poza wątkiem GL)
+SceneObject parseSceneObject(const nlohmann::json& e);
+
+// --- DIFF SCENY DLA UNDO/REDO ---
+struct ObjectDelta {
+    int id;
+    std::vector<FieldPatch> patches;
+};
+
+struct SceneDelta {
+    std::vector<ObjectDelta> modified;
+    std::vector<std::pair<size_t, SceneObject>> removed; // (pozycja w wektorze, obiekt)
+    std::vector<SceneObject> added;
+
+    bool empty() const { return modified.empty() && removed.empty() && added.empty(); }
+};
+
+SceneDelta computeSceneDelta(const std::vector<SceneObject>& before, const std::vector<SceneObject>& after);
+// forward = true: before -> after (Redo), false: after -> before (Undo)
+void applySceneDelta(std::vector<SceneObject>& objects, const SceneDelta& delta, bool forward);